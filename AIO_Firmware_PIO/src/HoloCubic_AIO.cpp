@@ -10,11 +10,18 @@
   Last review/edit by ClimbSnail: 2023/01/14
  ****************************************************/
 
+#define LOG_TAG "main"
 #include "driver/lv_port_indev.h"
 #include "driver/lv_port_fs.h"
 
 #include "common.h"
 #include "sys/app_controller.h"
+#include "sys/serial_cmd.h"
+#include "sys/boot_trace.h"
+#include "sys/logger.h"
+#include "sys/loop_wake.h"
+#include "sys/buf_pool.h"
+#include "sys/heap_monitor.h"
 
 #include "app/app_conf.h"
 
@@ -22,8 +29,6 @@
 #include <esp32-hal.h>
 #include <esp32-hal-timer.h>
 
-bool isCheckAction = false;
-
 /*** Component objects **7*/
 ImuAction *act_info;           // 存放mpu6050返回的数据
 AppController *app_controller; // APP控制器
@@ -40,17 +45,120 @@ void TaskLvglUpdate(void *parameter)
     }
 }
 
-TimerHandle_t xTimerAction = NULL;
-void actionCheckHandle(TimerHandle_t xTimer)
+#if METRICS_ENABLE
+static void cmd_stats(const char *args)
+{
+    metrics_print(&Serial);
+}
+#endif
+
+static void cmd_apps(const char *args)
+{
+    app_controller->print_app_stats(&Serial);
+}
+
+static void cmd_boot(const char *args)
+{
+    boot_trace_print(&Serial);
+}
+
+static void cmd_cpu(const char *args)
+{
+    cpu_governor_print(&Serial);
+}
+
+static void cmd_buf(const char *args)
+{
+    buf_pool_print(&Serial);
+}
+
+static void cmd_heap(const char *args)
+{
+    heap_monitor_print(&Serial);
+}
+
+static void cmd_i2c(const char *args)
+{
+    g_i2cBus.printStats(&Serial);
+}
+
+// 串口输出IMU原始样本（用于离线回放调试阈值） 不保存
+static void cmd_imu_trace(const char *args)
+{
+    bool enable = strcmp(args, "off") && strcmp(args, "0");
+    mpu.setTrace(enable);
+    Serial.printf("imu trace %s\n", enable ? "on" : "off");
+}
+
+static void cmd_lvfs(const char *args)
+{
+    lv_fs_fatfs_stats_t stats;
+    lv_fs_fatfs_get_stats(&stats);
+    Serial.printf("LVGL fs (SD card): open %u, read %u calls %u bytes, seek %u\n",
+                  stats.open_calls, stats.read_calls, stats.read_bytes, stats.seek_calls);
+    if (!strcmp(args, "reset"))
+    {
+        lv_fs_fatfs_reset_stats();
+    }
+}
+
+// 与屏幕初始化、首帧显示并行的启动阶段（在核0上执行）
+#define BOOT_SD_DONE BIT0  // SD卡挂载完成
+#define BOOT_IMU_DONE BIT1 // 光线传感器与IMU初始化完成
+
+static EventGroupHandle_t boot_events = NULL;
+
+static void boot_sd(void)
+{
+    // SD卡使用HSPI 与屏幕的SPI总线互不影响
+    tf.init();
+    boot_trace_mark("sd_mount");
+    xEventGroupSetBits(boot_events, BOOT_SD_DONE);
+}
+
+static void boot_imu(void)
+{
+    /*** Init I2C bus (shared by MPU6050 and ambient-light sensor) ***/
+    g_i2cBus.begin(IMU_I2C_SDA, IMU_I2C_SCL);
+
+    /*** Init ambient-light sensor ***/
+    ambLight.init(ONE_TIME_H_RESOLUTION_MODE);
+    boot_trace_mark("ambient");
+
+    // 连接不上MPU6050时最长会等待5秒 放在这里不再拖慢首帧
+    mpu.init(app_controller->sys_cfg.mpu_order,
+             app_controller->sys_cfg.auto_calibration_mpu,
+             &app_controller->mpu_cfg); // 校准在后台进行 不再阻塞启动
+    mpu.setGestureConfig(&app_controller->gesture_cfg);
+    boot_trace_mark("imu");
+    xEventGroupSetBits(boot_events, BOOT_IMU_DONE);
+}
+
+static void TaskBootStage(void *parameter)
+{
+    ((void (*)(void))parameter)();
+    vTaskDelete(NULL);
+}
+
+static void boot_start_stage(void (*stage)(void), const char *name)
+{
+    BaseType_t ret = xTaskCreatePinnedToCore(TaskBootStage, name, 4 * 1024,
+                                             (void *)stage, 1, NULL, 0);
+    if (pdPASS != ret)
+    {
+        // 创建失败时直接在当前任务中执行
+        stage();
+    }
+}
+
+static void boot_wait(EventBits_t bits)
 {
-    // 标志需要检测动作
-    isCheckAction = true;
+    xEventGroupWaitBits(boot_events, bits, pdFALSE, pdTRUE, portMAX_DELAY);
 }
 
 void my_print(const char *buf)
 {
-    Serial.printf("%s", buf);
-    Serial.flush();
+    LOGI("%s", buf);
 }
 
 // NTP服务器配置
@@ -82,42 +190,7 @@ bool initTime() {
 }
 
 
-void checkAndUpdateBrightness() {
-    RgbConfig *rgb_cfg = &app_controller->rgb_cfg;
-    screen.night_mode = is_night_mode_time(
-        rgb_cfg->brightness_night_mode_start,
-        rgb_cfg->brightness_night_mode_end
-    );
-    uint8_t screen_brightness = screen.getBrightness();
-    if(screen.night_mode) {
-        // 夜间模式时间段内，发现当前屏幕亮度不是指定亮度，则修改当前屏幕亮度为指定亮度
-        if(screen_brightness != rgb_cfg->brightness_night_mode_specified) {
-            screen.setBackLight(rgb_cfg->brightness_night_mode_specified / 100.0);
-            Serial.print("更新夜间亮度到: ");
-            Serial.println(screen_brightness); 
-        }
-    } else {
-        // 非夜间模式时间段内，恢复日间亮度
-        if(screen_brightness != app_controller->sys_cfg.backLight) {
-            screen.setBackLight(app_controller->sys_cfg.backLight / 100.0);
-            Serial.print("设置日间亮度到: ");
-            Serial.println(screen_brightness);
-        }
-    }
-}
-// 任务1：专门处理亮度检查
-void TaskBrightnessCheck(void *parameter)
-{
-    const TickType_t xDelay = 5000 / portTICK_PERIOD_MS;
-    
-    for (;;)
-    {
-        checkAndUpdateBrightness();
-        vTaskDelay(xDelay);
-    }
-}
-
-// 任务2：专门处理时间同步
+// 专门处理时间同步的任务
 void TaskTimeSync(void *parameter)
 {
     const TickType_t xDelay = 60000 / portTICK_PERIOD_MS;  // 每分钟检查一次是否需要同步
@@ -158,6 +231,12 @@ void TaskTimeSync(void *parameter)
 void setup()
 {
     Serial.begin(115200);
+    loop_wake_init();
+    logger_init();
+    // 趁堆中还没有碎片 预留APP共用的大块缓冲区
+    buf_pool_init();
+    heap_monitor_init();
+    boot_trace_mark("serial");
 
     Serial.println(F("\nAIO (All in one) version " AIO_VERSION "\n"));
     Serial.flush();
@@ -181,6 +260,9 @@ void setup()
         Serial.println("SPIFFS Mount Failed");
         return;
     }
+    // 一次性加载全部配置
+    g_cfgStore.begin();
+    boot_trace_mark("spiffs");
 
 #ifdef PEAK
     pinMode(CONFIG_BAT_CHG_DET_PIN, INPUT);
@@ -198,21 +280,25 @@ void setup()
     app_controller->read_config(&app_controller->sys_cfg);
     app_controller->read_config(&app_controller->mpu_cfg);
     app_controller->read_config(&app_controller->rgb_cfg);
+    app_controller->read_config(&app_controller->gesture_cfg);
+    app_controller->read_config(&app_controller->backlight_cfg);
+    boot_trace_mark("config");
+
+    // SD卡与I2C设备互不依赖 在核0上与屏幕初始化同时进行
+    boot_events = xEventGroupCreate();
+    boot_start_stage(boot_sd, "BootSd");
+    boot_start_stage(boot_imu, "BootImu");
 
     /*** Init screen ***/
     screen.init(app_controller->sys_cfg.rotation,
                 app_controller->sys_cfg.backLight);
+    boot_trace_mark("screen");
 
     /*** Init on-board RGB ***/
     rgb.init();
-    rgb.setBrightness(0.05).setRGB(0, 64, 64);
-
-    /*** Init ambient-light sensor ***/
-    ambLight.init(ONE_TIME_H_RESOLUTION_MODE);
-
-    /*** Init micro SD-Card ***/
-    tf.init();
+    rgb.setColor(CRGB(0, 128, 128), 13); // 经过gamma校正后与旧版的(0, 64, 64)、5%亮度相近
 
+    // 只注册LVGL的文件系统驱动 不访问SD卡 需在lv_init之后
     lv_fs_fatfs_init();
 
     // Update display in parallel thread.
@@ -301,18 +387,26 @@ void setup()
 #if APP_LHLXW_USE
     app_controller->app_install(&LHLXW_app);
 #endif
+    boot_trace_mark("app_install");
+
+    // 自启动的APP可能在初始化时读取SD卡
+    boot_wait(BOOT_SD_DONE);
     // 自启动APP
     app_controller->app_auto_start();
 
     // 优先显示屏幕 加快视觉上的开机时间
-    app_controller->main_process(&mpu.action_info);
+    // 此时IMU可能还在核0上初始化 mpu.action_info会被并发写入 首帧只传入空动作
+    ImuAction boot_action = {};
+    boot_action.active = UNKNOWN;
+    boot_action.isValid = false;
+    app_controller->main_process(&boot_action);
+    boot_trace_mark("first_frame");
 
     /*** Init IMU as input device ***/
     // lv_port_indev_init();
 
-    mpu.init(app_controller->sys_cfg.mpu_order,
-             app_controller->sys_cfg.auto_calibration_mpu,
-             &app_controller->mpu_cfg); // 初始化比较耗时
+    // 之后的背光控制用到光线传感器 动作数据用到IMU
+    boot_wait(BOOT_IMU_DONE);
 
     /*** 以此作为MPU6050初始化完成的标志 ***/
     RgbConfig *rgb_cfg = &app_controller->rgb_cfg;
@@ -327,37 +421,47 @@ void setup()
                             rgb_cfg->brightness_night_mode_start,
                             rgb_cfg->brightness_night_mode_end};
     // 运行RGB任务
-    set_rgb_and_run(&rgb_setting, RUN_MODE_TASK);
+    rgb_effect_register(RGB_EFFECT_SYSTEM, &rgb_setting);
+    rgb_effect_run(RGB_EFFECT_SYSTEM, RUN_MODE_TASK);
 
-    // 先初始化一次动作数据 防空指针
+    // 先初始化一次动作数据 防空指针（之后的采样与识别在IMU的采样任务中进行）
     act_info = mpu.getAction();
-    // 定义一个mpu6050的动作检测定时器
-    xTimerAction = xTimerCreate("Action Check",
-                                200 / portTICK_PERIOD_MS,
-                                pdTRUE, (void *)0, actionCheckHandle);
-    xTimerStart(xTimerAction, 0);
 
-    
-    // 创建亮度检查任务
-    xTaskCreate(
-        TaskBrightnessCheck,
-        "BrightnessCheck",
-        2048,
-        NULL,
-        1,
-        NULL
-    );
+    // 背光控制（合并用户亮度、夜间模式与环境光 只在变化时改写PWM）
+    g_backlight.setUserLevel(app_controller->sys_cfg.backLight);
+    g_backlight.setNightMode(rgb_cfg->brightness_night_mode_specified,
+                             rgb_cfg->brightness_night_mode_start,
+                             rgb_cfg->brightness_night_mode_end);
+    g_backlight.setConfig(&app_controller->backlight_cfg);
+    g_backlight.begin();
     
     // 创建时间同步任务
+    TaskHandle_t handleTimeSync = NULL;
     xTaskCreate(
         TaskTimeSync,
         "TimeSync",
         4096,  // 可能需要更多栈空间用于网络操作
         NULL,
-        2,     // 优先级可以比亮度检查高一点
-        NULL
+        2,     // 优先级可以比背光控制高一点
+        &handleTimeSync
     );
-    
+
+    METRIC_WATCH_TASK("loopTask", xTaskGetCurrentTaskHandle());
+    METRIC_WATCH_TASK("TimeSync", handleTimeSync);
+#if METRICS_ENABLE
+    serial_cmd_register("stats", cmd_stats, "print runtime metrics");
+#endif
+    serial_cmd_register("apps", cmd_apps, "print per-app CPU time and heap usage");
+    serial_cmd_register("boot", cmd_boot, "print boot timeline");
+    serial_cmd_register("cpu", cmd_cpu, "print CPU frequency governor state");
+    serial_cmd_register("buf", cmd_buf, "print shared buffer pool leases");
+    serial_cmd_register("heap", cmd_heap, "print heap and stack history (kept across soft resets)");
+    serial_cmd_register("i2c", cmd_i2c, "print per-device I2C transfer stats");
+    serial_cmd_register("imu_trace", cmd_imu_trace, "stream raw IMU samples ('imu_trace off' to stop)");
+    serial_cmd_register("lvfs", cmd_lvfs, "print LVGL file reads from the SD card ('lvfs reset' to clear)");
+
+    boot_trace_done();
+    boot_trace_print(&Serial);
 }
 #define PERFORMANCE_DEBUG 1
 #ifdef PERFORMANCE_DEBUG
@@ -377,7 +481,7 @@ static void performance_monitor(void)
 
 void loop()
 {
-    screen.routine();
+    uint32_t lvgl_wait = screen.routine();
 
 #ifdef PERFORMANCE_DEBUG
     performance_monitor();
@@ -394,17 +498,23 @@ void loop()
         if (!mpu.Encoder_GetIsPush())
         {
             Serial.println("mpu.Encoder_GetIsPush()2");
+            g_cfgStore.flush(); // 关机前写入未保存的配置
             // 适配Peak的关机功能
             digitalWrite(CONFIG_POWER_EN_PIN, LOW);
         }
     }
 #endif
-    if (isCheckAction)
+    act_info = mpu.getAction(); // 取出已识别的动作
+    app_controller->main_process(act_info); // 运行当前进程
+    if (mpu.getNewOffsets(&app_controller->mpu_cfg))
     {
-        isCheckAction = false;
-        act_info = mpu.getAction();
+        // 后台重新校准了陀螺仪 保存新的校准值
+        app_controller->write_config(&app_controller->mpu_cfg);
     }
-    app_controller->main_process(act_info); // 运行当前进程
-    // Serial.println(ambLight.getLux() / 50.0);
-    // rgb.setBrightness(ambLight.getLux() / 500.0);
+    cpu_governor_routine(); // 延迟的降频
+    g_cfgStore.routine(); // 延迟写入配置
+    serial_cmd_poll();    // 串口命令（输入help查看）
+
+    // 休眠到下一个LVGL定时任务、APP要求的时间 或被动作、消息提前唤醒
+    loop_wake_wait(min(lvgl_wait, app_controller->get_wait_time()));
 }
\ No newline at end of file
@@ -29,7 +29,6 @@ SD卡存放说明(LH&LXW APP):
 
 
 /* 系统变量 */
-extern bool isCheckAction;
 extern ImuAction *act_info;
 
 /* APP变量 */
@@ -39,7 +38,7 @@ extern LHLXW_RUN *lhlxw_run;
 static int LHLXW_init(AppController *sys){
     lhlxw_run = (LHLXW_RUN*)malloc(sizeof(LHLXW_RUN));
     lhlxw_run->option_num = 0;//确保每次进入app，当先选项序号都为0
-    setCpuFrequencyMhz(240);
+    cpu_governor_request(APP_NAME, PERF_LEVEL_HIGH, false);
     LHLXW_GUI_Init();
     return 0;
 }
@@ -51,10 +50,7 @@ static void LHLXW_process(AppController *sys,const ImuAction *action){
         lv_timer_handler();
 
         /* MPU6050数据获取 */
-        if (isCheckAction){
-            isCheckAction = false;
-            act_info = mpu.getAction();
-        }
+        act_info = mpu.getAction();
 
         /* MPU6050动作响应 */
         if (RETURN == act_info->active){
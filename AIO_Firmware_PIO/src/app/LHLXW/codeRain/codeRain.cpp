@@ -11,7 +11,6 @@
 
 
 /* 系统变量 */
-extern bool isCheckAction;
 extern ImuAction *act_info;
 
 
@@ -32,10 +31,7 @@ void codeRain_process(lv_obj_t * ym){
     matrix_effect->loop();
 
     /* MPU6050数据获取 */
-    if (isCheckAction){
-        isCheckAction = false;
-        act_info = mpu.getAction();
-    }
+    act_info = mpu.getAction();
 
     /* MPU6050动作响应 */
     if (RETURN == act_info->active){
@@ -1,4 +1,5 @@
 #include "sys/app_controller.h"
+#include "sys/buf_pool.h"
 #include "lvgl.h"
 #include "stdlib.h"
 #include "math.h"
@@ -25,10 +26,10 @@ with open(out_path, 'wb') as f:
 
 
 /* 系统变量 */
-extern bool isCheckAction;
 extern ImuAction *act_info;
 
 #define cyber_play_time 2000//2000ms自动切换
+#define CYBER_BUF_OWNER "cyber"//屏幕缓冲区的租借者
 
 struct cyber_run {
     bool flg;//true:当前屏幕显示pic1,false:当前屏幕显示pic2
@@ -41,6 +42,7 @@ struct cyber_run {
     uint8_t con;//
     unsigned long timCon;
     uint8_t *testBuf;//屏幕单字节缓冲区
+    BufLease testLease;//testBuf从缓冲池中租借
     uint8_t *pic1;//定义两张图片缓冲区，这样可以实现切换
     uint8_t *pic2;  
     File file;
@@ -51,7 +53,7 @@ cyber_run *cy_r=NULL;
 void free_cy_r(void){
     free(cy_r->pic1);
     free(cy_r->pic2);
-    free(cy_r->testBuf);
+    buf_return(&cy_r->testLease, CYBER_BUF_OWNER);
     free(cy_r);
 }
 
@@ -148,7 +150,7 @@ void cyber_pros(lv_obj_t *ym){
         Serial.println("0:lack of memory");
         while(1);
     }  
-    cy_r->testBuf = (uint8_t *)malloc(240 * 240); //动态分配一块屏幕分辨率大小的空间
+    cy_r->testBuf = buf_lease(&cy_r->testLease, BUF_FRAME, CYBER_BUF_OWNER); //租借一块屏幕分辨率大小的空间
     if(cy_r->testBuf == NULL){
         Serial.println("1:lack of memory");
         while(1);
@@ -228,10 +230,7 @@ void cyber_pros(lv_obj_t *ym){
         act_info->active = ACTIVE_TYPE::UNKNOWN;
         act_info->isValid = 0;
         /* MPU6050数据获取 */
-        if (isCheckAction){
-            isCheckAction = false;
-            act_info = mpu.getAction();
-        }
+        act_info = mpu.getAction();
         /* MPU6050动作响应 */
         if (RETURN == act_info->active){
             break;
@@ -261,7 +260,7 @@ void cyber_pros(lv_obj_t *ym){
     lv_obj_del(obj);
 
     
-    free(cy_r->testBuf);//释放57600字节内存
+    buf_return(&cy_r->testLease, CYBER_BUF_OWNER);//归还57600字节缓冲区
     free(cy_r->pic2);//释放1920字节内存
     free(cy_r->pic1);//释放1920字节内存
     free(cy_r);
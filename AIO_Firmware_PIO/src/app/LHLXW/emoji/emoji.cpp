@@ -39,7 +39,6 @@ openCV一次性替换所有QQ超级表情背景颜色：
 */
 
 /* 系统变量 */
-extern bool isCheckAction;
 extern ImuAction *act_info;
 
 #define emoji_play_time 33333//一个表情播放(emoji_play_time)ms自动播放下一个，也可以手动切换
@@ -102,10 +101,7 @@ void emoji_process(lv_obj_t *ym)
             }
         }
         /* MPU6050数据获取 */
-        if (isCheckAction){
-            isCheckAction = false;
-            act_info = mpu.getAction();
-        }
+        act_info = mpu.getAction();
 
         /* MPU6050动作响应 */
         if (RETURN == act_info->active){
@@ -32,7 +32,6 @@
 */
 
 /* 系统变量 */
-extern bool isCheckAction;
 extern ImuAction *act_info;
 
 eye_run *e_run = NULL;
@@ -47,10 +46,9 @@ uint16_t *pbuffer_m = NULL; // 实际刷新到屏幕的缓存(屏幕一行的大
 bool eye_loop(void)
 {
     /* MPU6050数据获取 */
-    if (isCheckAction)
+    act_info = mpu.getAction();
+    if (act_info->isValid)
     {
-        isCheckAction = false;
-        act_info = mpu.getAction();
 
         /* MPU6050动作响应 */
         if (RETURN == act_info->active)
@@ -1,4 +1,5 @@
 #include "sys/app_controller.h"
+#include "sys/buf_pool.h"
 #include "lvgl.h"
 #include "stdlib.h"
 #include "math.h"
@@ -13,10 +14,12 @@
 
 
 /* 系统变量 */
-extern bool isCheckAction;
 extern ImuAction *act_info;
 
+#define HEARTBEAT_BUF_OWNER "heartbeat_"//屏幕缓冲区的租借者
+
 static uint8_t *heartbeatBuf = NULL;
+static BufLease heartbeatLease;//heartbeatBuf从缓冲池中租借
 static void heartbeatBuf_clear(uint16_t color){
     uint8_t i = 0;
     uint8_t j = 0;
@@ -153,7 +156,7 @@ static void heartbeatBuf_update(float accXinc, float accYinc){
 
 
 void heartbeat_init(void){
-    heartbeatBuf = (uint8_t *)malloc(240 * 240); //动态分配一块屏幕分辨率大小的空间
+    heartbeatBuf = buf_lease(&heartbeatLease, BUF_FRAME, HEARTBEAT_BUF_OWNER); //租借一块屏幕分辨率大小的空间
     if(heartbeatBuf == NULL){
         Serial.println("1:lack of memory");
         while(1);
@@ -190,10 +193,7 @@ void heartbeat_process(lv_obj_t *ym){
     heartbeat_init();
     while(1){
         /* MPU6050数据获取 */
-        if (isCheckAction){
-            isCheckAction = false;
-            act_info = mpu.getAction();
-        }
+        act_info = mpu.getAction();
         accXinc = 0;
         accYinc = 0;
         /* MPU6050动作响应 */
@@ -220,7 +220,8 @@ void heartbeat_process(lv_obj_t *ym){
         delay(2);    
     }
     free(h_circles);
-    free(heartbeatBuf);
+    buf_return(&heartbeatLease, HEARTBEAT_BUF_OWNER);
+    heartbeatBuf = NULL;
 
     lv_scr_load_anim(ym, LV_SCR_LOAD_ANIM_OUT_TOP, 573, 0, false);//调用系统退出函数之前，一定要等待动画结束否则会导致系统重启
     lv_obj_invalidate(lv_scr_act());//哪怕缓存没变，也让lvgl下次更新全部屏幕
@@ -11,6 +11,7 @@
 bool tmfromString(const char *date_str, struct tm *date);
 
 // 纪念日的持久化配置
+#define ANNIVERSARY_CONFIG_NS "anniversary"
 #define ANNIVERSARY_CONFIG_PATH "/anniversary.cfg"
 struct AN_Config
 {
@@ -22,36 +23,32 @@ struct AN_Config
 
 static long long get_timestamp(String url);
 
+// 与旧版文本配置文件中的行顺序一致
+static const char *const anniversary_cfg_keys[] = {
+    "anniversary_cnt", "event_name_0", "target_date_0",
+    "event_name_1", "target_date_1", "current_date"};
+
 static void write_config(AN_Config *cfg)
 {
     char tmp[16];
-    // 将配置数据保存在文件中（持久化）
-    String w_data;
-    memset(tmp, 0, 16);
-    snprintf(tmp, 16, "%lu\n", cfg->anniversary_cnt);
-    w_data += tmp;
+    // 将配置数据保存在配置存储中（持久化） 日期按"年.月.日"保存
+    g_cfgStore.setUInt(ANNIVERSARY_CONFIG_NS, "anniversary_cnt", cfg->anniversary_cnt);
     for (int i = 0; i < MAX_ANNIVERSARY_CNT; ++i)
     {
-        w_data = w_data + cfg->event_name[i] + "\n";
-        memset(tmp, 0, 16);
-        snprintf(tmp, 16, "%d.%d.%d\n", cfg->target_date[i].tm_year, cfg->target_date[i].tm_mon, cfg->target_date[i].tm_mday);
-        w_data += tmp;
+        g_cfgStore.setString(ANNIVERSARY_CONFIG_NS, anniversary_cfg_keys[2 * i + 1],
+                             cfg->event_name[i].c_str());
+        snprintf(tmp, 16, "%d.%d.%d", cfg->target_date[i].tm_year, cfg->target_date[i].tm_mon, cfg->target_date[i].tm_mday);
+        g_cfgStore.setString(ANNIVERSARY_CONFIG_NS, anniversary_cfg_keys[2 * i + 2], tmp);
     }
-    memset(tmp, 0, 16);
-    snprintf(tmp, 16, "%d.%d.%d\n", cfg->current_date.tm_year, cfg->current_date.tm_mon, cfg->current_date.tm_mday);
-    w_data += tmp;
-    g_flashCfg.writeFile(ANNIVERSARY_CONFIG_PATH, w_data.c_str());
+    snprintf(tmp, 16, "%d.%d.%d", cfg->current_date.tm_year, cfg->current_date.tm_mon, cfg->current_date.tm_mday);
+    g_cfgStore.setString(ANNIVERSARY_CONFIG_NS, "current_date", tmp);
+    g_cfgStore.commit();
 }
 
 static void read_config(AN_Config *cfg)
 {
-    // 如果有需要持久化配置文件 可以调用此函数将数据存在flash中
-    // 配置文件名最好以APP名为开头 以".cfg"结尾，以免多个APP读取混乱
-    char info[128] = {0};
-    uint16_t size = g_flashCfg.readFile(ANNIVERSARY_CONFIG_PATH, (uint8_t *)info);
-    Serial.printf("size %d\n", size);
-    info[size] = 0;
-    if (size == 0)
+    bool exist = g_cfgStore.migrate(ANNIVERSARY_CONFIG_NS, ANNIVERSARY_CONFIG_PATH, anniversary_cfg_keys);
+    if (!exist)
     {
         // 默认值
         cfg->anniversary_cnt = 2;
@@ -65,20 +62,18 @@ static void read_config(AN_Config *cfg)
         cfg->target_date[1].tm_mday = 4;
         write_config(cfg);
         Serial.printf("Write config successful\n");
+        return;
     }
-    else
+
+    cfg->anniversary_cnt = g_cfgStore.getUInt(ANNIVERSARY_CONFIG_NS, "anniversary_cnt", 0);
+    for (int i = 0; i < MAX_ANNIVERSARY_CNT; ++i)
     {
-        // 解析数据
-        char *param[MAX_ANNIVERSARY_CNT * 2 + 2] = {0};
-        analyseParam(info, MAX_ANNIVERSARY_CNT * 2 + 2, param);
-        cfg->anniversary_cnt = atol(param[0]);
-        for (int i = 0; i < MAX_ANNIVERSARY_CNT; ++i)
-        {
-            cfg->event_name[i] = param[2 * i + 1];
-            tmfromString(param[2 * i + 2], &(cfg->target_date[i]));
-        }
-        tmfromString(param[MAX_ANNIVERSARY_CNT * 2 + 1], &(cfg->current_date));
+        cfg->event_name[i] = g_cfgStore.getString(ANNIVERSARY_CONFIG_NS, anniversary_cfg_keys[2 * i + 1]);
+        tmfromString(g_cfgStore.getString(ANNIVERSARY_CONFIG_NS, anniversary_cfg_keys[2 * i + 2], "0.0.0").c_str(),
+                     &(cfg->target_date[i]));
     }
+    tmfromString(g_cfgStore.getString(ANNIVERSARY_CONFIG_NS, "current_date", "0.0.0").c_str(),
+                 &(cfg->current_date));
 }
 
 // 动态数据，APP的生命周期结束也需要释放它
@@ -247,6 +242,8 @@ static int anniversary_init(AppController *sys)
     run_data->preWeatherMillis = 0;
     run_data->preTimeMillis = 0;
     run_data->coactusUpdateFlag = 0x01;
+    // 界面不需要频繁刷新 没有动作时每300ms处理一次
+    sys->set_process_interval(300);
     Serial.printf("anniversary init successful\n");
     return 0;
 }
@@ -296,8 +293,6 @@ static void anniversary_process(AppController *sys,
     // sys->send_to(ANNIVERSARY_APP_NAME, CTRL_NAME,
     //              APP_MESSAGE_WIFI_CONN, (void *)run_data->val1, NULL);
 
-    // 程序需要时可以适当加延时
-    delay(300);
 }
 
 static void anniversary_background_task(AppController *sys,
@@ -7,6 +7,7 @@
 #define OTHER_API "https://api.bilibili.com/x/space/upstat?mid="
 
 // Bilibili的持久化配置
+#define B_CONFIG_NS "bilibili"
 #define B_CONFIG_PATH "/bilibili.cfg"
 struct B_Config
 {
@@ -14,40 +15,26 @@ struct B_Config
     unsigned long updataInterval; // 更新的时间间隔(s)
 };
 
+static const char *const bilibili_cfg_keys[] = {"bili_uid", "updataInterval"};
+
 static void write_config(const B_Config *cfg)
 {
-    char tmp[16];
-    // 将配置数据保存在文件中（持久化）
-    String w_data;
-    w_data = w_data + cfg->bili_uid + "\n";
-    memset(tmp, 0, 16);
-    snprintf(tmp, 16, "%lu\n", cfg->updataInterval);
-    w_data += tmp;
-    g_flashCfg.writeFile(B_CONFIG_PATH, w_data.c_str());
+    // 将配置数据保存在配置存储中（持久化）
+    g_cfgStore.setString(B_CONFIG_NS, "bili_uid", cfg->bili_uid.c_str());
+    g_cfgStore.setUInt(B_CONFIG_NS, "updataInterval", cfg->updataInterval);
+    g_cfgStore.commit();
 }
 
 static void read_config(B_Config *cfg)
 {
-    // 如果有需要持久化配置文件 可以调用此函数将数据存在flash中
-    // 配置文件名最好以APP名为开头 以".cfg"结尾，以免多个APP读取混乱
-    char info[128] = {0};
-    uint16_t size = g_flashCfg.readFile(B_CONFIG_PATH, (uint8_t *)info);
-    info[size] = 0;
-    if (size == 0)
+    bool exist = g_cfgStore.migrate(B_CONFIG_NS, B_CONFIG_PATH, bilibili_cfg_keys);
+    // 默认值
+    cfg->bili_uid = g_cfgStore.getString(B_CONFIG_NS, "bili_uid", "344470052");         // B站的用户ID
+    cfg->updataInterval = g_cfgStore.getUInt(B_CONFIG_NS, "updataInterval", 900000); // 更新的时间间隔900000(900s)
+    if (!exist)
     {
-        // 默认值
-        cfg->bili_uid = "344470052";  // B站的用户ID
-        cfg->updataInterval = 900000; // 更新的时间间隔900000(900s)
         write_config(cfg);
     }
-    else
-    {
-        // 解析数据
-        char *param[2] = {0};
-        analyseParam(info, 2, param);
-        cfg->bili_uid = param[0];
-        cfg->updataInterval = atol(param[1]);
-    }
 }
 
 struct BilibiliAppRunData
@@ -99,6 +86,8 @@ static int bilibili_init(AppController *sys)
     run_data->follow_num = 0;
     run_data->refresh_status = 0;
     run_data->refresh_time_millis = GET_SYS_MILLIS() - cfg_data.updataInterval;
+    // 没有动作时每300ms处理一次
+    sys->set_process_interval(300);
     return 0;
 }
 
@@ -145,8 +134,6 @@ static void bilibili_process(AppController *sys,
     }
 
     display_bilibili("bilibili", anim_type, fans_num, follow_num);
-
-    delay(300);
 }
 
 static void bilibili_background_task(AppController *sys,
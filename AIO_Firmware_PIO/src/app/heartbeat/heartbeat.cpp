@@ -13,6 +13,7 @@
 #define DEFALUT_MQTT_PASSWD "ClimbSnail.v0"
 
 // Bilibili的持久化配置
+#define HEARTBEAT_CONFIG_NS "heartbeat"
 #define HEARTBEAT_CONFIG_PATH "/heartbeat_v2.01.cfg"
 
 extern AppController *app_controller; // APP控制器
@@ -60,97 +61,47 @@ void HeartbeatAppForeverData::callback(char *topic, byte *payload, unsigned int
     }
 }
 
+static const char *const heartbeat_cfg_keys[] = {
+    "mqtt_server", "mqtt_port", "mqtt_user", "mqtt_password", "role", "qq_num"};
+
 static void write_config(HeartbeatAppForeverData *cfg)
 {
-    char tmp[32];
-    String w_data;
-
-    memset(tmp, 0, 32);
-    snprintf(tmp, 32, "%s\n", cfg->mqtt_server);
-    w_data += tmp;
-
-    memset(tmp, 0, 32);
-    snprintf(tmp, 32, "%u\n", cfg->mqtt_port);
-    w_data += tmp;
-
-    memset(tmp, 0, 32);
-    snprintf(tmp, 32, "%s\n", cfg->mqtt_user);
-    w_data += tmp;
-
-    memset(tmp, 0, 32);
-    snprintf(tmp, 32, "%s\n", cfg->mqtt_password);
-    w_data += tmp;
-
-    memset(tmp, 0, 32);
-    snprintf(tmp, 16, "%d\n", cfg->role);
-    w_data += tmp;
-
-    memset(tmp, 0, 32);
-    snprintf(tmp, 32, "%s\n", cfg->qq_num);
-    w_data += tmp;
-
-    g_flashCfg.writeFile(HEARTBEAT_CONFIG_PATH, w_data.c_str());
+    g_cfgStore.setString(HEARTBEAT_CONFIG_NS, "mqtt_server", cfg->mqtt_server);
+    g_cfgStore.setUInt(HEARTBEAT_CONFIG_NS, "mqtt_port", cfg->mqtt_port);
+    g_cfgStore.setString(HEARTBEAT_CONFIG_NS, "mqtt_user", cfg->mqtt_user);
+    g_cfgStore.setString(HEARTBEAT_CONFIG_NS, "mqtt_password", cfg->mqtt_password);
+    g_cfgStore.setInt(HEARTBEAT_CONFIG_NS, "role", cfg->role);
+    g_cfgStore.setString(HEARTBEAT_CONFIG_NS, "qq_num", cfg->qq_num);
+    g_cfgStore.commit();
 }
 
 static void read_config(HeartbeatAppForeverData *cfg)
 {
-    // 如果有需要持久化配置文件 可以调用此函数将数据存在flash中
-    // 配置文件名最好以APP名为开头 以".cfg"结尾，以免多个APP读取混乱
-    char info[256] = {0};
-    uint16_t size = g_flashCfg.readFile(HEARTBEAT_CONFIG_PATH, (uint8_t *)info);
-    Serial.printf("size %d\n", size);
-    info[size] = 0;
-    if (size == 0)
+    bool exist = g_cfgStore.migrate(HEARTBEAT_CONFIG_NS, HEARTBEAT_CONFIG_PATH, heartbeat_cfg_keys);
+    if (!exist)
     {
         // 设置了mqtt服务器才能运行！
         Serial.println("Please config mqtt first!");
-        // 默认值
-        strcpy(cfg->mqtt_server, DEFALUT_MQTT_ADDR);
-        cfg->mqtt_port = DEFALUT_MQTT_PORT; // mqtt服务端口
-        strcpy(cfg->mqtt_user, DEFALUT_MQTT_USERNAME);
-        strcpy(cfg->mqtt_password, DEFALUT_MQTT_PASSWD);
-        cfg->role = 0; // 角色
-        strcpy(cfg->qq_num, "77318186");
-        write_config(cfg);
     }
-    else
+    // 默认值（字符串按目标数组长度截断）
+    g_cfgStore.getString(HEARTBEAT_CONFIG_NS, "mqtt_server", cfg->mqtt_server,
+                         sizeof(cfg->mqtt_server), DEFALUT_MQTT_ADDR);
+    cfg->mqtt_port = g_cfgStore.getUInt(HEARTBEAT_CONFIG_NS, "mqtt_port", DEFALUT_MQTT_PORT); // mqtt服务端口
+    g_cfgStore.getString(HEARTBEAT_CONFIG_NS, "mqtt_user", cfg->mqtt_user,
+                         sizeof(cfg->mqtt_user), DEFALUT_MQTT_USERNAME);
+    g_cfgStore.getString(HEARTBEAT_CONFIG_NS, "mqtt_password", cfg->mqtt_password,
+                         sizeof(cfg->mqtt_password), DEFALUT_MQTT_PASSWD);
+    cfg->role = g_cfgStore.getInt(HEARTBEAT_CONFIG_NS, "role", 0); // 角色
+    g_cfgStore.getString(HEARTBEAT_CONFIG_NS, "qq_num", cfg->qq_num,
+                         sizeof(cfg->qq_num), "77318186");
+    Serial.printf("mqtt_server %s\n", cfg->mqtt_server);
+    Serial.printf("mqtt_port %u\n", cfg->mqtt_port);
+    Serial.printf(HEARTBEAT_APP_NAME " role %d\n", cfg->role);
+    Serial.printf("qq_num %s\n", cfg->qq_num);
+    if (!exist)
     {
-        // 解析数据
-        char *param[6] = {0};
-        int ind = 0;
-        analyseParam(info, 6, param);
-
-        strcpy(cfg->mqtt_server, param[ind++]);
-        Serial.printf("mqtt_server %s\n", cfg->mqtt_server);
-
-        cfg->mqtt_port = atol(param[ind++]);
-        Serial.printf("mqtt_port %u\n", cfg->mqtt_port);
-
-        strcpy(cfg->mqtt_user, param[ind++]);
-        Serial.printf("mqtt_mqtt_user %s\n", cfg->mqtt_user);
-
-        strcpy(cfg->mqtt_password, param[ind++]);
-        Serial.printf("mqtt_mqtt_password %s\n", cfg->mqtt_password);
-
-        cfg->role = atoi(param[ind++]);
-        Serial.printf(HEARTBEAT_APP_NAME " role %d\n", cfg->role);
-
-        strcpy(cfg->qq_num, param[ind++]);
-        Serial.printf("qq_num %s\n", cfg->qq_num);
+        write_config(cfg);
     }
-
-    // 订阅的主题
-    snprintf(cfg->mqtt_subtopic, 32, "/cubic/hb/%s", cfg->qq_num);
-    Serial.printf("mqtt_subtopic %s\n", cfg->mqtt_subtopic);
-    // 发布的主题
-    snprintf(cfg->mqtt_pubtopic, 32, "/cubic/hb/%s", cfg->qq_num);
-    Serial.printf("mqtt_pubtopic %s\n", cfg->mqtt_pubtopic);
-
-    snprintf(cfg->mqtt_client_id, 64, "AIO_%llu", ESP.getEfuseMac());
-    Serial.printf("mqtt_client_id : %s\n", cfg->mqtt_client_id);
-
-    snprintf(cfg->mac_id, 24, "%llu", ESP.getEfuseMac());
-    Serial.printf("mac_id : %s\n", cfg->mac_id);
 }
 
 void HeartbeatAppForeverData::mqtt_reconnect()
@@ -2,6 +2,7 @@
 #include "sys/app_controller.h"
 #include "network.h"
 #include "common.h"
+#include "sys/buf_pool.h"
 #include <stdint.h>
 #include "ui_animation.h"
 
@@ -11,6 +12,7 @@
 // 所有的绘图操作在虚拟的空间上，绘制图像，最后调用tft的图像显示功能显示图像
 
 uint8_t *screen_buf = NULL;
+static BufLease screen_lease; // screen_buf从缓冲池中租借
 int choose = 0;
 
 /*这两个函数都只是对图像进行操作，不是对屏幕*/
@@ -54,7 +56,7 @@ void screen_draw_pixel(int32_t x, int32_t y, uint16_t color) //指定GUI库的
 
 static int idea_init(AppController *sys)
 {
-    screen_buf = (uint8_t *)malloc(SCREEN_HEIGHT * SCREEN_WIDTH); //动态分配一块屏幕分辨率大小的空间
+    screen_buf = buf_lease(&screen_lease, BUF_FRAME, IDEA_APP_NAME); //租借一块屏幕分辨率大小的空间
     if (screen_buf == NULL)
         Serial.println("screen_buf: error");
     else
@@ -111,7 +113,7 @@ static int idea_exit_callback(void *param)
 {
     if (NULL != screen_buf)
     {
-        free(screen_buf);
+        buf_return(&screen_lease, IDEA_APP_NAME);
         screen_buf = NULL;
     }
     return 0;
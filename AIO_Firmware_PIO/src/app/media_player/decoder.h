@@ -4,6 +4,9 @@
 // #define MJPEG_APP_NEW
 
 #include <SD.h>
+#include "sys/buf_pool.h"
+
+#define DECODER_BUF_OWNER "Media" // 解码缓冲区的租借者（与播放器APP同名）
 
 class PlayDecoderBase
 {
@@ -21,6 +24,7 @@ private:
     bool m_isUseDMA;
     uint8_t *m_displayBuf;
     uint8_t *m_displayBufWithDma[2];
+    BufLease m_bufLease[2]; // 以上缓冲区都从缓冲池中租借
 
 public:
     RgbPlayDecoder(File *file, bool isUseDMA = false);
@@ -42,6 +46,8 @@ public:
     // 由此保存环境当前的高低位置换，以便退出视频播放的时候还原回去。
     static bool m_dmaBufferSel;
     static uint8_t *m_displayBufWithDma[2];
+    BufLease m_bufLease[2];    // m_displayBuf与m_jpegBuf从缓冲池中租借
+    BufLease m_dmaBufLease[2]; // m_displayBufWithDma从缓冲池中租借
 
 public:
     MjpegPlayDecoder(File *file, bool isUseDMA = false);
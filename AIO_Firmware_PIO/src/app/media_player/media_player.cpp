@@ -9,15 +9,13 @@
 #define MEDIA_PLAYER_APP_NAME "Media"
 
 #define MOVIE_PATH "/movie"
-#define NO_TRIGGER_ENTER_FREQ_160M 90000UL // 无操作规定时间后进入设置160M主频（90s）
-#define NO_TRIGGER_ENTER_FREQ_80M 120000UL // 无操作规定时间后进入设置160M主频（120s）
 
 // 调试开关
 #define MEDIA_PLAYER_DEBUG 1
 
 // 天气的持久化配置
+#define MEDIA_CONFIG_NS "media"
 #define MEDIA_CONFIG_PATH "/media.cfg"
-#define MAX_CONFIG_LINE_LENGTH 32
 #define MAX_FILENAME_LENGTH 256
 
 struct MP_Config
@@ -37,8 +35,6 @@ typedef enum {
 struct MediaAppRunData
 {
     PlayDecoderBase *player_decoder;
-    unsigned long preTriggerKeyMillis; // 最近一回按键触发的时间戳
-    unsigned long lastPowerCheckMillis; // 上次功耗检查时间
     unsigned long lastFrameTime;       // 上次帧播放时间
     int movie_pos_increate;
     File_Info *movie_file; // movie文件夹下的文件指针头，该指针就指向movie自身。
@@ -108,45 +104,6 @@ static void release_file_info1(File_Info *head)
 }
 */
 
-// 安全的配置设置函数
-static void set_default_config(MP_Config *cfg)
-{
-    cfg->switchFlag = 1; // 是否自动播放下一个（0不切换 1自动切换）
-    cfg->powerFlag = 0;  // 功耗控制（0低发热 1性能优先）
-}
-
-// 安全的配置解析
-static bool parse_config_safely(const char* info, MP_Config *cfg)
-{
-    if (!info || strlen(info) == 0) return false;
-    
-    // 创建可修改的副本
-    char info_copy[256];
-    strncpy(info_copy, info, sizeof(info_copy) - 1);
-    info_copy[sizeof(info_copy) - 1] = '\0';
-    
-    char *param[2] = {0};
-    
-    // analyseParam返回bool，表示是否成功解析
-    bool success = analyseParam(info_copy, 2, param);
-    if (!success) {
-        return false;
-    }
-    
-    // 检查参数是否有效
-    if (param[0] && param[1]) {
-        cfg->switchFlag = atoi(param[0]);
-        cfg->powerFlag = atoi(param[1]);
-        
-        // 参数验证
-        if (cfg->switchFlag > 1) cfg->switchFlag = 1;
-        if (cfg->powerFlag > 1) cfg->powerFlag = 1;
-        return true;
-    }
-    
-    return false;
-}
-
 // 文件扩展名检查优化
 static bool has_extension(const char* filename, const char* ext)
 {
@@ -163,69 +120,35 @@ static bool has_extension(const char* filename, const char* ext)
 
 // ==================== 配置管理 ====================
 
+static const char *const media_cfg_keys[] = {"switchFlag", "powerFlag"};
+
 static void write_config(MP_Config *cfg)
 {
     if (!cfg) return;
-    
-    char tmp[MAX_CONFIG_LINE_LENGTH];
-    String w_data;
-    
-    memset(tmp, 0, sizeof(tmp));
-    snprintf(tmp, sizeof(tmp), "%u\n", cfg->switchFlag);
-    w_data += tmp;
-    
-    memset(tmp, 0, sizeof(tmp));
-    snprintf(tmp, sizeof(tmp), "%u\n", cfg->powerFlag);
-    w_data += tmp;
-    
-    // 直接写入，不检查返回值
-    Serial.print("媒体播放器设置参数中：");
-    Serial.println(tmp);
-    g_flashCfg.writeFile(MEDIA_CONFIG_PATH, w_data.c_str());
+
+    g_cfgStore.setUInt(MEDIA_CONFIG_NS, "switchFlag", cfg->switchFlag);
+    g_cfgStore.setUInt(MEDIA_CONFIG_NS, "powerFlag", cfg->powerFlag);
+    g_cfgStore.commit();
 }
 
 static void read_config(MP_Config *cfg)
 {
     if (!cfg) return;
-    
-    // 更详细的调试信息
-    Serial.println("Reading media player config...");
-    
-    char info[256] = {0};
-    uint16_t size = g_flashCfg.readFile(MEDIA_CONFIG_PATH, (uint8_t *)info);
-    
-    // 检查读取结果
-    if (size == 0) {
-        Serial.println("Config file is empty or not found");
-        set_default_config(cfg);
-        write_config(cfg);
-        return;
-    }
-    
-    if (size >= sizeof(info)) {
-        Serial.println("Config file too large");
-        // 只处理有效部分
-        info[sizeof(info) - 1] = '\0';
-    } else {
-        info[size] = '\0';  // 确保以null结尾
-    }
-    
-    // 调试输出读取的内容
-    Serial.print("Config content: ");
-    Serial.println(info);
-    Serial.print("Config size: ");
-    Serial.println(size);
-    
-    // 尝试解析配置
-    if (!parse_config_safely(info, cfg)) {
-        Serial.println("Failed to parse config, using defaults");
-        set_default_config(cfg);
+
+    bool exist = g_cfgStore.migrate(MEDIA_CONFIG_NS, MEDIA_CONFIG_PATH, media_cfg_keys);
+    cfg->switchFlag = g_cfgStore.getUInt(MEDIA_CONFIG_NS, "switchFlag", 1); // 是否自动播放下一个（0不切换 1自动切换）
+    cfg->powerFlag = g_cfgStore.getUInt(MEDIA_CONFIG_NS, "powerFlag", 0);   // 功耗控制（0低发热 1性能优先）
+
+    // 参数验证
+    if (cfg->switchFlag > 1) cfg->switchFlag = 1;
+    if (cfg->powerFlag > 1) cfg->powerFlag = 1;
+
+    if (!exist)
+    {
         write_config(cfg);
-    } else {
-        Serial.println("Config parsed successfully");
-        Serial.printf("switchFlag: %u, powerFlag: %u\n", 
-                      cfg->switchFlag, cfg->powerFlag);
     }
+    Serial.printf("switchFlag: %u, powerFlag: %u\n",
+                  cfg->switchFlag, cfg->powerFlag);
 }
 
 // ==================== 文件管理 ====================
@@ -495,31 +418,6 @@ static bool video_start(bool create_new)
     return true;
 }
 
-// ==================== 功耗管理 ====================
-
-static void manage_power_consumption(void)
-{
-    if (!run_data) return;
-    
-    uint32_t current_time = GET_SYS_MILLIS();
-    
-    // 降低检查频率，每5秒检查一次
-    if (current_time - run_data->lastPowerCheckMillis < 5000) return;
-    run_data->lastPowerCheckMillis = current_time;
-    
-    if (cfg_data.powerFlag == 0) { // 低功耗模式
-        uint32_t idle_time = current_time - run_data->preTriggerKeyMillis;
-        uint32_t current_freq = getCpuFrequencyMhz();
-        
-        if (idle_time >= NO_TRIGGER_ENTER_FREQ_80M && current_freq > 80) {
-            setCpuFrequencyMhz(80);
-        }
-        else if (idle_time >= NO_TRIGGER_ENTER_FREQ_160M && current_freq > 160) {
-            setCpuFrequencyMhz(160);
-        }
-    }
-}
-
 // ==================== 用户输入处理 ====================
 
 static bool handle_user_input(AppController *sys, const ImuAction *act_info)
@@ -543,12 +441,7 @@ static bool handle_user_input(AppController *sys, const ImuAction *act_info)
         vTaskDelay(400 / portTICK_PERIOD_MS);
         break;
         
-    case UNKNOWN:
-        break;
-        
     default:
-        run_data->preTriggerKeyMillis = GET_SYS_MILLIS();
-        setCpuFrequencyMhz(240);
         break;
     }
     
@@ -607,6 +500,8 @@ static void prepare_next_frame(void)
     if (run_data->player_decoder) {
         run_data->player_decoder->video_play_screen();
         run_data->lastFrameTime = current_time;
+        // 帧耗时的余量交给调频参考
+        cpu_governor_frame(GET_SYS_MILLIS() - current_time, run_data->frameDelay);
     }
 }
 
@@ -634,8 +529,6 @@ static int media_player_init(AppController *sys)
     // 初始化运行数据
     run_data->state = PLAYER_STATE_IDLE;
     run_data->movie_pos_increate = 1;
-    run_data->preTriggerKeyMillis = GET_SYS_MILLIS();
-    run_data->lastPowerCheckMillis = GET_SYS_MILLIS();
     run_data->lastFrameTime = GET_SYS_MILLIS();
     run_data->frameDelay = 40; // 默认25fps
     run_data->retryCount = 0;
@@ -680,8 +573,8 @@ static int media_player_init(AppController *sys)
         Serial.println("No video files found");
         return -1;
     }
-    // 设置初始CPU频率
-    setCpuFrequencyMhz(240);
+    // 低发热模式下 长时间无操作时逐档降频
+    cpu_governor_request(MEDIA_PLAYER_APP_NAME, PERF_LEVEL_HIGH, 0 == cfg_data.powerFlag);
     
     // 开始播放
     if (!video_start(false)) {
@@ -698,7 +591,6 @@ static void media_player_process(AppController *sys, const ImuAction *act_info)
     if (!handle_user_input(sys, act_info)) return;
     if (!manage_playback(sys)) return;
     
-    manage_power_consumption();
     prepare_next_frame();
 }
 
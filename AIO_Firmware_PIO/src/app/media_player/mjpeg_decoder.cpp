@@ -12,9 +12,7 @@
 #define VIDEO_HEIGHT SCREEN_HEIGHT
 #define EACH_READ_SIZE 2500     // 每次获取的数据流大小
 #define JPEG_BUFFER_SIZE 10000  // 储存一张jpeg的图像(240*240 10000大概够了，正常一帧差不多3000)
-#define MOVIE_BUFFER_SIZE 20000 // 理论上是JPEG_BUFFER_SIZE的两倍就够了
-
-#define DMA_BUFFER_SIZE 512 // (16*16*2)
+#define MOVIE_BUFFER_SIZE 20000 // 理论上是JPEG_BUFFER_SIZE的两倍就够了（不超过BUF_STRIP_SIZE）
 
 #define TFT_MISO -1
 #define TFT_MOSI 23
@@ -90,9 +88,11 @@ uint32_t MjpegPlayDecoder::readJpegFromFile(File *file)
             // 防止本帧太大溢出，间接丢弃该帧
             m_bufSaveTail = 0;
             pos = 0;
+            METRIC_INC(METRIC_FRAMES_DROPPED);
         }
         read_size = file->read(&m_displayBuf[m_bufSaveTail], EACH_READ_SIZE);
         m_bufSaveTail += read_size;
+        METRIC_ADD(METRIC_SD_READ_BYTES, read_size);
     }
 
     if (pos + 2 < JPEG_BUFFER_SIZE)
@@ -143,17 +143,17 @@ bool MjpegPlayDecoder::video_start()
 {
     if (m_isUseDMA)
     {
-        m_displayBuf = (uint8_t *)malloc(MOVIE_BUFFER_SIZE);
-        m_jpegBuf = (uint8_t *)malloc(JPEG_BUFFER_SIZE);
-        m_displayBufWithDma[0] = (uint8_t *)heap_caps_malloc(DMA_BUFFER_SIZE, MALLOC_CAP_DMA);
-        m_displayBufWithDma[1] = (uint8_t *)heap_caps_malloc(DMA_BUFFER_SIZE, MALLOC_CAP_DMA);
+        m_displayBuf = buf_lease(&m_bufLease[0], BUF_STRIP, DECODER_BUF_OWNER);
+        m_jpegBuf = buf_lease(&m_bufLease[1], BUF_STRIP, DECODER_BUF_OWNER);
+        m_displayBufWithDma[0] = buf_lease(&m_dmaBufLease[0], BUF_DMA_SMALL, DECODER_BUF_OWNER);
+        m_displayBufWithDma[1] = buf_lease(&m_dmaBufLease[1], BUF_DMA_SMALL, DECODER_BUF_OWNER);
         tft->initDMA();
         // 使用DMA
         // DMADrawer::setup(MOVIE_BUFFER_SIZE, SPI_FREQUENCY, TFT_MOSI, TFT_MISO, TFT_SCLK, TFT_CS, TFT_DC);
     }
     else
     {
-        m_displayBuf = (uint8_t *)malloc(MOVIE_BUFFER_SIZE);
+        m_displayBuf = buf_lease(&m_bufLease[0], BUF_STRIP, DECODER_BUF_OWNER);
         tft->setAddrWindow((tft->width() - VIDEO_WIDTH) / 2,
                            (tft->height() - VIDEO_HEIGHT) / 2,
                            VIDEO_WIDTH, VIDEO_HEIGHT);
@@ -191,6 +191,7 @@ bool MjpegPlayDecoder::video_play_screen(void)
     {
         // 一帧数据大概3000B 240M主频时花费50ms  80M时需要150ms
         // unsigned long Millis_1 = GET_SYS_MILLIS(); // 更新的时间
+        METRIC_TIME_START(decode_start);
         uint32_t jpg_size = readJpegFromFile(m_pFile);
         // Serial.println(jpg_size);
         // Serial.print(GET_SYS_MILLIS() - Millis_1);
@@ -199,6 +200,8 @@ bool MjpegPlayDecoder::video_play_screen(void)
         // Draw the image, top left at 0,0 - DMA request is handled in the call-back tft_output() in this sketch
         TJpgDec.drawJpg(0, 0, m_jpegBuf, jpg_size);
         // Serial.println(GET_SYS_MILLIS() - Millis_1);
+        METRIC_TIME_END_MS(METRIC_MEDIA_DECODE_MS, decode_start);
+        METRIC_INC(METRIC_FRAMES_RENDERED);
     }
     else
     {
@@ -212,14 +215,16 @@ bool MjpegPlayDecoder::video_end(void)
     // 结束播放 释放资源
     if (NULL != m_displayBufWithDma[0])
     {
-        free(m_displayBufWithDma[0]);
-        free(m_displayBufWithDma[1]);
+        // 归还后可能马上被别人写入 需等DMA传输完
+        tft->dmaWait();
+        buf_return(&m_dmaBufLease[0], DECODER_BUF_OWNER);
+        buf_return(&m_dmaBufLease[1], DECODER_BUF_OWNER);
         m_displayBufWithDma[0] = NULL;
         m_displayBufWithDma[1] = NULL;
     }
     if (NULL != m_jpegBuf)
     {
-        free(m_jpegBuf);
+        buf_return(&m_bufLease[1], DECODER_BUF_OWNER);
         m_jpegBuf = NULL;
     }
     // 需要添加wait 不然强行释放dma 会导致下一次initDMA失败
@@ -235,7 +240,7 @@ bool MjpegPlayDecoder::video_end(void)
     // DMADrawer::close();
     if (NULL != m_displayBuf)
     {
-        free(m_displayBuf);
+        buf_return(&m_bufLease[0], DECODER_BUF_OWNER);
         m_displayBuf = NULL;
     }
 
@@ -1,5 +1,7 @@
+#define LOG_TAG "rgb565"
 #include "decoder.h"
 #include "common.h"
+#include "sys/logger.h"
 
 #define VIDEO_WIDTH SCREEN_WIDTH
 #define VIDEO_HEIGHT SCREEN_HEIGHT
@@ -33,15 +35,15 @@ bool RgbPlayDecoder::video_start()
 {
     if (m_isUseDMA)
     {
-        m_displayBufWithDma[0] = (uint8_t *)heap_caps_malloc(MOVIE_BUFFER_SIZE, MALLOC_CAP_DMA);
-        m_displayBufWithDma[1] = (uint8_t *)heap_caps_malloc(MOVIE_BUFFER_SIZE, MALLOC_CAP_DMA);
+        m_displayBufWithDma[0] = buf_lease(&m_bufLease[0], BUF_STRIP, DECODER_BUF_OWNER);
+        m_displayBufWithDma[1] = buf_lease(&m_bufLease[1], BUF_STRIP, DECODER_BUF_OWNER);
         tft->initDMA();
         // 使用DMA
         // DMADrawer::setup(MOVIE_BUFFER_SIZE, SPI_FREQUENCY, TFT_MOSI, TFT_MISO, TFT_SCLK, TFT_CS, TFT_DC);
     }
     else
     {
-        m_displayBuf = (uint8_t *)malloc(MOVIE_BUFFER_SIZE);
+        m_displayBuf = buf_lease(&m_bufLease[0], BUF_STRIP, DECODER_BUF_OWNER);
         tft->setAddrWindow((tft->width() - VIDEO_WIDTH) / 2,
                            (tft->height() - VIDEO_HEIGHT) / 2,
                            VIDEO_WIDTH, VIDEO_HEIGHT);
@@ -81,20 +83,25 @@ bool RgbPlayDecoder::video_play_screen(void)
         // 80M主频大概200ms一帧 240M大概150ms一帧
         uint8_t *dst = NULL;
         dst = m_displayBufWithDma[0];
-        m_pFile->read(dst, MOVIE_BUFFER_SIZE);
+        l = m_pFile->read(dst, MOVIE_BUFFER_SIZE);
+        METRIC_ADD(METRIC_SD_READ_BYTES, l);
         tft->pushImageDMA(0, 0, 240, 60, (uint16_t *)dst, nullptr);
 
         dst = m_displayBufWithDma[1];
-        m_pFile->read(dst, MOVIE_BUFFER_SIZE);
+        l = m_pFile->read(dst, MOVIE_BUFFER_SIZE);
+        METRIC_ADD(METRIC_SD_READ_BYTES, l);
         tft->pushImageDMA(0, 60, 240, 60, (uint16_t *)dst, nullptr);
 
         dst = m_displayBufWithDma[0];
-        m_pFile->read(dst, MOVIE_BUFFER_SIZE);
+        l = m_pFile->read(dst, MOVIE_BUFFER_SIZE);
+        METRIC_ADD(METRIC_SD_READ_BYTES, l);
         tft->pushImageDMA(0, 120, 240, 60, (uint16_t *)dst, nullptr);
 
         dst = m_displayBufWithDma[1];
-        m_pFile->read(dst, MOVIE_BUFFER_SIZE);
+        l = m_pFile->read(dst, MOVIE_BUFFER_SIZE);
+        METRIC_ADD(METRIC_SD_READ_BYTES, l);
         tft->pushImageDMA(0, 180, 240, 60, (uint16_t *)dst, nullptr);
+        METRIC_INC(METRIC_FRAMES_RENDERED);
 
         // 以下是使用DMADrawer接口的实现 目前有一定问题，暂时放着
         // uint8_t *dst = NULL;
@@ -117,19 +124,21 @@ bool RgbPlayDecoder::video_play_screen(void)
     else
     {
 
+        unsigned long cost[4]; // 前两块的读取与显示耗时
         tft->startWrite();
         Millis_1 = GET_SYS_MILLIS();
         l = m_pFile->read(m_displayBuf, MOVIE_BUFFER_SIZE);
-        Serial.println(GET_SYS_MILLIS() - Millis_1);
+        cost[0] = GET_SYS_MILLIS() - Millis_1;
         Millis_1 = GET_SYS_MILLIS();
         tft->pushColors(m_displayBuf, l);
-        Serial.println(GET_SYS_MILLIS() - Millis_1);
+        cost[1] = GET_SYS_MILLIS() - Millis_1;
         Millis_1 = GET_SYS_MILLIS();
         l = m_pFile->read(m_displayBuf, MOVIE_BUFFER_SIZE);
-        Serial.println(GET_SYS_MILLIS() - Millis_1);
+        cost[2] = GET_SYS_MILLIS() - Millis_1;
         Millis_1 = GET_SYS_MILLIS();
         tft->pushColors(m_displayBuf, l);
-        Serial.println(GET_SYS_MILLIS() - Millis_1);
+        cost[3] = GET_SYS_MILLIS() - Millis_1;
+        LOGV("read %lu push %lu read %lu push %lu ms", cost[0], cost[1], cost[2], cost[3]);
 
         l = m_pFile->read(m_displayBuf, MOVIE_BUFFER_SIZE);
         tft->pushColors(m_displayBuf, l);
@@ -149,8 +158,10 @@ bool RgbPlayDecoder::video_end(void)
     {
         if (NULL != m_displayBufWithDma[0])
         {
-            free(m_displayBufWithDma[0]);
-            free(m_displayBufWithDma[1]);
+            // 归还后可能马上被别人写入 需等DMA传输完
+            tft->dmaWait();
+            buf_return(&m_bufLease[0], DECODER_BUF_OWNER);
+            buf_return(&m_bufLease[1], DECODER_BUF_OWNER);
             m_displayBufWithDma[0] = NULL;
             m_displayBufWithDma[1] = NULL;
         }
@@ -170,7 +181,7 @@ bool RgbPlayDecoder::video_end(void)
     {
         if (NULL != m_displayBuf)
         {
-            free(m_displayBuf);
+            buf_return(&m_bufLease[0], DECODER_BUF_OWNER);
             m_displayBuf = NULL;
         }
     }
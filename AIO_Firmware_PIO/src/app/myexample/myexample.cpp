@@ -39,13 +39,13 @@ static int myexample_init(AppController *sys)
     // 使用 forever_data 中的变量，任何函数都可以用
     Serial.print(forever_data.val1);
 
-    // 如果有需要持久化配置文件 可以调用此函数将数据存在flash中
-    // 配置文件名最好以APP名为开头 以".cfg"结尾，以免多个APP读取混乱
-    char info[128] = {0};
-    uint16_t size = g_flashCfg.readFile("/myexample.cfg", (uint8_t *)info);
-    // 解析数据
-    // 将配置数据保存在文件中（持久化）
-    g_flashCfg.writeFile("/myexample.cfg", "value1=100\nvalue2=200");
+    // 如果有需要持久化配置 可以通过g_cfgStore将数据存在flash中
+    // 命名空间最好使用APP名，以免多个APP读取混乱
+    int value1 = g_cfgStore.getInt("myexample", "value1", 100);
+    // 将配置数据保存在配置存储中（持久化）
+    g_cfgStore.setInt("myexample", "value1", value1);
+    g_cfgStore.setInt("myexample", "value2", 200);
+    g_cfgStore.commit();
     
     return 0;
 }
@@ -38,6 +38,7 @@ static const char *rs_data_unit[] = {
 };
 
 // 传感器组件的持久化配置
+#define PC_RESOURCE_CONFIG_NS "pc_resource"
 #define PC_RESOURCE_CONFIG_PATH "/pc_resource.cfg"
 struct PCS_Config
 {
@@ -65,40 +66,27 @@ static PCResourceAppRunData *run_data = NULL;
 // 配置信息
 static PCS_Config cfg_data;
 
+static const char *const pc_resource_cfg_keys[] = {"pc_ipaddr", "sensorUpdataInterval"};
+
 static void write_config(PCS_Config *cfg)
 {
-    char tmp[16];
-    // 将配置数据保存在文件中（持久化）
-    String w_data;
-    w_data = w_data + cfg->pc_ipaddr + "\n";
-    memset(tmp, 0, 16);
-    snprintf(tmp, 16, "%lu\n", cfg->sensorUpdataInterval);
-    w_data += tmp;
-    g_flashCfg.writeFile(PC_RESOURCE_CONFIG_PATH, w_data.c_str());
+    // 将配置数据保存在配置存储中（持久化）
+    g_cfgStore.setString(PC_RESOURCE_CONFIG_NS, "pc_ipaddr", cfg->pc_ipaddr.c_str());
+    g_cfgStore.setUInt(PC_RESOURCE_CONFIG_NS, "sensorUpdataInterval", cfg->sensorUpdataInterval);
+    g_cfgStore.commit();
 }
 
 static void read_config(PCS_Config *cfg)
 {
-    // 如果有需要持久化配置文件 可以调用此函数将数据存在flash中
-    // 配置文件名最好以APP名为开头 以".cfg"结尾，以免多个APP读取混乱
-    char info[64] = {0};
-    uint16_t size = g_flashCfg.readFile(PC_RESOURCE_CONFIG_PATH, (uint8_t *)info);
-    info[size] = 0;
-    if (size == 0)
+    bool exist = g_cfgStore.migrate(PC_RESOURCE_CONFIG_NS, PC_RESOURCE_CONFIG_PATH, pc_resource_cfg_keys);
+    // 默认值
+    cfg->pc_ipaddr = g_cfgStore.getString(PC_RESOURCE_CONFIG_NS, "pc_ipaddr", "0.0.0.0");
+    // 传感器数据更新的时间间隔1000(1s)
+    cfg->sensorUpdataInterval = g_cfgStore.getUInt(PC_RESOURCE_CONFIG_NS, "sensorUpdataInterval", 1000);
+    if (!exist)
     {
-        // 默认值
-        cfg->pc_ipaddr = "0.0.0.0";
-        cfg->sensorUpdataInterval = 1000; // 传感器数据更新的时间间隔1000(1s)
         write_config(cfg);
     }
-    else
-    {
-        // 解析数据
-        char *param[2] = {0};
-        analyseParam(info, 2, param);
-        cfg->pc_ipaddr = param[0];
-        cfg->sensorUpdataInterval = atol(param[1]);
-    }
 }
 
 /**
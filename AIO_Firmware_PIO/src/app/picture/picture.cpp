@@ -1,5 +1,7 @@
 #include "picture.h"
 #include "picture_gui.h"
+#include "picture_cache.h"
+#include "picture_prefetch.h"
 #include "sys/app_controller.h"
 #include "common.h"
 
@@ -7,45 +9,38 @@
 #include <TJpg_Decoder.h>
 
 #define PICTURE_APP_NAME "Picture"
+#define PIC_CACHE_WARM_IDLE 1500 // 预热缓存需要的最短空闲时间 ms
 
 // 相册的持久化配置
+#define PICTURE_CONFIG_NS "picture"
 #define PICTURE_CONFIG_PATH "/picture.cfg"
 struct PIC_Config
 {
     unsigned long switchInterval; // 自动播放下一张的时间间隔 ms
+    uint16_t cacheSize;           // jpg解码缓存的上限 MB（0为关闭缓存）
 };
 
+static const char *const picture_cfg_keys[] = {"switchInterval", "cacheSize"};
+
 static void write_config(PIC_Config *cfg)
 {
-    char tmp[16];
-    // 将配置数据保存在文件中（持久化）
-    String w_data;
-    memset(tmp, 0, 16);
-    snprintf(tmp, 16, "%lu\n", cfg->switchInterval);
-    w_data += tmp;
-    g_flashCfg.writeFile(PICTURE_CONFIG_PATH, w_data.c_str());
+    // 将配置数据保存在配置存储中（持久化）
+    g_cfgStore.setUInt(PICTURE_CONFIG_NS, "switchInterval", cfg->switchInterval);
+    g_cfgStore.setUInt(PICTURE_CONFIG_NS, "cacheSize", cfg->cacheSize);
+    g_cfgStore.commit();
 }
 
 static void read_config(PIC_Config *cfg)
 {
-    // 如果有需要持久化配置文件 可以调用此函数将数据存在flash中
-    // 配置文件名最好以APP名为开头 以".cfg"结尾，以免多个APP读取混乱
-    char info[128] = {0};
-    uint16_t size = g_flashCfg.readFile(PICTURE_CONFIG_PATH, (uint8_t *)info);
-    info[size] = 0;
-    if (size == 0)
+    // 兼容只有一个参数的旧配置文件
+    bool exist = g_cfgStore.migrate(PICTURE_CONFIG_NS, PICTURE_CONFIG_PATH, picture_cfg_keys);
+    // 默认值
+    cfg->switchInterval = g_cfgStore.getUInt(PICTURE_CONFIG_NS, "switchInterval", 10000); // 是否自动播放下一个（0不切换 默认10000毫秒）
+    cfg->cacheSize = g_cfgStore.getUInt(PICTURE_CONFIG_NS, "cacheSize", 0);               // 默认不开启缓存
+    if (!exist)
     {
-        // 默认值
-        cfg->switchInterval = 10000; // 是否自动播放下一个（0不切换 默认10000毫秒）
         write_config(cfg);
     }
-    else
-    {
-        // 解析数据
-        char *param[1] = {0};
-        analyseParam(info, 1, param);
-        cfg->switchInterval = atol(param[0]);
-    }
 }
 
 struct PictureAppRunData
@@ -71,6 +66,8 @@ bool tft_output(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t *bitmap)
     if (y >= tft->height())
         return 0;
 
+    pic_cache_write_block(x, y, w, h, bitmap);
+
     // This function will clip the image block rendering automatically at the TFT boundaries
     tft->pushImage(x, y, w, h, bitmap);
 
@@ -101,6 +98,51 @@ static File_Info *get_next_file(File_Info *p_cur_file, int direction)
     return pfile;
 }
 
+static bool is_jpg_file(const char *file_name)
+{
+    return NULL != strstr(file_name, ".jpg") || NULL != strstr(file_name, ".JPG") || NULL != strstr(file_name, ".JEPG") || NULL != strstr(file_name, ".jpeg");
+}
+
+// 解码jpg并在可能时写入缓存
+// jpg_buf不为空时使用已预取到内存中的数据解码
+static void decode_jpg(const char *file_name,
+                       const uint8_t *jpg_buf = NULL, uint32_t jpg_size = 0)
+{
+    pic_prefetch_lock();
+    bool recording = pic_cache_begin(file_name);
+    JRESULT ret;
+    TJpgDec.setCallback(tft_output);
+    if (NULL != jpg_buf)
+    {
+        ret = TJpgDec.drawJpg(0, 0, jpg_buf, jpg_size);
+    }
+    else
+    {
+        ret = TJpgDec.drawSdJpg(0, 0, file_name);
+    }
+    if (recording)
+    {
+        pic_cache_end(JDR_OK == ret);
+    }
+    pic_prefetch_unlock();
+}
+
+// 缓存索引也会被预取任务中的预热修改 需要与解码共用一把锁
+static bool cache_draw(const char *file_name)
+{
+    pic_prefetch_lock();
+    bool ret = pic_cache_draw(file_name);
+    pic_prefetch_unlock();
+    return ret;
+}
+
+// 通知预取任务准备当前图片前后的两张
+static void update_prefetch(void)
+{
+    pic_prefetch_update(get_next_file(run_data->pfile, run_data->image_pos_increate),
+                        get_next_file(run_data->pfile, -run_data->image_pos_increate));
+}
+
 static int picture_init(AppController *sys)
 {
     photo_gui_init();
@@ -124,12 +166,21 @@ static int picture_init(AppController *sys)
     if (NULL != run_data->image_file)
     {
         run_data->pfile = get_next_file(run_data->image_file->next_node, 1);
+        pic_cache_init(cfg_data.cacheSize);
     }
 
     // The jpeg image can be scaled by a factor of 1, 2, 4, or 8
     TJpgDec.setJpgScale(1);
     // The decoder must be given the exact name of the rendering function above
     TJpgDec.setCallback(tft_output);
+
+    // 解码器设置完成后再启动预取任务
+    if (NULL != run_data->pfile && pic_prefetch_start(run_data->image_file->file_name))
+    {
+        update_prefetch();
+    }
+    // 图片的读取和解码已交给预取任务 没有动作时每50ms检查一次切换与预热
+    sys->set_process_interval(50);
     return 0;
 }
 
@@ -185,10 +236,16 @@ static void picture_process(AppController *sys,
         // Draw the image, top left at 0,0
         Serial.print(F("Decode image: "));
         Serial.println(file_name);
-        if (NULL != strstr(file_name, ".jpg") || NULL != strstr(file_name, ".JPG") || NULL != strstr(file_name, ".JEPG") || NULL != strstr(file_name, ".jpeg") )
+        if (is_jpg_file(file_name))
         {
-            // 直接解码jpg格式的图片
-            TJpgDec.drawSdJpg(0, 0, file_name);
+            // 依次尝试：预解码的画面、解码缓存、预读到内存的数据、直接解码SD卡上的文件
+            const uint8_t *jpg_buf = NULL;
+            uint32_t jpg_size = 0;
+            if (!pic_prefetch_draw(run_data->pfile) && !cache_draw(file_name))
+            {
+                pic_prefetch_get_jpg(run_data->pfile, &jpg_buf, &jpg_size);
+                decode_jpg(file_name, jpg_buf, jpg_size);
+            }
         }
         else if (NULL != strstr(file_name, ".bin") || NULL != strstr(file_name, ".BIN"))
         {
@@ -198,8 +255,14 @@ static void picture_process(AppController *sys,
         run_data->refreshFlag = false;
         // 重置更新的时间标记
         run_data->pic_perMillis = GET_SYS_MILLIS();
+        update_prefetch();
+    }
+    else if (NULL != run_data->pfile && (0 == cfg_data.switchInterval ||
+             GET_SYS_MILLIS() - run_data->pic_perMillis + PIC_CACHE_WARM_IDLE < cfg_data.switchInterval))
+    {
+        // 距离下次切换还有足够时间时预热缓存
+        pic_prefetch_warm_up(run_data->image_file);
     }
-    delay(300);
 }
 
 static void picture_background_task(AppController *sys,
@@ -211,6 +274,8 @@ static void picture_background_task(AppController *sys,
 
 static int picture_exit_callback(void *param)
 {
+    pic_prefetch_stop();
+    pic_cache_deinit();
     photo_gui_del();
     // 释放文件名链表
     release_file_info(run_data->image_file);
@@ -239,6 +304,10 @@ static void picture_message_handle(const char *from, const char *to,
         {
             snprintf((char *)ext_info, 32, "%lu", cfg_data.switchInterval);
         }
+        else if (!strcmp(param_key, "cacheSize"))
+        {
+            snprintf((char *)ext_info, 32, "%u", cfg_data.cacheSize);
+        }
         else
         {
             snprintf((char *)ext_info, 32, "%s", "NULL");
@@ -253,6 +322,10 @@ static void picture_message_handle(const char *from, const char *to,
         {
             cfg_data.switchInterval = atol(param_val);
         }
+        else if (!strcmp(param_key, "cacheSize"))
+        {
+            cfg_data.cacheSize = atol(param_val);
+        }
     }
     break;
     case APP_MESSAGE_READ_CFG:
@@ -0,0 +1,430 @@
+#include "picture_cache.h"
+#include "common.h"
+#include "sys/buf_pool.h"
+
+#include <TJpg_Decoder.h>
+
+#define PIC_CACHE_INDEX_MAGIC 0x31435050 // "PPC1"
+#define PIC_CACHE_TMP_PATH PIC_CACHE_PATH "/tmp.565"
+#define PIC_CACHE_STRIP_LINES 16 // 解码时暂存的行数（jpg最大的MCU高度）
+#define PIC_CACHE_BUF_OWNER "Picture" // 推送缓冲区的租借者（与图片APP同名）
+
+struct PicCacheEntry
+{
+    uint32_t key;   // 由路径、文件大小、修改时间计算得到
+    uint32_t stamp; // 最近一次使用的序号 越小越久未使用
+};
+
+struct PicCacheIndexHeader
+{
+    uint32_t magic;
+    uint32_t count;
+    uint32_t stamp;
+};
+
+struct PicCacheData
+{
+    uint32_t max_entries; // 由缓存上限换算出的最大图片数
+    uint32_t count;
+    uint32_t stamp;
+    PicCacheEntry entries[PIC_CACHE_MAX_ENTRIES];
+    uint8_t *dma_buf[2]; // 推送到屏幕的双缓冲
+    BufLease dma_lease[2]; // dma_buf从缓冲池中租借（PIC_CACHE_STRIP_SIZE与BUF_STRIP_SIZE相同）
+
+    // 以下为记录解码输出时使用
+    File rec_file;
+    uint32_t rec_key;
+    bool rec_active;
+    int16_t strip_y;  // 当前暂存条带的起始行 -1表示无数据
+    uint16_t strip_h; // 当前暂存条带的高度
+    uint16_t next_y;  // 期望的下一个条带起始行
+    uint16_t strip[PIC_CACHE_WIDTH * PIC_CACHE_STRIP_LINES];
+};
+
+static PicCacheData *cache = NULL;
+
+static void get_blob_path(uint32_t key, char *path)
+{
+    snprintf(path, 32, "%s/%08X.565", PIC_CACHE_PATH, key);
+}
+
+static uint32_t fnv1a(uint32_t hash, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; ++i)
+    {
+        hash ^= data[i];
+        hash *= 16777619UL;
+    }
+    return hash;
+}
+
+static bool calc_key(const char *file_name, uint32_t *key)
+{
+    File file = tf.open(file_name);
+    if (!file)
+    {
+        return false;
+    }
+    uint32_t size = file.size();
+    uint32_t mtime = (uint32_t)file.getLastWrite();
+    file.close();
+
+    uint32_t hash = fnv1a(2166136261UL, (const uint8_t *)file_name, strlen(file_name));
+    hash = fnv1a(hash, (const uint8_t *)&size, sizeof(size));
+    hash = fnv1a(hash, (const uint8_t *)&mtime, sizeof(mtime));
+    *key = hash;
+    return true;
+}
+
+static int find_entry(uint32_t key)
+{
+    for (uint32_t pos = 0; pos < cache->count; ++pos)
+    {
+        if (cache->entries[pos].key == key)
+        {
+            return pos;
+        }
+    }
+    return -1;
+}
+
+static void remove_entry(int pos)
+{
+    char path[32];
+    get_blob_path(cache->entries[pos].key, path);
+    tf.deleteFile(path);
+    cache->entries[pos] = cache->entries[cache->count - 1];
+    --cache->count;
+}
+
+static void save_index(void)
+{
+    File file = tf.open(PIC_CACHE_INDEX_PATH, FILE_WRITE);
+    if (!file)
+    {
+        Serial.println(F("[PicCache] save index failed"));
+        return;
+    }
+    PicCacheIndexHeader header = {PIC_CACHE_INDEX_MAGIC, cache->count, cache->stamp};
+    file.write((const uint8_t *)&header, sizeof(header));
+    file.write((const uint8_t *)cache->entries, cache->count * sizeof(PicCacheEntry));
+    file.close();
+}
+
+static void load_index(void)
+{
+    cache->count = 0;
+    cache->stamp = 0;
+    File file = tf.open(PIC_CACHE_INDEX_PATH);
+    if (!file)
+    {
+        return;
+    }
+    PicCacheIndexHeader header;
+    if (file.read((uint8_t *)&header, sizeof(header)) == sizeof(header) &&
+        PIC_CACHE_INDEX_MAGIC == header.magic &&
+        header.count <= PIC_CACHE_MAX_ENTRIES)
+    {
+        size_t len = header.count * sizeof(PicCacheEntry);
+        if (file.read((uint8_t *)cache->entries, len) == len)
+        {
+            cache->count = header.count;
+            cache->stamp = header.stamp;
+        }
+    }
+    file.close();
+}
+
+// 淘汰最久未使用的图片 直到剩余free_num个空位
+static void evict(uint32_t free_num)
+{
+    bool changed = false;
+    while (cache->count > 0 && cache->count + free_num > cache->max_entries)
+    {
+        int oldest = 0;
+        for (uint32_t pos = 1; pos < cache->count; ++pos)
+        {
+            if (cache->entries[pos].stamp < cache->entries[oldest].stamp)
+            {
+                oldest = pos;
+            }
+        }
+        remove_entry(oldest);
+        changed = true;
+    }
+    if (changed)
+    {
+        save_index();
+    }
+}
+
+static void abort_record(void)
+{
+    cache->rec_file.close();
+    cache->rec_active = false;
+    tf.deleteFile(PIC_CACHE_TMP_PATH);
+}
+
+static void flush_strip(void)
+{
+    size_t len = PIC_CACHE_WIDTH * cache->strip_h * 2;
+    if (cache->rec_file.write((const uint8_t *)cache->strip, len) != len)
+    {
+        Serial.println(F("[PicCache] write failed"));
+        abort_record();
+        return;
+    }
+    cache->next_y = cache->strip_y + cache->strip_h;
+}
+
+bool pic_cache_init(uint32_t max_size_mb)
+{
+    if (NULL != cache)
+    {
+        return true;
+    }
+
+    uint32_t max_entries = max_size_mb * 1024 * 1024 / PIC_CACHE_BLOB_SIZE;
+    if (0 == max_entries)
+    {
+        return false;
+    }
+
+    cache = (PicCacheData *)calloc(1, sizeof(PicCacheData));
+    if (NULL == cache)
+    {
+        return false;
+    }
+    cache->max_entries = min(max_entries, (uint32_t)PIC_CACHE_MAX_ENTRIES);
+    cache->dma_buf[0] = buf_lease(&cache->dma_lease[0], BUF_STRIP, PIC_CACHE_BUF_OWNER);
+    cache->dma_buf[1] = buf_lease(&cache->dma_lease[1], BUF_STRIP, PIC_CACHE_BUF_OWNER);
+    if (NULL == cache->dma_buf[0] || NULL == cache->dma_buf[1])
+    {
+        Serial.println(F("[PicCache] malloc failed, cache disabled"));
+        pic_cache_deinit();
+        return false;
+    }
+    tft->initDMA();
+
+    File dir = tf.open(PIC_CACHE_PATH);
+    if (!dir)
+    {
+        tf.createDir(PIC_CACHE_PATH);
+    }
+    else
+    {
+        dir.close();
+    }
+
+    load_index();
+    // 缓存上限被调小时 淘汰多出的部分
+    evict(0);
+    Serial.printf("[PicCache] %u/%u images cached\n", cache->count, cache->max_entries);
+    return true;
+}
+
+void pic_cache_deinit(void)
+{
+    if (NULL == cache)
+    {
+        return;
+    }
+    if (cache->rec_active)
+    {
+        abort_record();
+    }
+    if (NULL != cache->dma_buf[0])
+    {
+        // 索引仅在初始化成功后才有意义
+        save_index();
+    }
+    // 归还后可能马上被别人写入 需等DMA传输完
+    tft->dmaWait();
+    buf_return(&cache->dma_lease[0], PIC_CACHE_BUF_OWNER);
+    buf_return(&cache->dma_lease[1], PIC_CACHE_BUF_OWNER);
+    free(cache);
+    cache = NULL;
+}
+
+bool pic_cache_enabled(void)
+{
+    return NULL != cache;
+}
+
+bool pic_cache_contains(const char *file_name)
+{
+    uint32_t key;
+    if (NULL == cache || !calc_key(file_name, &key))
+    {
+        return false;
+    }
+    return find_entry(key) >= 0;
+}
+
+bool pic_cache_draw(const char *file_name)
+{
+    uint32_t key;
+    if (NULL == cache || !calc_key(file_name, &key))
+    {
+        return false;
+    }
+    int pos = find_entry(key);
+    if (pos < 0)
+    {
+        return false;
+    }
+
+    char path[32];
+    get_blob_path(key, path);
+    File file = tf.open(path);
+    if (!file || file.size() != PIC_CACHE_BLOB_SIZE)
+    {
+        // 缓存文件损坏或被删除
+        file.close();
+        remove_entry(pos);
+        save_index();
+        return false;
+    }
+
+    // 与RgbPlayDecoder一致 分4个条带交替使用两块DMA缓冲
+    // 读取下一个条带时 上一个条带正在通过DMA发送
+    bool ret = true;
+    uint16_t strip_lines = PIC_CACHE_HEIGHT / 4;
+    tft->startWrite();
+    for (int i = 0; i < 4; ++i)
+    {
+        uint8_t *dst = cache->dma_buf[i % 2];
+        if (file.read(dst, PIC_CACHE_STRIP_SIZE) != PIC_CACHE_STRIP_SIZE)
+        {
+            ret = false;
+            break;
+        }
+        tft->pushImageDMA(0, i * strip_lines, PIC_CACHE_WIDTH, strip_lines,
+                          (uint16_t *)dst, nullptr);
+    }
+    tft->dmaWait();
+    tft->endWrite();
+    file.close();
+
+    if (ret)
+    {
+        cache->entries[pos].stamp = ++cache->stamp;
+    }
+    return ret;
+}
+
+bool pic_cache_begin(const char *file_name)
+{
+    if (NULL == cache || cache->rec_active)
+    {
+        return false;
+    }
+
+    // 只缓存刚好铺满屏幕的图片
+    uint16_t w = 0, h = 0;
+    TJpgDec.getSdJpgSize(&w, &h, file_name);
+    if (PIC_CACHE_WIDTH != w || PIC_CACHE_HEIGHT != h)
+    {
+        return false;
+    }
+
+    uint32_t key;
+    if (!calc_key(file_name, &key) || find_entry(key) >= 0)
+    {
+        return false;
+    }
+
+    evict(1);
+    cache->rec_file = tf.open(PIC_CACHE_TMP_PATH, FILE_WRITE);
+    if (!cache->rec_file)
+    {
+        return false;
+    }
+    cache->rec_key = key;
+    cache->rec_active = true;
+    cache->strip_y = -1;
+    cache->strip_h = 0;
+    cache->next_y = 0;
+    return true;
+}
+
+void pic_cache_write_block(int16_t x, int16_t y, uint16_t w, uint16_t h,
+                           const uint16_t *bitmap)
+{
+    if (NULL == cache || !cache->rec_active)
+    {
+        return;
+    }
+
+    if (x < 0 || x + w > PIC_CACHE_WIDTH || h > PIC_CACHE_STRIP_LINES)
+    {
+        abort_record();
+        return;
+    }
+
+    if (y != cache->strip_y)
+    {
+        // TJpgDec按MCU行的顺序输出 换行时把上一行写入文件
+        if (cache->strip_y >= 0)
+        {
+            flush_strip();
+            if (!cache->rec_active)
+            {
+                return;
+            }
+        }
+        if (y != cache->next_y)
+        {
+            abort_record();
+            return;
+        }
+        cache->strip_y = y;
+        cache->strip_h = h;
+    }
+    else if (h != cache->strip_h)
+    {
+        abort_record();
+        return;
+    }
+
+    for (uint16_t row = 0; row < h; ++row)
+    {
+        memcpy(&cache->strip[row * PIC_CACHE_WIDTH + x], bitmap + row * w, w * 2);
+    }
+}
+
+void pic_cache_end(bool success)
+{
+    if (NULL == cache || !cache->rec_active)
+    {
+        return;
+    }
+
+    if (success && cache->strip_y >= 0)
+    {
+        flush_strip();
+        if (!cache->rec_active)
+        {
+            return;
+        }
+    }
+
+    size_t size = cache->rec_file.size();
+    cache->rec_file.close();
+    cache->rec_active = false;
+    if (!success || PIC_CACHE_HEIGHT != cache->next_y || PIC_CACHE_BLOB_SIZE != size)
+    {
+        tf.deleteFile(PIC_CACHE_TMP_PATH);
+        return;
+    }
+
+    char path[32];
+    get_blob_path(cache->rec_key, path);
+    tf.deleteFile(path); // 清理可能残留的旧文件 否则重命名会失败
+    tf.renameFile(PIC_CACHE_TMP_PATH, path);
+
+    cache->entries[cache->count].key = cache->rec_key;
+    cache->entries[cache->count].stamp = ++cache->stamp;
+    ++cache->count;
+    save_index();
+}
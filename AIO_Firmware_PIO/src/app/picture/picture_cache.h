@@ -0,0 +1,39 @@
+#ifndef APP_PICTURE_CACHE_H
+#define APP_PICTURE_CACHE_H
+
+#include <Arduino.h>
+
+// jpg解码结果（240*240 RGB565）在SD卡上的缓存目录
+#define PIC_CACHE_PATH "/pic_cache"
+#define PIC_CACHE_INDEX_PATH PIC_CACHE_PATH "/index.bin"
+#define PIC_CACHE_MAX_ENTRIES 256 // 缓存索引的最大条目数
+#define PIC_CACHE_WIDTH 240
+#define PIC_CACHE_HEIGHT 240
+#define PIC_CACHE_BLOB_SIZE (PIC_CACHE_WIDTH * PIC_CACHE_HEIGHT * 2)
+#define PIC_CACHE_STRIP_SIZE (PIC_CACHE_BLOB_SIZE / 4) // 分4次DMA推送
+
+// 初始化缓存 max_size_mb为缓存上限（MB） 0表示关闭缓存
+bool pic_cache_init(uint32_t max_size_mb);
+
+// 释放缓存占用的内存 并保存索引
+void pic_cache_deinit(void);
+
+bool pic_cache_enabled(void);
+
+// 命中缓存时直接将图片推送到屏幕 返回true
+bool pic_cache_draw(const char *file_name);
+
+// 判断图片是否已经被缓存
+bool pic_cache_contains(const char *file_name);
+
+// 开始记录一次jpg解码的输出 图片尺寸不符或已缓存时返回false
+bool pic_cache_begin(const char *file_name);
+
+// 在TJpgDec的回调中调用 记录解码出的图块
+void pic_cache_write_block(int16_t x, int16_t y, uint16_t w, uint16_t h,
+                           const uint16_t *bitmap);
+
+// 结束记录 success为false时丢弃本次结果
+void pic_cache_end(bool success);
+
+#endif
@@ -0,0 +1,485 @@
+#include "picture_prefetch.h"
+#include "picture_gui.h"
+#include "picture_cache.h"
+#include "common.h"
+
+#include <TJpg_Decoder.h>
+
+#define PIC_PREFETCH_STRIP_NUM (SCREEN_VER_RES / PIC_PREFETCH_STRIP_LINES)
+#define PIC_PREFETCH_STRIP_SIZE (SCREEN_HOR_RES * PIC_PREFETCH_STRIP_LINES * 2)
+#define PIC_PREFETCH_RETRY_MS 1000 // 内存不足时的重试间隔
+#define PIC_PREFETCH_SPARE_MAX (PIC_PREFETCH_SLOT_NUM * PIC_PREFETCH_STRIP_NUM)
+
+struct PicPrefetchSlot
+{
+    File_Info *file;                        // 对应的文件节点 NULL表示空闲
+    uint8_t *jpg_buf;                       // 文件内容（解码成功后释放）
+    uint32_t jpg_size;
+    uint8_t *frame[PIC_PREFETCH_STRIP_NUM]; // 解码后的画面 已按屏幕字节序排列
+};
+
+struct PicPrefetchData
+{
+    const char *dir_name;
+    TaskHandle_t task;
+    SemaphoreHandle_t slot_mutex; // 保护slots和want
+    SemaphoreHandle_t done_sem;   // 任务退出的信号
+    volatile bool stop;
+    File_Info *want[PIC_PREFETCH_SLOT_NUM]; // 需要预取的文件 按优先级排列
+    PicPrefetchSlot slots[PIC_PREFETCH_SLOT_NUM];
+    File_Info *warm_head;  // 需要预热缓存的文件链表 NULL表示前台没有空闲
+    File_Info *warm_file;  // 缓存预热的进度
+    bool warm_done;        // 是否已经预热完一轮
+};
+
+static PicPrefetchData *prefetch = NULL;
+static SemaphoreHandle_t jpg_mutex = NULL; // TJpgDec的锁
+static uint8_t **decode_frame = NULL;      // 当前解码的目标画面（持有jpg_mutex时有效）
+
+// 画面条带不从buf_pool租借: 两张预解码的画面共8条（约230KB）远超缓冲池
+// 缓冲池中的STRIP在图片APP运行时由picture_cache占用 预取只在内存充足时进行
+// 为了不在每次切换图片时反复申请释放大块内存 用完的条带留在这里供下一张使用 APP退出时才释放
+static uint8_t *spare_strips[PIC_PREFETCH_SPARE_MAX];
+static int spare_num = 0;
+static portMUX_TYPE spare_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static bool is_jpg_name(const char *file_name)
+{
+    return NULL != strstr(file_name, ".jpg") || NULL != strstr(file_name, ".JPG") || NULL != strstr(file_name, ".JEPG") || NULL != strstr(file_name, ".jpeg");
+}
+
+// 按当前的最大空闲块判断能否再申请size字节
+static bool heap_allow(uint32_t size)
+{
+    uint32_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    return largest > PIC_PREFETCH_HEAP_RESERVE && size <= largest - PIC_PREFETCH_HEAP_RESERVE;
+}
+
+// 优先复用留下的条带 没有时再从堆中申请
+static uint8_t *take_strip(void)
+{
+    uint8_t *strip = NULL;
+    portENTER_CRITICAL(&spare_mux);
+    if (spare_num > 0)
+    {
+        strip = spare_strips[--spare_num];
+    }
+    portEXIT_CRITICAL(&spare_mux);
+    if (NULL == strip && heap_allow(PIC_PREFETCH_STRIP_SIZE))
+    {
+        strip = (uint8_t *)malloc(PIC_PREFETCH_STRIP_SIZE);
+    }
+    return strip;
+}
+
+static void put_strip(uint8_t *strip)
+{
+    if (NULL == strip)
+    {
+        return;
+    }
+    portENTER_CRITICAL(&spare_mux);
+    bool kept = spare_num < PIC_PREFETCH_SPARE_MAX;
+    if (kept)
+    {
+        spare_strips[spare_num++] = strip;
+    }
+    portEXIT_CRITICAL(&spare_mux);
+    if (!kept)
+    {
+        free(strip);
+    }
+}
+
+static void free_spare_strips(void)
+{
+    for (int i = 0; i < spare_num; ++i)
+    {
+        free(spare_strips[i]);
+        spare_strips[i] = NULL;
+    }
+    spare_num = 0;
+}
+
+static void free_frame(PicPrefetchSlot *slot)
+{
+    for (int i = 0; i < PIC_PREFETCH_STRIP_NUM; ++i)
+    {
+        put_strip(slot->frame[i]);
+        slot->frame[i] = NULL;
+    }
+}
+
+static void free_slot_data(PicPrefetchSlot *slot)
+{
+    free(slot->jpg_buf);
+    free_frame(slot);
+    memset(slot, 0, sizeof(PicPrefetchSlot));
+}
+
+static bool frame_output(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t *bitmap)
+{
+    if (y >= SCREEN_VER_RES)
+        return 0;
+
+    for (uint16_t row = 0; row < h && y + row < SCREEN_VER_RES; ++row)
+    {
+        int16_t dy = y + row;
+        uint16_t *dst = (uint16_t *)decode_frame[dy / PIC_PREFETCH_STRIP_LINES] +
+                        (dy % PIC_PREFETCH_STRIP_LINES) * SCREEN_HOR_RES + x;
+        const uint16_t *src = bitmap + row * w;
+        for (uint16_t col = 0; col < w && x + col < SCREEN_HOR_RES; ++col)
+        {
+            // 预先交换字节序 推送时无需再修改缓冲区，画面可以重复使用
+            dst[col] = src[col] << 8 | src[col] >> 8;
+        }
+    }
+    return 1;
+}
+
+// 把jpg解码到画面缓冲 内存不足或尺寸不符时返回false
+static bool decode_to_frame(PicPrefetchSlot *slot)
+{
+    uint16_t w = 0, h = 0;
+    pic_prefetch_lock();
+    TJpgDec.getJpgSize(&w, &h, slot->jpg_buf, slot->jpg_size);
+    pic_prefetch_unlock();
+    if (SCREEN_HOR_RES != w || SCREEN_VER_RES != h)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < PIC_PREFETCH_STRIP_NUM; ++i)
+    {
+        if (NULL == (slot->frame[i] = take_strip()))
+        {
+            // 已经拿到的条带留给下一次
+            free_frame(slot);
+            return false;
+        }
+    }
+
+    pic_prefetch_lock();
+    decode_frame = slot->frame;
+    TJpgDec.setCallback(frame_output);
+    JRESULT ret = TJpgDec.drawJpg(0, 0, slot->jpg_buf, slot->jpg_size);
+    decode_frame = NULL;
+    pic_prefetch_unlock();
+
+    if (JDR_OK != ret)
+    {
+        free_frame(slot);
+        return false;
+    }
+    free(slot->jpg_buf);
+    slot->jpg_buf = NULL;
+    return true;
+}
+
+static bool warm_output(int16_t x, int16_t y, uint16_t w, uint16_t h, uint16_t *bitmap)
+{
+    if (y >= PIC_CACHE_HEIGHT)
+        return 0;
+
+    pic_cache_write_block(x, y, w, h, bitmap);
+    return 1;
+}
+
+// 把一张还没有缓存的图片解码到缓存中 每次只处理一张 之间可以处理预取
+static void warm_up_step(File_Info *head)
+{
+    File_Info *start = head->next_node;
+    File_Info *pfile = NULL == prefetch->warm_file ? start : prefetch->warm_file;
+    prefetch->warm_file = pfile->next_node;
+    prefetch->warm_done = prefetch->warm_file == start;
+
+    if (FILE_TYPE_FILE != pfile->file_type || !is_jpg_name(pfile->file_name))
+    {
+        return;
+    }
+    char file_name[PIC_FILENAME_MAX_LEN] = {0};
+    snprintf(file_name, PIC_FILENAME_MAX_LEN, "%s/%s",
+             prefetch->dir_name, pfile->file_name);
+
+    // 缓存的记录状态与TJpgDec一样只有一份 整个过程持有解码锁
+    pic_prefetch_lock();
+    if (pic_cache_begin(file_name))
+    {
+        TJpgDec.setCallback(warm_output);
+        JRESULT ret = TJpgDec.drawSdJpg(0, 0, file_name);
+        pic_cache_end(JDR_OK == ret);
+    }
+    pic_prefetch_unlock();
+}
+
+// 读取并解码一张图片 结果放在slot中
+static bool prefetch_file(File_Info *file, PicPrefetchSlot *slot)
+{
+    char file_name[PIC_FILENAME_MAX_LEN] = {0};
+    snprintf(file_name, PIC_FILENAME_MAX_LEN, "%s/%s",
+             prefetch->dir_name, file->file_name);
+
+    File jpg_file = tf.open(file_name);
+    if (!jpg_file)
+    {
+        return false;
+    }
+    // jpg大小不定 也不从buf_pool租借 读入后解码成功即释放
+    uint32_t size = jpg_file.size();
+    if (0 == size || !heap_allow(size) ||
+        NULL == (slot->jpg_buf = (uint8_t *)malloc(size)))
+    {
+        jpg_file.close();
+        return false;
+    }
+    slot->jpg_size = jpg_file.read(slot->jpg_buf, size);
+    jpg_file.close();
+    if (slot->jpg_size != size)
+    {
+        free_slot_data(slot);
+        return false;
+    }
+
+    decode_to_frame(slot);
+    slot->file = file;
+    return true;
+}
+
+static bool slot_exist(File_Info *file)
+{
+    for (int i = 0; i < PIC_PREFETCH_SLOT_NUM; ++i)
+    {
+        if (file == prefetch->slots[i].file)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void TaskPicPrefetch(void *parameter)
+{
+    while (!prefetch->stop)
+    {
+        ulTaskNotifyTake(pdTRUE, PIC_PREFETCH_RETRY_MS / portTICK_PERIOD_MS);
+
+        for (int pos = 0; pos < PIC_PREFETCH_SLOT_NUM && !prefetch->stop; ++pos)
+        {
+            xSemaphoreTake(prefetch->slot_mutex, portMAX_DELAY);
+            File_Info *target = prefetch->want[pos];
+            bool skip = NULL == target || slot_exist(target) ||
+                        !is_jpg_name(target->file_name);
+            xSemaphoreGive(prefetch->slot_mutex);
+            if (skip)
+            {
+                continue;
+            }
+
+            PicPrefetchSlot slot;
+            memset(&slot, 0, sizeof(PicPrefetchSlot));
+            if (!prefetch_file(target, &slot))
+            {
+                continue;
+            }
+
+            // 期间前台可能已经切换了图片 只保留仍然需要的结果
+            bool attached = false;
+            xSemaphoreTake(prefetch->slot_mutex, portMAX_DELAY);
+            if (target == prefetch->want[0] || target == prefetch->want[1])
+            {
+                for (int i = 0; i < PIC_PREFETCH_SLOT_NUM; ++i)
+                {
+                    if (NULL == prefetch->slots[i].file)
+                    {
+                        prefetch->slots[i] = slot;
+                        attached = true;
+                        break;
+                    }
+                }
+            }
+            xSemaphoreGive(prefetch->slot_mutex);
+            if (!attached)
+            {
+                free_slot_data(&slot);
+            }
+        }
+
+        // 预取之后 前台空闲时再预热缓存
+        xSemaphoreTake(prefetch->slot_mutex, portMAX_DELAY);
+        File_Info *warm_head = prefetch->warm_head;
+        prefetch->warm_head = NULL;
+        xSemaphoreGive(prefetch->slot_mutex);
+        if (NULL != warm_head && !prefetch->stop && !prefetch->warm_done && pic_cache_enabled())
+        {
+            warm_up_step(warm_head);
+        }
+    }
+
+    xSemaphoreGive(prefetch->done_sem);
+    vTaskDelete(NULL);
+}
+
+bool pic_prefetch_start(const char *dir_name)
+{
+    if (NULL == jpg_mutex)
+    {
+        jpg_mutex = xSemaphoreCreateMutex();
+    }
+    if (NULL != prefetch)
+    {
+        return true;
+    }
+
+    prefetch = (PicPrefetchData *)calloc(1, sizeof(PicPrefetchData));
+    if (NULL == prefetch)
+    {
+        return false;
+    }
+    prefetch->dir_name = dir_name;
+    prefetch->slot_mutex = xSemaphoreCreateMutex();
+    prefetch->done_sem = xSemaphoreCreateBinary();
+
+    // loop()运行在核1 预取放到核0上
+    BaseType_t ret = xTaskCreatePinnedToCore(TaskPicPrefetch, "PicPrefetch",
+                                             6 * 1024, NULL, 1,
+                                             &prefetch->task, 0);
+    if (pdPASS != ret)
+    {
+        vSemaphoreDelete(prefetch->slot_mutex);
+        vSemaphoreDelete(prefetch->done_sem);
+        free(prefetch);
+        prefetch = NULL;
+        return false;
+    }
+    return true;
+}
+
+void pic_prefetch_stop(void)
+{
+    if (NULL == prefetch)
+    {
+        return;
+    }
+    prefetch->stop = true;
+    xTaskNotifyGive(prefetch->task);
+    xSemaphoreTake(prefetch->done_sem, portMAX_DELAY);
+
+    for (int i = 0; i < PIC_PREFETCH_SLOT_NUM; ++i)
+    {
+        free_slot_data(&prefetch->slots[i]);
+    }
+    free_spare_strips();
+    vSemaphoreDelete(prefetch->slot_mutex);
+    vSemaphoreDelete(prefetch->done_sem);
+    free(prefetch);
+    prefetch = NULL;
+}
+
+void pic_prefetch_update(File_Info *ahead, File_Info *behind)
+{
+    if (NULL == prefetch)
+    {
+        return;
+    }
+
+    xSemaphoreTake(prefetch->slot_mutex, portMAX_DELAY);
+    prefetch->want[0] = ahead;
+    prefetch->want[1] = behind;
+    for (int i = 0; i < PIC_PREFETCH_SLOT_NUM; ++i)
+    {
+        PicPrefetchSlot *slot = &prefetch->slots[i];
+        if (NULL != slot->file && ahead != slot->file && behind != slot->file)
+        {
+            free_slot_data(slot);
+        }
+    }
+    xSemaphoreGive(prefetch->slot_mutex);
+    xTaskNotifyGive(prefetch->task);
+}
+
+void pic_prefetch_warm_up(File_Info *head)
+{
+    if (NULL == prefetch || NULL == head || prefetch->warm_done)
+    {
+        return;
+    }
+    xSemaphoreTake(prefetch->slot_mutex, portMAX_DELAY);
+    prefetch->warm_head = head;
+    xSemaphoreGive(prefetch->slot_mutex);
+    xTaskNotifyGive(prefetch->task);
+}
+
+static PicPrefetchSlot *find_slot(File_Info *file)
+{
+    PicPrefetchSlot *ret = NULL;
+    xSemaphoreTake(prefetch->slot_mutex, portMAX_DELAY);
+    for (int i = 0; i < PIC_PREFETCH_SLOT_NUM; ++i)
+    {
+        if (file == prefetch->slots[i].file)
+        {
+            ret = &prefetch->slots[i];
+            break;
+        }
+    }
+    xSemaphoreGive(prefetch->slot_mutex);
+    // 预取数据只会在前台调用pic_prefetch_update时释放 这里无需继续持锁
+    return ret;
+}
+
+bool pic_prefetch_draw(File_Info *file)
+{
+    if (NULL == prefetch)
+    {
+        return false;
+    }
+    PicPrefetchSlot *slot = find_slot(file);
+    if (NULL == slot || NULL == slot->frame[0])
+    {
+        return false;
+    }
+
+    bool swap_status = tft->getSwapBytes();
+    tft->setSwapBytes(false);
+    tft->startWrite();
+    for (int i = 0; i < PIC_PREFETCH_STRIP_NUM; ++i)
+    {
+        tft->pushImage(0, i * PIC_PREFETCH_STRIP_LINES,
+                       SCREEN_HOR_RES, PIC_PREFETCH_STRIP_LINES,
+                       (uint16_t *)slot->frame[i]);
+    }
+    tft->endWrite();
+    tft->setSwapBytes(swap_status);
+    return true;
+}
+
+bool pic_prefetch_get_jpg(File_Info *file, const uint8_t **buf, uint32_t *size)
+{
+    if (NULL == prefetch)
+    {
+        return false;
+    }
+    PicPrefetchSlot *slot = find_slot(file);
+    if (NULL == slot || NULL == slot->jpg_buf)
+    {
+        return false;
+    }
+    *buf = slot->jpg_buf;
+    *size = slot->jpg_size;
+    return true;
+}
+
+void pic_prefetch_lock(void)
+{
+    if (NULL != jpg_mutex)
+    {
+        xSemaphoreTake(jpg_mutex, portMAX_DELAY);
+    }
+}
+
+void pic_prefetch_unlock(void)
+{
+    if (NULL != jpg_mutex)
+    {
+        xSemaphoreGive(jpg_mutex);
+    }
+}
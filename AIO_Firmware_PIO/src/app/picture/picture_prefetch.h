@@ -0,0 +1,32 @@
+#ifndef APP_PICTURE_PREFETCH_H
+#define APP_PICTURE_PREFETCH_H
+
+#include "driver/sd_card.h"
+
+#define PIC_PREFETCH_SLOT_NUM 2               // 同时预取的图片数（前后各一张）
+#define PIC_PREFETCH_HEAP_RESERVE (48 * 1024) // 预取时至少给系统保留的内存
+#define PIC_PREFETCH_STRIP_LINES 60           // 解码画面按条带分块保存 避免需要连续的大内存
+
+// 启动预取任务（运行在另一个核上） dir_name为图片所在文件夹
+bool pic_prefetch_start(const char *dir_name);
+
+// 停止预取任务并释放所有预取数据
+void pic_prefetch_stop(void);
+
+// 更新需要预取的图片 ahead为当前方向的下一张 behind为反方向的下一张
+void pic_prefetch_update(File_Info *ahead, File_Info *behind);
+
+// 前台空闲时调用 由预取任务把head链表中的一张图片解码到缓存（每次调用最多一张）
+void pic_prefetch_warm_up(File_Info *head);
+
+// 如果file已经被预解码 直接将画面推送到屏幕 返回true
+bool pic_prefetch_draw(File_Info *file);
+
+// 获取已读入内存的jpg数据 数据在下一次pic_prefetch_update之前有效
+bool pic_prefetch_get_jpg(File_Info *file, const uint8_t **buf, uint32_t *size);
+
+// TJpgDec为全局对象 前台解码前后需要加锁
+void pic_prefetch_lock(void);
+void pic_prefetch_unlock(void);
+
+#endif
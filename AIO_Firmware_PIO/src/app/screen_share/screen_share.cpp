@@ -1,14 +1,16 @@
+#define LOG_TAG "screen"
 #include "screen_share.h"
 #include "screen_share_gui.h"
 #include "common.h"
+#include "sys/logger.h"
+#include "sys/buf_pool.h"
 #include <TJpg_Decoder.h>
 #include "sys/app_controller.h"
 
 #define SCREEN_SHARE_APP_NAME "Screen share"
 
 #define JPEG_BUFFER_SIZE 1       // 10000 // 储存一张jpeg的图像(240*240 10000大概够了，正常一帧差不多3000)
-#define RECV_BUFFER_SIZE 50000   // 理论上是 JPEG_BUFFER_SIZE 的两倍就够了
-#define DMA_BUFFER_SIZE 512      // (16*16*2)
+#define RECV_BUFFER_SIZE 50000   // 理论上是 JPEG_BUFFER_SIZE 的两倍就够了（不超过BUF_FRAME_SIZE）
 #define SHARE_WIFI_ALIVE 20000UL // 维持wifi心跳的时间（20s）
 
 #define HTTP_PORT 8081 // 设置监听端口
@@ -16,43 +18,31 @@ WiFiServer ss_server;  // 服务端 ss = screen_share
 WiFiClient ss_client;  // 客户端 ss = screen_share
 
 // 天气的持久化配置
+#define SCREEN_SHARE_CONFIG_NS "screen_share"
 #define SCREEN_SHARE_CONFIG_PATH "/screen_share.cfg"
 struct SS_Config
 {
     uint8_t powerFlag; // 功耗控制（0低发热 1性能优先）
 };
 
+static const char *const screen_share_cfg_keys[] = {"powerFlag"};
+
 static void write_config(SS_Config *cfg)
 {
-    char tmp[16];
-    // 将配置数据保存在文件中（持久化）
-    String w_data;
-    memset(tmp, 0, 16);
-    snprintf(tmp, 16, "%u\n", cfg->powerFlag);
-    w_data += tmp;
-    g_flashCfg.writeFile(SCREEN_SHARE_CONFIG_PATH, w_data.c_str());
+    // 将配置数据保存在配置存储中（持久化）
+    g_cfgStore.setUInt(SCREEN_SHARE_CONFIG_NS, "powerFlag", cfg->powerFlag);
+    g_cfgStore.commit();
 }
 
 static void read_config(SS_Config *cfg)
 {
-    // 如果有需要持久化配置文件 可以调用此函数将数据存在flash中
-    // 配置文件名最好以APP名为开头 以".cfg"结尾，以免多个APP读取混乱
-    char info[128] = {0};
-    uint16_t size = g_flashCfg.readFile(SCREEN_SHARE_CONFIG_PATH, (uint8_t *)info);
-    info[size] = 0;
-    if (size == 0)
+    bool exist = g_cfgStore.migrate(SCREEN_SHARE_CONFIG_NS, SCREEN_SHARE_CONFIG_PATH, screen_share_cfg_keys);
+    // 默认值
+    cfg->powerFlag = g_cfgStore.getUInt(SCREEN_SHARE_CONFIG_NS, "powerFlag", 0); // 功耗控制（0低发热 1性能优先）
+    if (!exist)
     {
-        // 默认值
-        cfg->powerFlag = 0; // 功耗控制（0低发热 1性能优先）
         write_config(cfg);
     }
-    else
-    {
-        // 解析数据
-        char *param[1] = {0};
-        analyseParam(info, 1, param);
-        cfg->powerFlag = atol(param[0]);
-    }
 }
 
 struct ScreenShareAppRunData
@@ -68,6 +58,8 @@ struct ScreenShareAppRunData
     uint8_t *last_find_pos;        // 上回查找到的位置
     int32_t bufSaveTail;           // 指向 recvBuf 中所保存的最后一个数据所在下标
     uint8_t *displayBufWithDma[2]; // 用于FDMA的两个缓冲区
+    BufLease recvLease;            // recvBuf从缓冲池中租借
+    BufLease dmaLease[2];          // displayBufWithDma从缓冲池中租借
     bool dmaBufferSel;             // dma的缓冲区切换标志
     boolean tftSwapStatus;
 
@@ -151,35 +143,30 @@ static int screen_share_init(AppController *sys)
     // 获取配置信息
     read_config(&cfg_data);
 
-    if (0 == cfg_data.powerFlag)
-    {
-        // 设置CPU主频
-        setCpuFrequencyMhz(160);
-    }
-    else
-    {
-        setCpuFrequencyMhz(240);
-    }
+    // 设置CPU主频（低发热模式限制为中速档）
+    cpu_governor_request(SCREEN_SHARE_APP_NAME,
+                         0 == cfg_data.powerFlag ? PERF_LEVEL_MID : PERF_LEVEL_HIGH, false);
 
     // 调整RGB模式  HSV色彩模式
-    RgbParam rgb_setting = {LED_MODE_HSV, 0, 128, 32,
-                            255, 255, 32,
-                            1, 1, 1,
-                            150, 250, 1, 30};
-    set_rgb_and_run(&rgb_setting);
+    static const RgbParam rgb_setting = {LED_MODE_HSV, 0, 128, 32,
+                                         255, 255, 32,
+                                         1, 1, 1,
+                                         150, 250, 1, 30};
+    rgb_effect_register(SCREEN_SHARE_APP_NAME, &rgb_setting);
+    rgb_effect_run(SCREEN_SHARE_APP_NAME);
 
     screen_share_gui_init();
     // 初始化运行时参数
     run_data = (ScreenShareAppRunData *)calloc(1, sizeof(ScreenShareAppRunData));
     run_data->tcp_start = 0;
     run_data->req_sent = 0;
-    run_data->recvBuf = (uint8_t *)malloc(RECV_BUFFER_SIZE);
+    run_data->recvBuf = buf_lease(&run_data->recvLease, BUF_FRAME, SCREEN_SHARE_APP_NAME);
     run_data->mjpeg_start = NULL;
     run_data->mjpeg_end = NULL;
     run_data->last_find_pos = run_data->recvBuf;
     run_data->bufSaveTail = 0;
-    run_data->displayBufWithDma[0] = (uint8_t *)heap_caps_malloc(DMA_BUFFER_SIZE, MALLOC_CAP_DMA);
-    run_data->displayBufWithDma[1] = (uint8_t *)heap_caps_malloc(DMA_BUFFER_SIZE, MALLOC_CAP_DMA);
+    run_data->displayBufWithDma[0] = buf_lease(&run_data->dmaLease[0], BUF_DMA_SMALL, SCREEN_SHARE_APP_NAME);
+    run_data->displayBufWithDma[1] = buf_lease(&run_data->dmaLease[1], BUF_DMA_SMALL, SCREEN_SHARE_APP_NAME);
     run_data->dmaBufferSel = false;
     run_data->pre_wifi_alive_millis = 0;
 
@@ -264,15 +251,16 @@ static void screen_share_process(AppController *sys,
                     tft->startWrite();     // 必须先使用startWrite，以便TFT芯片选择保持低的DMA和SPI通道设置保持配置
                     uint32_t frame_size = run_data->mjpeg_end - run_data->mjpeg_start + 1;
                     // 在左上角的0,0处绘制图像——在这个草图中，DMA请求在回调tft_output()中处理
+                    METRIC_TIME_START(decode_start);
                     JRESULT jpg_ret = TJpgDec.drawJpg(0, 0, run_data->mjpeg_start, frame_size);
                     tft->endWrite(); // 必须使用endWrite来释放TFT芯片选择和释放SPI通道吗
+                    METRIC_TIME_END_MS(METRIC_SCREEN_DECODE_MS, decode_start);
+                    METRIC_INC(JDR_OK == jpg_ret ? METRIC_FRAMES_RENDERED : METRIC_FRAMES_DROPPED);
                     // 剩余帧大小
                     uint32_t left_frame_size = &run_data->recvBuf[run_data->bufSaveTail] - run_data->mjpeg_end;
                     memcpy(run_data->recvBuf, run_data->mjpeg_end + 1, left_frame_size);
-                    Serial.printf("帧大小：%d ", frame_size);
-                    Serial.print("MCU处理速度：");
-                    Serial.print(1000.0 / (GET_SYS_MILLIS() - deal_time), 2);
-                    Serial.print("Fps\n");
+                    LOGD("帧大小：%u MCU处理速度：%.2fFps", frame_size,
+                         1000.0 / (GET_SYS_MILLIS() - deal_time));
 
                     run_data->last_find_pos = run_data->recvBuf;
                     run_data->bufSaveTail = 0;
@@ -282,6 +270,7 @@ static void screen_share_process(AppController *sys,
                 }
                 else if (run_data->bufSaveTail > RECV_BUFFER_SIZE)
                 {
+                    METRIC_INC(METRIC_FRAMES_DROPPED);
                     run_data->last_find_pos = run_data->recvBuf;
                     run_data->bufSaveTail = 0;
                     // 数据清零
@@ -337,31 +326,27 @@ static int screen_exit_callback(void *param)
     screen_share_gui_del();
     if (NULL != run_data->recvBuf)
     {
-        free(run_data->recvBuf);
+        buf_return(&run_data->recvLease, SCREEN_SHARE_APP_NAME);
         run_data->recvBuf = NULL;
     }
 
+    // 归还后可能马上被别人写入 需等DMA传输完
+    tft->dmaWait();
     if (NULL != run_data->displayBufWithDma[0])
     {
-        free(run_data->displayBufWithDma[0]);
+        buf_return(&run_data->dmaLease[0], SCREEN_SHARE_APP_NAME);
         run_data->displayBufWithDma[0] = NULL;
     }
     if (NULL != run_data->displayBufWithDma[1])
     {
-        free(run_data->displayBufWithDma[1]);
+        buf_return(&run_data->dmaLease[1], SCREEN_SHARE_APP_NAME);
         run_data->displayBufWithDma[1] = NULL;
     }
 
     // 恢复此前的驱动参数
     tft->setSwapBytes(run_data->tftSwapStatus);
 
-    // 恢复RGB灯  HSV色彩模式
-    RgbParam rgb_setting = {LED_MODE_HSV,
-                            1, 32, 255,
-                            255, 255, 255,
-                            1, 1, 1,
-                            150, 250, 1, 30};
-    set_rgb_and_run(&rgb_setting);
+    // RGB灯由app_controller在退出后恢复为系统灯效
 
     // 释放运行数据
     if (NULL != run_data)
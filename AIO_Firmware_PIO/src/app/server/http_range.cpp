@@ -0,0 +1,204 @@
+#include "http_range.h"
+#include <string.h>
+#include <ctype.h>
+#include <stdio.h>
+
+// 读取一个非负整数 没有数字时返回false
+static bool parse_number(const char **str, uint32_t *value)
+{
+    const char *p = *str;
+    if (!isdigit((unsigned char)*p))
+    {
+        return false;
+    }
+    uint64_t num = 0;
+    while (isdigit((unsigned char)*p))
+    {
+        num = num * 10 + (*p - '0');
+        if (num > 0xFFFFFFFFULL)
+        {
+            num = 0xFFFFFFFFULL; // 溢出时按最大值处理 后面会判定为超出范围
+        }
+        ++p;
+    }
+    *value = (uint32_t)num;
+    *str = p;
+    return true;
+}
+
+HTTP_RANGE_RESULT http_parse_range(const char *header, uint32_t size,
+                                   uint32_t *start, uint32_t *end)
+{
+    if (NULL == header || 0 != strncmp(header, "bytes=", 6))
+    {
+        return HTTP_RANGE_NONE;
+    }
+    const char *p = header + 6;
+    while (' ' == *p)
+    {
+        ++p;
+    }
+    // 多段请求直接返回完整内容（RFC 7233允许忽略Range）
+    if (NULL != strchr(p, ','))
+    {
+        return HTTP_RANGE_NONE;
+    }
+
+    uint32_t first = 0;
+    uint32_t last = 0;
+    bool has_first = parse_number(&p, &first);
+    if ('-' != *p)
+    {
+        return HTTP_RANGE_NONE;
+    }
+    ++p;
+    bool has_last = parse_number(&p, &last);
+    while (' ' == *p)
+    {
+        ++p;
+    }
+    if ('\0' != *p || (!has_first && !has_last))
+    {
+        return HTTP_RANGE_NONE;
+    }
+
+    if (!has_first)
+    {
+        // "bytes=-n" 最后n个字节
+        if (0 == last || 0 == size)
+        {
+            return HTTP_RANGE_INVALID;
+        }
+        *start = last >= size ? 0 : size - last;
+        *end = size - 1;
+        return HTTP_RANGE_OK;
+    }
+
+    if (has_last && last < first)
+    {
+        return HTTP_RANGE_NONE;
+    }
+    if (first >= size)
+    {
+        return HTTP_RANGE_INVALID;
+    }
+    *start = first;
+    *end = (!has_last || last >= size) ? size - 1 : last;
+    return HTTP_RANGE_OK;
+}
+
+static const char *const month_names[12] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                            "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+void http_format_date(time_t time, char *buf, size_t len)
+{
+    struct tm tm_time;
+    gmtime_r(&time, &tm_time);
+    strftime(buf, len, "%a, %d %b %Y %H:%M:%S GMT", &tm_time);
+}
+
+// 1970-01-01到y-m-d的天数（公历）
+static int32_t days_from_civil(int32_t y, int32_t m, int32_t d)
+{
+    y -= m <= 2;
+    int32_t era = y / 400;
+    int32_t yoe = y - era * 400;
+    int32_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+bool http_parse_date(const char *date, time_t *time)
+{
+    if (NULL == date)
+    {
+        return false;
+    }
+    const char *p = strchr(date, ',');
+    if (NULL == p)
+    {
+        return false;
+    }
+    ++p;
+
+    int day, year, hour, minute, second;
+    char month[4] = {0};
+    char zone[4] = {0};
+    if (7 != sscanf(p, " %2d %3s %4d %2d:%2d:%2d %3s",
+                    &day, month, &year, &hour, &minute, &second, zone) ||
+        0 != strcmp(zone, "GMT"))
+    {
+        return false;
+    }
+    int mon = 0;
+    while (mon < 12 && 0 != strcmp(month, month_names[mon]))
+    {
+        ++mon;
+    }
+    if (12 == mon || year < 1970 || day < 1 || day > 31 ||
+        hour > 23 || minute > 59 || second > 60)
+    {
+        return false;
+    }
+    *time = (time_t)days_from_civil(year, mon + 1, day) * 86400 +
+            hour * 3600 + minute * 60 + second;
+    return true;
+}
+
+void http_download_plan(const char *range, const char *if_modified_since,
+                        uint32_t size, time_t last_write, HttpDownloadPlan *plan)
+{
+    memset(plan, 0, sizeof(HttpDownloadPlan));
+    if (last_write > 0)
+    {
+        http_format_date(last_write, plan->last_modified, sizeof(plan->last_modified));
+
+        // 日期只精确到秒
+        time_t since = 0;
+        if (http_parse_date(if_modified_since, &since) && last_write <= since)
+        {
+            plan->code = 304;
+            return;
+        }
+    }
+
+    uint32_t start = 0;
+    uint32_t end = size > 0 ? size - 1 : 0;
+    switch (http_parse_range(range, size, &start, &end))
+    {
+    case HTTP_RANGE_OK:
+        plan->code = 206;
+        plan->start = start;
+        plan->len = end - start + 1;
+        snprintf(plan->content_range, sizeof(plan->content_range),
+                 "bytes %u-%u/%u", (unsigned)start, (unsigned)end, (unsigned)size);
+        break;
+    case HTTP_RANGE_INVALID:
+        plan->code = 416;
+        snprintf(plan->content_range, sizeof(plan->content_range),
+                 "bytes */%u", (unsigned)size);
+        break;
+    default:
+        plan->code = 200;
+        plan->len = size;
+        break;
+    }
+}
+
+uint32_t http_copy_body(HttpReadFn read, void *read_ctx,
+                        HttpWriteFn write, void *write_ctx,
+                        uint8_t *buf, uint32_t buf_size, uint32_t len)
+{
+    uint32_t sent = 0;
+    while (sent < len)
+    {
+        uint32_t want = len - sent < buf_size ? len - sent : buf_size;
+        size_t num = read(read_ctx, buf, want);
+        if (0 == num || write(write_ctx, buf, num) != num)
+        {
+            break;
+        }
+        sent += num;
+    }
+    return sent;
+}
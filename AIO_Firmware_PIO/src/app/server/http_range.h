@@ -0,0 +1,51 @@
+#ifndef HTTP_RANGE_H
+#define HTTP_RANGE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+
+// 不依赖Arduino 可以直接在PC上编译验证
+
+enum HTTP_RANGE_RESULT
+{
+    HTTP_RANGE_NONE = 0, // 没有Range或不支持的形式（多段） 返回完整内容
+    HTTP_RANGE_OK,       // 单段有效 返回206
+    HTTP_RANGE_INVALID   // 超出文件范围 返回416
+};
+
+// 解析Range请求头 支持 "bytes=a-b" "bytes=a-" "bytes=-n" 三种单段形式
+// 成功时[start, end]为闭区间
+HTTP_RANGE_RESULT http_parse_range(const char *header, uint32_t size,
+                                   uint32_t *start, uint32_t *end);
+
+// HTTP日期格式（如 "Sun, 06 Nov 1994 08:49:37 GMT"） len至少为30
+void http_format_date(time_t time, char *buf, size_t len);
+// 只支持上面的格式 失败时返回false
+bool http_parse_date(const char *date, time_t *time);
+
+// 下载文件时的响应方式
+struct HttpDownloadPlan
+{
+    int code;               // 200 206 304 416
+    uint32_t start;         // 发送内容在文件中的起始位置
+    uint32_t len;           // 发送的字节数（304、416时为0）
+    char content_range[48]; // 为空时不发送Content-Range
+    char last_modified[32]; // 为空时不发送Last-Modified
+};
+
+// 由请求头（没有时传NULL）与文件的大小、修改时间（未知时为0）决定响应
+// 先判断If-Modified-Since 再判断Range
+void http_download_plan(const char *range, const char *if_modified_since,
+                        uint32_t size, time_t last_write, HttpDownloadPlan *plan);
+
+typedef size_t (*HttpReadFn)(void *ctx, uint8_t *buf, size_t len);
+typedef size_t (*HttpWriteFn)(void *ctx, const uint8_t *buf, size_t len);
+
+// 以buf为缓冲从文件中复制len字节到客户端 每次最多buf_size字节
+// 读到文件末尾或写入不完整时停止 返回已发送的字节数
+uint32_t http_copy_body(HttpReadFn read, void *read_ctx,
+                        HttpWriteFn write, void *write_ctx,
+                        uint8_t *buf, uint32_t buf_size, uint32_t len);
+
+#endif
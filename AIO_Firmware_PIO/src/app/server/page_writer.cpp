@@ -0,0 +1,143 @@
+#include "page_writer.h"
+
+PageWriter::PageWriter(WebServer *server)
+{
+    m_server = server;
+    m_started = false;
+    m_len = 0;
+}
+
+PageWriter::~PageWriter()
+{
+    end();
+}
+
+void PageWriter::begin(int code, const char *content_type)
+{
+    // 长度未知 WebServer会使用chunked编码
+    m_server->setContentLength(CONTENT_LENGTH_UNKNOWN);
+    m_server->send(code, content_type, "");
+    m_started = true;
+    m_len = 0;
+}
+
+void PageWriter::print(const char *str)
+{
+    append(str, strlen(str));
+}
+
+void PageWriter::print(const String &str)
+{
+    append(str.c_str(), str.length());
+}
+
+void PageWriter::print_P(PGM_P str)
+{
+    append_P(str, strlen_P(str));
+}
+
+void PageWriter::render_P(PGM_P tmpl, const char *const *values, int num)
+{
+    int index = 0;
+    PGM_P start = tmpl;
+    char ch;
+    while (0 != (ch = pgm_read_byte(tmpl)))
+    {
+        if ('%' != ch)
+        {
+            ++tmpl;
+            continue;
+        }
+
+        // 先输出占位符之前的部分
+        char next = pgm_read_byte(tmpl + 1);
+        append_P(start, tmpl - start);
+        if ('s' == next)
+        {
+            if (index < num && NULL != values[index])
+            {
+                print(values[index]);
+            }
+            ++index;
+            tmpl += 2;
+        }
+        else if ('%' == next)
+        {
+            append("%", 1);
+            tmpl += 2;
+        }
+        else
+        {
+            append("%", 1);
+            ++tmpl;
+        }
+        start = tmpl;
+    }
+    append_P(start, tmpl - start);
+}
+
+void PageWriter::end(void)
+{
+    if (!m_started)
+    {
+        return;
+    }
+    flush();
+    // 空的分块表示结束
+    m_server->sendContent("");
+    m_started = false;
+}
+
+size_t PageWriter::write(uint8_t ch)
+{
+    append((const char *)&ch, 1);
+    return 1;
+}
+
+size_t PageWriter::write(const uint8_t *buffer, size_t size)
+{
+    append((const char *)buffer, size);
+    return size;
+}
+
+void PageWriter::append(const char *data, size_t len)
+{
+    while (len > 0)
+    {
+        size_t num = min(len, PAGE_CHUNK_SIZE - m_len);
+        memcpy(m_buf + m_len, data, num);
+        m_len += num;
+        data += num;
+        len -= num;
+        if (PAGE_CHUNK_SIZE == m_len)
+        {
+            flush();
+        }
+    }
+}
+
+void PageWriter::append_P(PGM_P data, size_t len)
+{
+    while (len > 0)
+    {
+        size_t num = min(len, PAGE_CHUNK_SIZE - m_len);
+        memcpy_P(m_buf + m_len, data, num);
+        m_len += num;
+        data += num;
+        len -= num;
+        if (PAGE_CHUNK_SIZE == m_len)
+        {
+            flush();
+        }
+    }
+}
+
+void PageWriter::flush(void)
+{
+    if (0 == m_len)
+    {
+        return;
+    }
+    m_server->sendContent_P(m_buf, m_len);
+    m_len = 0;
+}
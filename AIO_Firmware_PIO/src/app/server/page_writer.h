@@ -0,0 +1,42 @@
+#ifndef PAGE_WRITER_H
+#define PAGE_WRITER_H
+
+#include <WebServer.h>
+
+#define PAGE_CHUNK_SIZE 1024 // 每次发送的分块大小
+
+/*
+ * 分块发送网页
+ * 内容先写入固定大小的缓冲区 写满后以chunked编码发出 不需要在堆中拼出整个页面
+ * 模板保存在flash中 其中的"%s"按顺序替换为参数 "%%"输出"%"
+ * 同时也是Print 可以直接用printf输出
+ */
+class PageWriter : public Print
+{
+public:
+    PageWriter(WebServer *server);
+    ~PageWriter();
+
+    void begin(int code = 200, const char *content_type = "text/html");
+    void print(const char *str);
+    void print(const String &str);
+    void print_P(PGM_P str);
+    void render_P(PGM_P tmpl, const char *const *values, int num);
+    void end(void);
+
+    size_t write(uint8_t ch) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+
+private:
+    void append(const char *data, size_t len);
+    void append_P(PGM_P data, size_t len);
+    void flush(void);
+
+private:
+    WebServer *m_server;
+    bool m_started;
+    size_t m_len;
+    char m_buf[PAGE_CHUNK_SIZE];
+};
+
+#endif
@@ -1,6 +1,7 @@
 #include "server.h"
 #include "server_gui.h"
 #include "web_setting.h"
+#include "web_api.h"
 #include "sys/app_controller.h"
 #include "app/app_conf.h"
 #include "network.h"
@@ -20,6 +21,21 @@ struct ServerAppRunData
 
 static ServerAppRunData *run_data = NULL;
 
+// 包装请求的处理函数 统计处理耗时
+WebServer::THandlerFunction server_timed(WebServer::THandlerFunction fn)
+{
+#if METRICS_ENABLE
+    return [fn]()
+    {
+        METRIC_TIME_START(start);
+        fn();
+        METRIC_TIME_END_MS(METRIC_HTTP_REQUEST_MS, start);
+    };
+#else
+    return fn;
+#endif
+}
+
 void start_web_config()
 {
     if (server  == nullptr) {
@@ -27,86 +43,103 @@ void start_web_config()
     }
 
     // 首页
-    server->on("/", HTTP_GET, HomePage);
+    server->on("/", HTTP_GET, server_timed(HomePage));
+
+    // 需要读取的请求头 If-None-Match用于静态资源的缓存 Range用于断点续传/拖动进度
+    static const char *header_keys[] = {"If-None-Match", "Range", "If-Modified-Since"};
+    server->collectHeaders(header_keys, sizeof(header_keys) / sizeof(header_keys[0]));
+
+    // 静态资源
+    for (int index = 0; index < web_assets_num; ++index)
+    {
+        const WebAsset *asset = &web_assets[index];
+        server->on(asset->path, HTTP_GET, server_timed([asset]()
+                                                       { Send_Asset(asset); }));
+    }
+
+    // JSON接口
+    web_api_init();
+#if METRICS_ENABLE
+    server->on("/metrics", HTTP_GET, Send_Metrics); // 不计入请求耗时
+#endif
 
-    init_page_header();
-    init_page_footer();
-    server->on("/download", File_Download);
-    server->on("/upload", File_Upload);
-    server->on("/delete", File_Delete);
-    server->on("/delete_result", delete_result);
+    server->on("/download", server_timed(File_Download));
+    server->on("/upload", server_timed(File_Upload));
+    server->on("/delete", server_timed(File_Delete));
+    server->on("/delete_result", server_timed(delete_result));
 
-    server->on("/sys_setting", sys_setting);
-    server->on("/rgb_setting", rgb_setting);
+    server->on("/sys_setting", server_timed(sys_setting));
+    server->on("/app_stats", server_timed(app_stats));
+    server->on("/rgb_setting", server_timed(rgb_setting));
 #if APP_WEATHER_USE
-    server->on("/weather_setting", weather_setting);
+    server->on("/weather_setting", server_timed(weather_setting));
 #endif
 #if APP_WEATHER_OLD_USE
-    server->on("/weather_old_setting", weather_old_setting);
+    server->on("/weather_old_setting", server_timed(weather_old_setting));
 #endif
 #if APP_BILIBILI_FANS_USE
-    server->on("/bili_setting", bili_setting);
+    server->on("/bili_setting", server_timed(bili_setting));
 #endif
 #if APP_STOCK_MARKET_USE
-    server->on("/stock_setting", stock_setting);
+    server->on("/stock_setting", server_timed(stock_setting));
 #endif
 #if APP_PICTURE_USE
-    server->on("/picture_setting", picture_setting);
+    server->on("/picture_setting", server_timed(picture_setting));
 #endif
 #if APP_MEDIA_PLAYER_USE
-    server->on("/media_setting", media_setting);
+    server->on("/media_setting", server_timed(media_setting));
 #endif
 #if APP_SCREEN_SHARE_USE
-    server->on("/screen_setting", screen_setting);
+    server->on("/screen_setting", server_timed(screen_setting));
 #endif
 #if APP_HEARTBEAT_USE
-    server->on("/heartbeat_setting", heartbeat_setting);
+    server->on("/heartbeat_setting", server_timed(heartbeat_setting));
 #endif
 #if APP_ANNIVERSARY_USE
-    server->on("/anniversary_setting", anniversary_setting);
+    server->on("/anniversary_setting", server_timed(anniversary_setting));
 #endif
 #if APP_PC_RESOURCE_USE
-    server->on("/pc_resource_setting", pc_resource_setting);
+    server->on("/pc_resource_setting", server_timed(pc_resource_setting));
 #endif
 
     server->on(
         "/fupload", HTTP_POST,
-        []()
-        { server->send(200); },
+        server_timed([]()
+                     { server->send(200); }),
         handleFileUpload);
 
     // 连接
-    server->on("/saveSysConf", saveSysConf);
-    server->on("/saveRgbConf", saveRgbConf);
+    server->on("/saveSysConf", server_timed(saveSysConf));
+    server->on("/saveRgbConf", server_timed(saveRgbConf));
 #if APP_WEATHER_USE
-    server->on("/saveWeatherConf", saveWeatherConf);
+    server->on("/saveWeatherConf", server_timed(saveWeatherConf));
 #endif
 #if APP_WEATHER_OLD_USE
-    server->on("/saveWeatherOldConf", saveWeatherOldConf);
+    server->on("/saveWeatherOldConf", server_timed(saveWeatherOldConf));
 #endif
 #if APP_BILIBILI_FANS_USE
-    server->on("/saveBiliConf", saveBiliConf);
+    server->on("/saveBiliConf", server_timed(saveBiliConf));
 #endif
 #if APP_STOCK_MARKET_USE
-    server->on("/saveStockConf", saveStockConf);
+    server->on("/saveStockConf", server_timed(saveStockConf));
 #endif
 #if APP_PICTURE_USE
-    server->on("/savePictureConf", savePictureConf);
+    server->on("/savePictureConf", server_timed(savePictureConf));
 #endif
 #if APP_MEDIA_PLAYER_USE
-    server->on("/saveMediaConf", saveMediaConf);
+    server->on("/saveMediaConf", server_timed(saveMediaConf));
 #endif
 #if APP_SCREEN_SHARE_USE
-    server->on("/saveScreenConf", saveScreenConf);
+    server->on("/saveScreenConf", server_timed(saveScreenConf));
 #endif
 #if APP_HEARTBEAT_USE
-    server->on("/saveHeartbeatConf", saveHeartbeatConf);
+    server->on("/saveHeartbeatConf", server_timed(saveHeartbeatConf));
 #endif
 #if APP_ANNIVERSARY_USE
-    server->on("/saveAnniversaryConf", saveAnniversaryConf);
+    server->on("/saveAnniversaryConf", server_timed(saveAnniversaryConf));
 #endif
 #if APP_PC_RESOURCE_USE
-    server->on("/savePCResourceConf", savePCResourceConf);
+    server->on("/savePCResourceConf", server_timed(savePCResourceConf));
 #endif
     // Serial.printf("server.begin()之前 Mem: %d\n",  esp_get_free_heap_size());
     server->begin();
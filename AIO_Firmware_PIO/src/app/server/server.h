@@ -18,6 +18,9 @@ extern ESP8266WebServer server;
 #include <DNSServer.h>
 #include <HTTPClient.h>
 extern WebServer *server;
+
+// 包装请求的处理函数 统计处理耗时（关闭统计时原样返回）
+WebServer::THandlerFunction server_timed(WebServer::THandlerFunction fn);
 #endif
 
 extern APP_OBJ server_app;
@@ -0,0 +1,222 @@
+#include "upload_writer.h"
+#include "common.h"
+
+struct UploadBlock
+{
+    uint8_t *buf; // NULL表示结束
+    size_t len;
+};
+
+struct UploadWriterData
+{
+    String path;
+    File file;
+    uint8_t *blocks[UPLOAD_BLOCK_NUM];
+    int block_num;
+    uint8_t *cur; // 正在接收数据的块
+    size_t cur_len;
+    QueueHandle_t full_queue; // 等待写入的块
+    QueueHandle_t free_queue; // 已经写完可以复用的块
+    TaskHandle_t task;        // 后台写入任务 内存不足只分到一块时为NULL（直接写入）
+    SemaphoreHandle_t done_sem;
+    bool error;
+    uint32_t bytes;
+    unsigned long start_time;
+};
+
+static UploadWriterData *writer = NULL;
+
+static void write_block(const uint8_t *buf, size_t len)
+{
+    if (!writer->error && writer->file.write(buf, len) != len)
+    {
+        writer->error = true;
+        Serial.println(F("[Upload] write failed"));
+    }
+}
+
+static void TaskUploadWrite(void *parameter)
+{
+    UploadBlock block;
+    while (pdTRUE == xQueueReceive(writer->full_queue, &block, portMAX_DELAY))
+    {
+        if (NULL == block.buf)
+        {
+            break;
+        }
+        write_block(block.buf, block.len);
+        xQueueSend(writer->free_queue, &block.buf, portMAX_DELAY);
+    }
+
+    xSemaphoreGive(writer->done_sem);
+    vTaskDelete(NULL);
+}
+
+// 当前块交给写入任务
+static void submit_block(void)
+{
+    if (NULL == writer->cur || 0 == writer->cur_len)
+    {
+        return;
+    }
+
+    if (NULL == writer->task)
+    {
+        write_block(writer->cur, writer->cur_len);
+        writer->cur_len = 0;
+        return;
+    }
+
+    UploadBlock block = {writer->cur, writer->cur_len};
+    xQueueSend(writer->full_queue, &block, portMAX_DELAY);
+    writer->cur = NULL;
+    writer->cur_len = 0;
+}
+
+static void release_writer(void)
+{
+    for (int i = 0; i < writer->block_num; ++i)
+    {
+        free(writer->blocks[i]);
+    }
+    if (NULL != writer->full_queue)
+    {
+        vQueueDelete(writer->full_queue);
+    }
+    if (NULL != writer->free_queue)
+    {
+        vQueueDelete(writer->free_queue);
+    }
+    if (NULL != writer->done_sem)
+    {
+        vSemaphoreDelete(writer->done_sem);
+    }
+    delete writer;
+    writer = NULL;
+}
+
+bool upload_writer_begin(const String &path)
+{
+    if (NULL != writer)
+    {
+        // 上一次上传没有正常结束
+        upload_writer_end(true, NULL);
+    }
+
+    writer = new UploadWriterData();
+    writer->path = path;
+    tf.deleteFile(path); // Remove a previous version, otherwise data is appended the file again
+    writer->file = tf.open(path, FILE_WRITE);
+    if (!writer->file)
+    {
+        release_writer();
+        return false;
+    }
+
+    // 内存紧张时能分到几块用几块
+    for (int i = 0; i < UPLOAD_BLOCK_NUM; ++i)
+    {
+        writer->blocks[i] = (uint8_t *)malloc(UPLOAD_BLOCK_SIZE);
+        if (NULL == writer->blocks[i])
+        {
+            break;
+        }
+        ++writer->block_num;
+    }
+    if (0 == writer->block_num)
+    {
+        writer->file.close();
+        release_writer();
+        return false;
+    }
+    writer->cur = writer->blocks[0];
+
+    if (writer->block_num > 1)
+    {
+        writer->full_queue = xQueueCreate(writer->block_num + 1, sizeof(UploadBlock));
+        writer->free_queue = xQueueCreate(writer->block_num, sizeof(uint8_t *));
+        writer->done_sem = xSemaphoreCreateBinary();
+        for (int i = 1; i < writer->block_num; ++i)
+        {
+            xQueueSend(writer->free_queue, &writer->blocks[i], 0);
+        }
+        // loop()（接收网络数据）运行在核1 写卡放到核0上
+        if (pdPASS != xTaskCreatePinnedToCore(TaskUploadWrite, "UploadWrite",
+                                              3 * 1024, NULL, 1,
+                                              &writer->task, 0))
+        {
+            writer->task = NULL;
+        }
+    }
+
+    writer->start_time = GET_SYS_MILLIS();
+    Serial.printf("[Upload] %s (%d x %d bytes buffer)\n", path.c_str(),
+                  writer->block_num, UPLOAD_BLOCK_SIZE);
+    return true;
+}
+
+void upload_writer_write(const uint8_t *data, size_t len)
+{
+    if (NULL == writer)
+    {
+        return;
+    }
+
+    writer->bytes += len;
+    while (len > 0)
+    {
+        if (NULL == writer->cur)
+        {
+            xQueueReceive(writer->free_queue, &writer->cur, portMAX_DELAY);
+        }
+        size_t num = min(len, (size_t)(UPLOAD_BLOCK_SIZE - writer->cur_len));
+        memcpy(writer->cur + writer->cur_len, data, num);
+        writer->cur_len += num;
+        data += num;
+        len -= num;
+        if (UPLOAD_BLOCK_SIZE == writer->cur_len)
+        {
+            submit_block();
+        }
+    }
+}
+
+bool upload_writer_end(bool abort, UploadStats *stats)
+{
+    if (NULL == writer)
+    {
+        return false;
+    }
+
+    if (!abort)
+    {
+        submit_block();
+    }
+    if (NULL != writer->task)
+    {
+        UploadBlock block = {NULL, 0};
+        xQueueSend(writer->full_queue, &block, portMAX_DELAY);
+        xSemaphoreTake(writer->done_sem, portMAX_DELAY);
+    }
+    writer->file.close();
+
+    bool ok = !abort && !writer->error;
+    if (!ok)
+    {
+        tf.deleteFile(writer->path);
+    }
+
+    uint32_t time_ms = GET_SYS_MILLIS() - writer->start_time;
+    if (NULL != stats)
+    {
+        stats->bytes = writer->bytes;
+        stats->time_ms = time_ms;
+        stats->kb_per_s = (uint64_t)writer->bytes * 1000 / 1024 / max(time_ms, (uint32_t)1);
+    }
+    Serial.printf("[Upload] %s %u bytes in %u ms (%.2f MB/s)\n",
+                  ok ? "done" : "failed", writer->bytes, time_ms,
+                  writer->bytes / 1048.576 / max(time_ms, (uint32_t)1));
+
+    release_writer();
+    return ok;
+}
@@ -0,0 +1,27 @@
+#ifndef UPLOAD_WRITER_H
+#define UPLOAD_WRITER_H
+
+#include <Arduino.h>
+
+#define UPLOAD_BLOCK_SIZE (8 * 1024) // 每次写入SD卡的块大小（扇区512字节的整数倍）
+#define UPLOAD_BLOCK_NUM 3           // 缓冲块数 一块接收数据 其余排队等待写入
+
+struct UploadStats
+{
+    uint32_t bytes;    // 写入的字节数
+    uint32_t time_ms;  // 从开始接收到全部写完的耗时
+    uint32_t kb_per_s; // 平均速度
+};
+
+// 开始上传 打开（覆盖）path 并启动后台写入任务
+bool upload_writer_begin(const String &path);
+
+// 写入收到的数据 数据先攒满一块再交给后台任务写入SD卡
+// 后台任务来不及写时会在这里等待
+void upload_writer_write(const uint8_t *data, size_t len);
+
+// 结束上传 等待剩余数据写完后关闭文件
+// abort为true或写入出错时删除不完整的文件 返回是否成功
+bool upload_writer_end(bool abort, UploadStats *stats);
+
+#endif
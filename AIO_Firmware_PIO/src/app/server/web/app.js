@@ -0,0 +1,9 @@
+// 滑条拖动时实时显示当前值
+document.addEventListener('DOMContentLoaded', function () {
+    var sliders = document.querySelectorAll('.slider-container input[type="range"]');
+    for (var i = 0; i < sliders.length; i++) {
+        sliders[i].addEventListener('input', function () {
+            this.previousElementSibling.querySelector('.slider-value').innerHTML = this.value;
+        });
+    }
+});
@@ -0,0 +1,262 @@
+#include "web_api.h"
+#include "server.h"
+#include "sys/app_controller.h"
+#include "app/app_conf.h"
+#include "ArduinoJson.h"
+
+#define API_JSON_SIZE 4096 // 解析与生成JSON的内存池大小
+
+extern AppController *app_controller; // APP控制器
+
+struct ApiAppConfig
+{
+    const char *id;       // URL中使用的名字
+    const char *app_name; // send_to的目标
+    const char *const *keys;
+    int key_num;
+};
+
+static const char *const sys_keys[] = {
+    "ssid_0", "password_0", "ssid_1", "password_1", "ssid_2", "password_2",
+    "power_mode", "backLight", "rotation", "auto_calibration_mpu", "mpu_order",
+    "auto_start_app", "min_brightness", "max_brightness", "time",
+    "brightness_night_mode_specified", "brightness_night_mode_start",
+    "brightness_night_mode_end"};
+static const char *const weather_keys[] = {
+    "tianqi_url", "tianqi_city_code", "tianqi_api_key",
+    "weatherUpdataInterval", "timeUpdataInterval"};
+static const char *const weather_old_keys[] = {
+    "cityname", "language", "weather_key",
+    "weatherUpdataInterval", "timeUpdataInterval"};
+static const char *const bili_keys[] = {"bili_uid", "updataInterval"};
+static const char *const stock_keys[] = {"stock_id", "updataInterval"};
+static const char *const picture_keys[] = {"switchInterval", "cacheSize"};
+static const char *const media_keys[] = {"switchFlag", "powerFlag"};
+static const char *const screen_keys[] = {"powerFlag"};
+static const char *const heartbeat_keys[] = {
+    "role", "qq_num", "mqtt_server", "mqtt_port", "mqtt_user", "mqtt_password"};
+static const char *const anniversary_keys[] = {
+    "event_name0", "target_date0", "event_name1", "target_date1"};
+static const char *const pc_resource_keys[] = {"pc_ipaddr", "sensorUpdataInterval"};
+
+#define API_APP(id, name, keys) {id, name, keys, sizeof(keys) / sizeof(keys[0])}
+
+static const ApiAppConfig api_apps[] = {
+    API_APP("sys", CTRL_NAME, sys_keys),
+#if APP_WEATHER_USE
+    API_APP("weather", "Weather", weather_keys),
+#endif
+#if APP_WEATHER_OLD_USE
+    API_APP("weather_old", "Weather Old", weather_old_keys),
+#endif
+#if APP_BILIBILI_FANS_USE
+    API_APP("bili", "Bili", bili_keys),
+#endif
+#if APP_STOCK_MARKET_USE
+    API_APP("stock", "Stock", stock_keys),
+#endif
+#if APP_PICTURE_USE
+    API_APP("picture", "Picture", picture_keys),
+#endif
+#if APP_MEDIA_PLAYER_USE
+    API_APP("media", "Media", media_keys),
+#endif
+#if APP_SCREEN_SHARE_USE
+    API_APP("screen", "Screen share", screen_keys),
+#endif
+#if APP_HEARTBEAT_USE
+    API_APP("heartbeat", "Heartbeat", heartbeat_keys),
+#endif
+#if APP_ANNIVERSARY_USE
+    API_APP("anniversary", "Anniversary", anniversary_keys),
+#endif
+#if APP_PC_RESOURCE_USE
+    API_APP("pc_resource", "PC Resource", pc_resource_keys),
+#endif
+};
+
+#define API_APP_NUM (sizeof(api_apps) / sizeof(api_apps[0]))
+
+static void send_error(int code, const char *msg);
+
+static void send_json(int code, const JsonDocument &doc)
+{
+    if (doc.overflowed())
+    {
+        // 内存池不够时内容不完整 不能当作正常结果返回
+        send_error(500, "json overflowed");
+        return;
+    }
+    String out;
+    serializeJson(doc, out);
+    server->send(code, "application/json", out);
+}
+
+static void send_error(int code, const char *msg)
+{
+    StaticJsonDocument<128> doc;
+    doc["error"] = msg;
+    send_json(code, doc);
+}
+
+// 系统设置总是可用 其他APP需要已安装
+static bool is_config_available(const ApiAppConfig *app)
+{
+    return !strcmp(app->app_name, CTRL_NAME) || app_controller->is_app_installed(app->app_name);
+}
+
+// 取得APP的全部参数名 系统设置额外包含动作识别与背光的参数
+static int get_param_list(const ApiAppConfig *app, APP_PARAM **params)
+{
+    int num = app->key_num;
+    bool is_sys = !strcmp(app->app_name, CTRL_NAME);
+    if (is_sys)
+    {
+        num += GESTURE_PARAM_NUM + BACKLIGHT_PARAM_NUM;
+    }
+
+    APP_PARAM *list = new APP_PARAM[num];
+    int pos = 0;
+    for (int i = 0; i < app->key_num; ++i)
+    {
+        list[pos++].key = app->keys[i];
+    }
+    if (is_sys)
+    {
+        for (int i = 0; i < GESTURE_PARAM_NUM; ++i)
+        {
+            list[pos++].key = String(GESTURE_PARAM_PREFIX) + gesture_param_name[i];
+        }
+        for (int i = 0; i < BACKLIGHT_PARAM_NUM; ++i)
+        {
+            list[pos++].key = String(BACKLIGHT_PARAM_PREFIX) + backlight_param_name[i];
+        }
+    }
+    *params = list;
+    return num;
+}
+
+static void api_apps_list(void)
+{
+    DynamicJsonDocument doc(API_JSON_SIZE);
+    JsonArray apps = doc.createNestedArray("apps");
+    for (unsigned int i = 0; i < app_controller->get_app_num(); ++i)
+    {
+        const APP_OBJ *app = app_controller->get_app(i);
+        JsonObject item = apps.createNestedObject();
+        item["name"] = app->app_name;
+        item["info"] = app->app_info;
+    }
+
+    // 可以通过/api/config/<id>配置的对象
+    JsonArray configs = doc.createNestedArray("config");
+    for (unsigned int i = 0; i < API_APP_NUM; ++i)
+    {
+        const ApiAppConfig *app = &api_apps[i];
+        if (!is_config_available(app))
+        {
+            continue;
+        }
+        JsonObject item = configs.createNestedObject();
+        item["id"] = app->id;
+        item["name"] = app->app_name;
+    }
+    send_json(200, doc);
+}
+
+static void api_config_get(const ApiAppConfig *app)
+{
+    if (!is_config_available(app))
+    {
+        send_error(404, "app not installed");
+        return;
+    }
+    APP_PARAM *params = NULL;
+    int num = get_param_list(app, &params);
+    app_controller->send_params(SERVER_APP_NAME, app->app_name,
+                                APP_MESSAGE_GET_PARAM, params, num);
+
+    DynamicJsonDocument doc(API_JSON_SIZE);
+    for (int i = 0; i < num; ++i)
+    {
+        doc[params[i].key] = params[i].value;
+    }
+    delete[] params;
+    send_json(200, doc);
+}
+
+static void api_config_put(const ApiAppConfig *app)
+{
+    if (!is_config_available(app))
+    {
+        send_error(404, "app not installed");
+        return;
+    }
+    DynamicJsonDocument body(API_JSON_SIZE);
+    if (deserializeJson(body, server->arg("plain")) || !body.is<JsonObject>())
+    {
+        send_error(400, "invalid json object");
+        return;
+    }
+
+    APP_PARAM *known = NULL;
+    int known_num = get_param_list(app, &known);
+    JsonObject obj = body.as<JsonObject>();
+    APP_PARAM *params = new APP_PARAM[obj.size()];
+    int num = 0;
+
+    DynamicJsonDocument result(API_JSON_SIZE);
+    JsonArray ignored = result.createNestedArray("ignored");
+    for (JsonPair kv : obj)
+    {
+        const char *key = kv.key().c_str();
+        bool found = false;
+        for (int i = 0; i < known_num && !found; ++i)
+        {
+            found = known[i].key == key;
+        }
+        if (!found || kv.value().is<JsonObject>() || kv.value().is<JsonArray>())
+        {
+            ignored.add(key);
+            continue;
+        }
+
+        params[num].key = key;
+        if (kv.value().is<bool>())
+        {
+            params[num].value = kv.value().as<bool>() ? "1" : "0";
+        }
+        else if (kv.value().is<const char *>())
+        {
+            params[num].value = kv.value().as<const char *>();
+        }
+        else
+        {
+            serializeJson(kv.value(), params[num].value);
+        }
+        ++num;
+    }
+
+    // 一次转发全部参数 只保存一次配置
+    app_controller->send_params(SERVER_APP_NAME, app->app_name,
+                                APP_MESSAGE_SET_PARAM, params, num);
+    result["updated"] = num;
+    delete[] params;
+    delete[] known;
+    send_json(200, result);
+}
+
+void web_api_init(void)
+{
+    server->on("/api/apps", HTTP_GET, server_timed(api_apps_list));
+
+    for (unsigned int i = 0; i < API_APP_NUM; ++i)
+    {
+        const ApiAppConfig *app = &api_apps[i];
+        String uri = String("/api/config/") + app->id;
+        server->on(uri, HTTP_GET, server_timed([app]()
+                                               { api_config_get(app); }));
+        server->on(uri, HTTP_PUT, server_timed([app]()
+                                               { api_config_put(app); }));
+    }
+}
@@ -0,0 +1,13 @@
+#ifndef WEB_API_H
+#define WEB_API_H
+
+/*
+ * JSON接口 便于脚本批量配置
+ *   GET /api/apps            已安装的APP以及可配置的APP
+ *   GET /api/config/<id>     读取APP的全部参数 {"key": "value", ...}
+ *   PUT /api/config/<id>     写入JSON中出现的参数并保存 未出现的参数保持不变
+ * 参数与网页配置中的表单项一致 值统一为字符串（写入时也接受数字和布尔值）
+ */
+void web_api_init(void);
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // 预先gzip压缩的静态资源 数据由 Script/gen_web_assets.py 生成（web_assets_gz.c）
+    struct WebAsset
+    {
+        const char *path;         // 访问路径
+        const char *content_type; // 原始内容的类型
+        const uint8_t *data;      // gzip数据
+        size_t len;
+        const char *etag;         // 原始内容的摘要（带引号）
+    };
+
+    extern const struct WebAsset web_assets[];
+    extern const int web_assets_num;
+    // 全部资源的摘要 页面引用资源时附加在URL后 资源更新后浏览器会重新获取
+    extern const char web_assets_version[];
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
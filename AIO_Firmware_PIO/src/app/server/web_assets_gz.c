@@ -0,0 +1,96 @@
+// 由 Script/gen_web_assets.py 生成 请勿手动修改
+
+#include "web_assets.h"
+
+static const uint8_t style_css_gz[940] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xb5, 0x56, 0x61, 0x6f, 0xa4, 0x36,
+    0x10, 0xfd, 0x9e, 0x5f, 0x61, 0x5d, 0x14, 0x5d, 0x5b, 0xdd, 0x22, 0xb3, 0x2c, 0x59, 0xce, 0xa8,
+    0x95, 0xa2, 0x36, 0xfd, 0x13, 0x55, 0x55, 0x19, 0xec, 0x5d, 0xac, 0x18, 0x1b, 0x81, 0xb9, 0xcd,
+    0x1e, 0xca, 0x7f, 0xef, 0xd8, 0x98, 0x05, 0x76, 0xd9, 0x5c, 0xaa, 0x26, 0xf0, 0x21, 0xc1, 0x36,
+    0xf3, 0xde, 0xbc, 0x79, 0x33, 0x4b, 0x20, 0x54, 0xd5, 0x1a, 0xd4, 0x31, 0xd1, 0x54, 0x92, 0x1e,
+    0x09, 0xca, 0xa4, 0xce, 0x9f, 0xd2, 0x92, 0xd6, 0x7b, 0xa1, 0x56, 0x46, 0x57, 0x04, 0x85, 0xb8,
+    0x7a, 0x4e, 0x5f, 0x6e, 0x82, 0xfe, 0x64, 0x53, 0x51, 0x85, 0xba, 0x83, 0x60, 0xa6, 0x20, 0x28,
+    0xc2, 0x76, 0x6f, 0x27, 0x35, 0x35, 0x04, 0x49, 0xbe, 0x33, 0x69, 0xc1, 0xc5, 0xbe, 0x80, 0x87,
+    0xe8, 0x1e, 0x36, 0xa4, 0x50, 0x7c, 0x35, 0x5b, 0x39, 0x85, 0xf1, 0xb0, 0xa7, 0x4d, 0x1b, 0xc7,
+    0x07, 0x5d, 0xe3, 0x19, 0x60, 0x50, 0x53, 0x26, 0xf4, 0xf2, 0xd1, 0xd8, 0x9f, 0x6c, 0xa4, 0x60,
+    0xbc, 0x5e, 0xe5, 0x5a, 0x19, 0x0a, 0x98, 0xf5, 0xeb, 0xf9, 0xc4, 0xf0, 0x52, 0x2e, 0x39, 0xad,
+    0x61, 0x57, 0x9b, 0x62, 0x31, 0xc0, 0x6f, 0x3e, 0xd1, 0xb3, 0x38, 0x1e, 0x37, 0xc4, 0xf8, 0xee,
+    0x94, 0x2a, 0x6d, 0x8d, 0x1e, 0x00, 0x20, 0x9e, 0xd1, 0x25, 0x41, 0xc9, 0x15, 0x5e, 0x2e, 0xa5,
+    0xbf, 0xcc, 0xb1, 0xe2, 0xbf, 0x7e, 0xaa, 0xa9, 0xda, 0xf3, 0x4f, 0x7f, 0xa3, 0x6e, 0x75, 0xe0,
+    0xd9, 0x93, 0x30, 0x2b, 0x5a, 0x55, 0x40, 0x8a, 0xaa, 0x9c, 0x13, 0xa4, 0xb4, 0xe2, 0x8b, 0x68,
+    0xae, 0x1a, 0x99, 0xae, 0x6d, 0x5c, 0xab, 0x4c, 0xdb, 0x80, 0x0c, 0x76, 0x89, 0xe6, 0x4f, 0xfb,
+    0x5a, 0xb7, 0x8a, 0x11, 0x74, 0xcb, 0x22, 0x7b, 0xa7, 0xba, 0x35, 0xb6, 0x04, 0x3e, 0x9a, 0xae,
+    0x68, 0x2e, 0x0c, 0xa4, 0x82, 0x83, 0x6d, 0x3a, 0x60, 0x1a, 0xc0, 0x6b, 0x84, 0x11, 0x5a, 0x11,
+    0x14, 0xac, 0x9b, 0x74, 0xfa, 0xec, 0x5f, 0x70, 0xeb, 0x6f, 0x4c, 0x86, 0x14, 0xfa, 0x9b, 0x95,
+    0xff, 0x84, 0x15, 0xbe, 0xf9, 0x4d, 0x32, 0x50, 0xf2, 0xa7, 0x4d, 0xd1, 0x96, 0xd9, 0x2b, 0xe2,
+    0x5c, 0x53, 0x6b, 0x6d, 0xd5, 0x18, 0xd4, 0x72, 0x0f, 0xe7, 0x6a, 0x81, 0x9a, 0x33, 0xb5, 0x36,
+    0xbf, 0x3f, 0xfc, 0x19, 0xe3, 0x34, 0x6f, 0xeb, 0x46, 0x83, 0x27, 0x2a, 0x2d, 0x94, 0xe1, 0xf5,
+    0x7f, 0x20, 0x5e, 0xea, 0xef, 0x2b, 0xf7, 0x34, 0x90, 0xfe, 0x38, 0x2a, 0xdf, 0xa8, 0x6c, 0xf9,
+    0xc4, 0x96, 0x42, 0xb9, 0x26, 0x9b, 0xb9, 0xdc, 0x36, 0xa2, 0x37, 0xca, 0x0e, 0x98, 0x83, 0x82,
+    0x3d, 0x83, 0x4c, 0x4b, 0x96, 0xe6, 0x5a, 0xda, 0xc8, 0x03, 0x12, 0x44, 0xce, 0xcc, 0xd8, 0xd0,
+    0xe1, 0x1a, 0x4f, 0x28, 0x47, 0x73, 0x63, 0xad, 0x86, 0x77, 0xb1, 0xbb, 0x7c, 0x32, 0xe0, 0x27,
+    0xdb, 0x4f, 0x7e, 0x6b, 0xe7, 0xae, 0xcb, 0x7e, 0x9b, 0x51, 0x73, 0x1d, 0xf3, 0x72, 0x93, 0x69,
+    0x76, 0xec, 0x4a, 0xfa, 0xbc, 0xea, 0xc1, 0xef, 0xe3, 0x3b, 0x7f, 0x8c, 0xe0, 0xfe, 0x88, 0x63,
+    0xbf, 0xa3, 0xa5, 0x90, 0x47, 0x42, 0x6b, 0x41, 0x65, 0xbf, 0xd2, 0x88, 0xef, 0x9c, 0x84, 0x18,
+    0x8e, 0x1b, 0xfe, 0x0c, 0xce, 0x90, 0x62, 0xaf, 0x48, 0xce, 0x9d, 0x52, 0x3d, 0x8f, 0x0c, 0x44,
+    0xba, 0x24, 0x7e, 0xcb, 0x32, 0x46, 0x59, 0x06, 0xc8, 0xad, 0xec, 0xa4, 0x68, 0x20, 0x92, 0x39,
+    0x4a, 0x28, 0x1a, 0x94, 0x93, 0x38, 0x0b, 0x0d, 0xf0, 0x41, 0xc8, 0xcb, 0xb4, 0xa2, 0x8c, 0x09,
+    0xb5, 0x27, 0xf8, 0xac, 0x6a, 0x38, 0x88, 0xb6, 0x31, 0xec, 0x5b, 0xa7, 0xc3, 0xe8, 0x3b, 0x90,
+    0x42, 0x30, 0xc6, 0xd5, 0x02, 0x5e, 0xb2, 0x4d, 0xe2, 0x24, 0x99, 0x92, 0x86, 0xd7, 0x5e, 0x6e,
+    0xa4, 0xe8, 0xfa, 0x91, 0xe9, 0x26, 0xe6, 0x72, 0xf0, 0x61, 0xd5, 0x15, 0x02, 0x07, 0xf8, 0x9e,
+    0x97, 0xa8, 0xd1, 0xe0, 0x01, 0x74, 0x9b, 0x65, 0x90, 0x82, 0xa4, 0x40, 0x3f, 0x2f, 0x84, 0x64,
+    0xa8, 0x9b, 0x9d, 0x75, 0x79, 0x8c, 0x88, 0x49, 0x7c, 0x67, 0x01, 0x11, 0x3d, 0x9f, 0x64, 0xcb,
+    0xb0, 0xa7, 0x9c, 0x83, 0xcd, 0x06, 0x10, 0xfb, 0x3f, 0xbd, 0xcc, 0x8c, 0xe7, 0xba, 0xa6, 0x6e,
+    0x32, 0x5c, 0xc3, 0xe8, 0xbb, 0xbf, 0xbb, 0x14, 0xe2, 0xf1, 0xe1, 0x31, 0x7a, 0x7c, 0xb8, 0x82,
+    0x79, 0x16, 0xa8, 0xe1, 0xb9, 0x05, 0x41, 0xdd, 0xb8, 0x8e, 0x83, 0x24, 0x71, 0xca, 0x15, 0x61,
+    0xd7, 0x47, 0x3c, 0x14, 0xc2, 0xf0, 0x8b, 0x78, 0xf3, 0x68, 0xb3, 0x1a, 0x06, 0x6b, 0x97, 0xce,
+    0xda, 0x4a, 0x3b, 0x36, 0xdc, 0xed, 0x26, 0x87, 0x9b, 0xd9, 0xc8, 0x6b, 0x1f, 0x59, 0xbb, 0x46,
+    0x9e, 0x86, 0x09, 0x70, 0x8f, 0x1d, 0xcd, 0x19, 0xb9, 0x45, 0x43, 0x33, 0xc9, 0xbb, 0x0b, 0x9f,
+    0x7e, 0x69, 0x60, 0x8a, 0xae, 0x1a, 0x5e, 0x8b, 0x5d, 0x3a, 0x7d, 0xe9, 0xeb, 0x58, 0x59, 0x40,
+    0x93, 0xb4, 0x6a, 0x38, 0x19, 0xfe, 0xf1, 0xf3, 0x0b, 0x34, 0xb0, 0x71, 0x8b, 0x2f, 0xe6, 0x54,
+    0xd9, 0xb3, 0xfa, 0x33, 0x77, 0x4d, 0xbd, 0xef, 0x7c, 0x34, 0xa6, 0x1a, 0x8d, 0x28, 0xfe, 0xf7,
+    0x68, 0x31, 0x00, 0xa0, 0xd4, 0x44, 0x99, 0xa2, 0xb7, 0xd1, 0x4f, 0x9a, 0xb1, 0x9f, 0xd1, 0x42,
+    0xed, 0xb8, 0xbb, 0xec, 0xa0, 0xa8, 0xc1, 0x00, 0x30, 0x04, 0x9b, 0x7f, 0xd4, 0xe8, 0xb9, 0xa9,
+    0xf4, 0x53, 0x61, 0xe3, 0x38, 0x79, 0xfc, 0x23, 0x9e, 0x93, 0x42, 0x3d, 0xb5, 0x3e, 0xcf, 0x35,
+    0x8c, 0xbe, 0x69, 0x2d, 0x47, 0x99, 0xb6, 0x4e, 0x81, 0x11, 0xad, 0x7c, 0x07, 0xb4, 0xf8, 0xcd,
+    0x68, 0x87, 0x77, 0x40, 0xdb, 0xfe, 0x08, 0x0d, 0x36, 0xdb, 0x52, 0x4d, 0xa7, 0xc0, 0x48, 0xd3,
+    0x0f, 0xdf, 0x8d, 0xe7, 0x05, 0xf3, 0x85, 0xee, 0x60, 0xb2, 0x75, 0xf6, 0x47, 0x08, 0x66, 0x1c,
+    0xf9, 0xfc, 0x39, 0x1d, 0x5a, 0xd9, 0xb9, 0xcf, 0x7f, 0xca, 0xf8, 0x2f, 0x99, 0x5f, 0x80, 0xfd,
+    0xb3, 0xc5, 0xb2, 0xcc, 0x4e, 0x26, 0xb0, 0x1f, 0x23, 0x3b, 0xad, 0xcd, 0x62, 0x73, 0x66, 0xa1,
+    0xbd, 0x53, 0x74, 0x39, 0x4c, 0x97, 0x32, 0xfc, 0x51, 0x0f, 0xdf, 0x63, 0xcb, 0x3b, 0x6b, 0xc1,
+    0x77, 0xea, 0x23, 0x5d, 0x12, 0x46, 0x0e, 0x28, 0xe8, 0x91, 0x9a, 0x77, 0xa8, 0x5a, 0x18, 0x5f,
+    0xc3, 0x4a, 0x66, 0x50, 0xe5, 0xff, 0x87, 0xfa, 0x7a, 0x97, 0xa2, 0x2b, 0x06, 0x99, 0x42, 0x95,
+    0x1f, 0x9a, 0xd5, 0x0c, 0xea, 0x3d, 0x6c, 0xbf, 0xc1, 0xaf, 0x43, 0xd1, 0xee, 0xbc, 0x11, 0xaa,
+    0x8b, 0x95, 0x7f, 0x01, 0xf9, 0xb4, 0x2f, 0xe4, 0x90, 0x0c, 0x00, 0x00,
+};
+
+static const uint8_t app_js_gz[297] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x6d, 0x8f, 0xbf, 0x4e, 0xc3, 0x30,
+    0x10, 0xc6, 0xf7, 0x3c, 0x85, 0xd5, 0x25, 0x89, 0x0a, 0x29, 0x7b, 0xe8, 0x80, 0xa0, 0x12, 0x43,
+    0x2b, 0x86, 0xb2, 0x55, 0x1d, 0x4c, 0x7c, 0x4d, 0x4f, 0x32, 0x76, 0x70, 0xec, 0x48, 0x15, 0xaa,
+    0xc4, 0x0a, 0x88, 0x01, 0x21, 0x01, 0x0b, 0x48, 0x48, 0x1d, 0x98, 0x18, 0x19, 0xf8, 0xf7, 0x36,
+    0x31, 0xaf, 0x81, 0x13, 0x9a, 0x22, 0xa4, 0x7e, 0xc3, 0xf9, 0x74, 0x67, 0xfd, 0xbe, 0xfb, 0x3a,
+    0x1d, 0x62, 0xdf, 0xaf, 0xed, 0xc3, 0x93, 0xbd, 0xbc, 0x2d, 0x2f, 0x9e, 0xed, 0xdd, 0x6b, 0xf9,
+    0xf2, 0xe8, 0xaa, 0xbd, 0xff, 0xfa, 0x5e, 0xbc, 0x95, 0x9f, 0x37, 0xe5, 0xf9, 0x55, 0x79, 0xf6,
+    0xe1, 0x31, 0x99, 0x98, 0x63, 0x10, 0x3a, 0xa2, 0x8c, 0xf5, 0x0a, 0xd7, 0xf4, 0x31, 0xd7, 0x20,
+    0x40, 0x05, 0xfe, 0xde, 0xc1, 0x60, 0x57, 0x0a, 0x5d, 0xcd, 0x24, 0x65, 0xc0, 0xfc, 0x0d, 0x32,
+    0x31, 0x22, 0xd1, 0x28, 0x05, 0x09, 0x42, 0x72, 0xea, 0x11, 0xa7, 0x82, 0x2a, 0x92, 0x73, 0x64,
+    0xa0, 0x72, 0xd2, 0x25, 0x2b, 0xda, 0x89, 0x01, 0x35, 0x1b, 0x02, 0x87, 0x44, 0x4b, 0xb5, 0xc3,
+    0x79, 0xe0, 0x47, 0xbf, 0xbf, 0x36, 0x13, 0x87, 0xa4, 0xe8, 0x0c, 0x08, 0x8a, 0xcc, 0xe8, 0x91,
+    0x9e, 0x65, 0xd0, 0x6d, 0x29, 0x2a, 0x52, 0x68, 0x8d, 0xfd, 0x30, 0xae, 0xa9, 0x13, 0xa9, 0x48,
+    0x50, 0xa1, 0xd1, 0x41, 0xb7, 0x62, 0xf7, 0x6c, 0x37, 0x2e, 0x11, 0x07, 0x91, 0xea, 0xa9, 0x9b,
+    0xb5, 0xdb, 0xcd, 0x11, 0x95, 0x96, 0xeb, 0x11, 0x8e, 0xd7, 0x44, 0xa9, 0xad, 0xd6, 0xde, 0xdf,
+    0x48, 0x4f, 0x31, 0x8f, 0x32, 0x05, 0x05, 0x4a, 0x93, 0xf7, 0x38, 0x54, 0x29, 0x86, 0x78, 0xc4,
+    0x51, 0xa4, 0xff, 0xc3, 0xfc, 0x25, 0x29, 0x28, 0x37, 0xe0, 0x87, 0x11, 0x0a, 0xe7, 0xb1, 0x7f,
+    0x38, 0xe8, 0xbb, 0x5b, 0x6b, 0x4c, 0xbd, 0x88, 0x57, 0xf8, 0xf9, 0x32, 0xd4, 0xdc, 0xab, 0xba,
+    0x1f, 0x67, 0x8a, 0x12, 0x8f, 0x99, 0x01, 0x00, 0x00,
+};
+
+const struct WebAsset web_assets[] = {
+    {"/style.css", "text/css", style_css_gz, sizeof(style_css_gz), "\"69834244cbee5aaa\""},
+    {"/app.js", "application/javascript", app_js_gz, sizeof(app_js_gz), "\"e2bbc3d114ee58c9\""},
+};
+
+const int web_assets_num = sizeof(web_assets) / sizeof(web_assets[0]);
+
+const char web_assets_version[] = "123c4775";
@@ -5,43 +5,19 @@
 #include "common.h"
 #include "server.h"
 #include "web_setting.h"
+#include "page_writer.h"
+#include "web_assets.h"
+#include "upload_writer.h"
+#include "http_range.h"
 #include "app/app_conf.h"
+#include "sys/buf_pool.h"
 #include "FS.h"
 #include "HardwareSerial.h"
 #include <esp32-hal.h>
 
-boolean sd_present = true;
-String webpage = "";
-String webpage_header = "";
-String webpage_footer = "";
+#define DOWNLOAD_BUF_OWNER "Download"
 
-void Send_HTML(const String &content)
-{
-    // 检查客户端是否仍然连接
-    if (!server->client().connected()) {
-        return;
-    }
-    
-    // 使用局部变量减少全局变量使用
-    String fullResponse = "";
-    fullResponse.reserve(webpage_header.length() + content.length() + webpage_footer.length() + 100);
-    
-    fullResponse = webpage_header + content + webpage_footer;
-    
-    server->sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
-    server->sendHeader("Pragma", "no-cache");
-    server->sendHeader("Expires", "-1");
-    server->setContentLength(fullResponse.length());
-    
-    // 使用sendContent而不是多个sendContent调用
-    server->send(200, "text/html", fullResponse);
-    
-    // 不需要手动停止客户端，服务器会自动管理
-    // server->client().stop(); // 移除这一行
-    
-    // 清理局部变量
-    fullResponse = "";
-}
+boolean sd_present = true;
 
 String file_size(int bytes)
 {
@@ -57,198 +33,277 @@ String file_size(int bytes)
     return fsize;
 }
 
-#define SETING_CSS ".input {display: block;margin-top: 10px;}"                                          \
-                   ".input span {width: 300px;float: left;height: 36px;line-height: 36px;}" \
-                   ".input input {height: 30px;width: 200px;}"                                          \
-                   ".input .radio {height: 30px;width: 50px;}"                                          \
-                   ".slider-container {display: block;margin-top: 15px;clear: both;}"                               \
-                   ".slider-container > span {display: block;width: 100%;height: auto;margin-bottom: 8px;}"  \
-                   ".slider-container input[type=\"range\"] {-webkit-appearance: none;width: 100%;height: 10px;border-radius: 5px;background: #d3d3d3;outline: none;opacity: 0.7;-webkit-transition: .2s;transition: opacity .2s;}" \
-                   ".slider-container input[type=\"range\"]:hover {opacity: 1;}" \
-                   ".slider-container input[type=\"range\"]::-webkit-slider-thumb {-webkit-appearance: none;appearance: none;width: 25px;height: 25px;border-radius: 50%;background: #4CAF50;cursor: pointer;}" \
-                   ".slider-container input[type=\"range\"]::-moz-range-thumb {width: 25px;height: 25px;border-radius: 50%;background: #4CAF50;cursor: pointer;}" \
-                   ".slider-value {display: inline-block;margin-left: 10px;font-weight: bold;color: #4CAF50;}" \
-                   ".btn {width: 120px;height: 35px;background-color: #000000;border: 0px;color: #ffffff;margin-top: 15px;margin-left: auto;}"  
-                
-#define SYS_SETTING "<form method=\"GET\" action=\"saveSysConf\">"                                                                                                                                                                                                      \
-                    "<label class=\"input\"><span>WiFi SSID_0(2.4G)</span><input type=\"text\"name=\"ssid_0\"value=\"%s\"></label>"                                                                                                                                     \
-                    "<label class=\"input\"><span>WiFi Passwd_0</span><input type=\"text\"name=\"password_0\"value=\"%s\"></label>"                                                                                                                                     \
-                    "<label class=\"input\"><span>功耗控制（0低发热 1性能优先）</span><input type=\"text\"name=\"power_mode\"value=\"%s\"></label>"                                                                                                        \
-                    "<div class=\"slider-container\"><span>屏幕亮度 (值为1~100)(夜间模式时间段不生效）：<span class=\"slider-value\">%s</span></span><input type=\"range\" min=\"1\" max=\"100\" step=\"1\" name=\"backLight\" value=\"%s\" oninput=\"this.previousElementSibling.querySelector('.slider-value').innerHTML = this.value\"></div>" \
-                    "<label class=\"input\"><span>屏幕方向 (0~5可选)</span><input type=\"text\"name=\"rotation\"value=\"%s\"></label>"                                                                                                                            \
-                    "<label class=\"input\"><span>操作方向（0~15可选）</span><input type=\"text\"name=\"mpu_order\"value=\"%s\"></label>"                                                                                                                       \
-                    "<label class=\"input\"><span>MPU6050自动校准</span><input class=\"radio\" type=\"radio\" value=\"0\" name=\"auto_calibration_mpu\" %s>关闭<input class=\"radio\" type=\"radio\" value=\"1\" name=\"auto_calibration_mpu\" %s>开启</label>" \
-                    "<label class=\"input\"><span>开机自启的APP名字（如 Weather ）</span><input type=\"text\"name=\"auto_start_app\"value=\"%s\"></label>"                                                                                                    \
-                    "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>"
-
-#define RGB_SETTING "<form method=\"GET\" action=\"saveRgbConf\">"                                                                                          \
-                    "<label class=\"input\"><span>RGB最低亮度（0~1000可选）</span><input type=\"text\"name=\"min_brightness\"value=\"%s\"></label>" \
-                    "<label class=\"input\"><span>RGB最高亮度（0~1000可选）</span><input type=\"text\"name=\"max_brightness\"value=\"%s\"></label>" \
-                    "<label class=\"input\"><span>RGB渐变时间（10~1000可选）</span><input type=\"text\"name=\"time\"value=\"%s\"></label>"          \
-                    "<div class=\"slider-container\"><span>夜间模式指定亮度（1~100可选）：<span class=\"slider-value\">%s</span></span><input type=\"range\" min=\"1\" max=\"100\" step=\"1\" name=\"brightness_night_mode_specified\" value=\"%s\" oninput=\"this.previousElementSibling.querySelector('.slider-value').innerHTML = this.value\"></div>" \
-                    "<label class=\"input\"><span>夜间模式开始时间（0~23可选）</span><input type=\"text\"name=\"brightness_night_mode_start\"value=\"%s\"></label>" \
-                    "<label class=\"input\"><span>夜间模式结束时间（0~23可选）</span><input type=\"text\"name=\"brightness_night_mode_end\"value=\"%s\"></label>" \
-                    "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>"
+static const char SYS_SETTING[] PROGMEM =
+    "<form method=\"GET\" action=\"saveSysConf\">"
+    "<label class=\"input\"><span>WiFi SSID_0(2.4G)</span><input type=\"text\"name=\"ssid_0\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>WiFi Passwd_0</span><input type=\"text\"name=\"password_0\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>功耗控制（0低发热 1性能优先）</span><input type=\"text\"name=\"power_mode\"value=\"%s\"></label>"
+    "<div class=\"slider-container\"><span>屏幕亮度 (值为1~100)(夜间模式时间段不生效）：<span class=\"slider-value\">%s</span></span><input type=\"range\" min=\"1\" max=\"100\" step=\"1\" name=\"backLight\" value=\"%s\"></div>"
+    "<label class=\"input\"><span>屏幕方向 (0~5可选)</span><input type=\"text\"name=\"rotation\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>操作方向（0~15可选）</span><input type=\"text\"name=\"mpu_order\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>MPU6050自动校准</span><input class=\"radio\" type=\"radio\" value=\"0\" name=\"auto_calibration_mpu\" %s>关闭<input class=\"radio\" type=\"radio\" value=\"1\" name=\"auto_calibration_mpu\" %s>开启</label>"
+    "<label class=\"input\"><span>开机自启的APP名字（如 Weather ）</span><input type=\"text\"name=\"auto_start_app\"value=\"%s\"></label>"
+    "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>";
+
+static const char RGB_SETTING[] PROGMEM =
+    "<form method=\"GET\" action=\"saveRgbConf\">"
+    "<label class=\"input\"><span>RGB最低亮度（0~1000可选）</span><input type=\"text\"name=\"min_brightness\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>RGB最高亮度（0~1000可选）</span><input type=\"text\"name=\"max_brightness\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>RGB渐变时间（10~1000可选）</span><input type=\"text\"name=\"time\"value=\"%s\"></label>"
+    "<div class=\"slider-container\"><span>夜间模式指定亮度（1~100可选）：<span class=\"slider-value\">%s</span></span><input type=\"range\" min=\"1\" max=\"100\" step=\"1\" name=\"brightness_night_mode_specified\" value=\"%s\"></div>"
+    "<label class=\"input\"><span>夜间模式开始时间（0~23可选）</span><input type=\"text\"name=\"brightness_night_mode_start\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>夜间模式结束时间（0~23可选）</span><input type=\"text\"name=\"brightness_night_mode_end\"value=\"%s\"></label>"
+    "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>";
                     
-#define WEATHER_SETTING "<form method=\"GET\" action=\"saveWeatherConf\">"                                                                                            \
-                        "<label class=\"input\"><span>TianQi Url</span><input type=\"text\"name=\"tianqi_url\"value=\"%s\"></label>"                                  \
-                        "<label class=\"input\"><span>城市名（或填6位城市代码）</span><input type=\"text\"name=\"tianqi_city_code\"value=\"%s\"></label>" \
-                        "<label class=\"input\"><span>API的个人Key</span><input type=\"text\"name=\"tianqi_api_key\"value=\"%s\"></label>"                         \
-                        "<label class=\"input\"><span>天气更新周期（毫秒）</span><input type=\"text\"name=\"weatherUpdataInterval\"value=\"%s\"></label>"   \
-                        "<label class=\"input\"><span>日期更新周期（毫秒）</span><input type=\"text\"name=\"timeUpdataInterval\"value=\"%s\"></label>"      \
-                        "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>"
-
-#define WEATHER_OLD_SETTING "<form method=\"GET\" action=\"saveWeatherOldConf\">"                                                                                       \
-                            "<label class=\"input\"><span>知心天气 城市名（拼音）</span><input type=\"text\"name=\"cityname\"value=\"%s\"></label>"          \
-                            "<label class=\"input\"><span>City Language(zh-Hans)</span><input type=\"text\"name=\"language\"value=\"%s\"></label>"                      \
-                            "<label class=\"input\"><span>Weather Key</span><input type=\"text\"name=\"weather_key\"value=\"%s\"></label>"                              \
-                            "<label class=\"input\"><span>天气更新周期（毫秒）</span><input type=\"text\"name=\"weatherUpdataInterval\"value=\"%s\"></label>" \
-                            "<label class=\"input\"><span>日期更新周期（毫秒）</span><input type=\"text\"name=\"timeUpdataInterval\"value=\"%s\"></label>"    \
-                            "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>"
-
-#define BILIBILI_SETTING "<form method=\"GET\" action=\"saveBiliConf\">"                                                                                      \
-                         "<label class=\"input\"><span>Bili UID</span><input type=\"text\"name=\"bili_uid\"value=\"%s\"></label>"                             \
-                         "<label class=\"input\"><span>数据更新周期（毫秒）</span><input type=\"text\"name=\"updataInterval\"value=\"%s\"></label>" \
-                         "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>"
-
-#define STOCK_SETTING "<form method=\"GET\" action=\"saveStockConf\">"                                                                                          \
-                      "<label class=\"input\"><span>股票代码,例如：sz000001或sh601126</span><input type=\"text\"name=\"stock_id\"value=\"%s\"></label>" \
-                      "<label class=\"input\"><span>数据更新周期（毫秒）</span><input type=\"text\"name=\"updataInterval\"value=\"%s\"></label>"      \
-                      "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>"
-
-#define PICTURE_SETTING "<form method=\"GET\" action=\"savePictureConf\">"                                                                                         \
-                        "<label class=\"input\"><span>自动切换时间间隔（毫秒）</span><input type=\"text\"name=\"switchInterval\"value=\"%s\"></label>" \
-                        "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>"
-
-#define MEDIA_SETTING "<form method=\"GET\" action=\"saveMediaConf\">"                                                                                             \
-                      "<label class=\"input\"><span>自动切换（0不切换 1自动切换）</span><input type=\"text\"name=\"switchFlag\"value=\"%s\"></label>" \
-                      "<label class=\"input\"><span>功耗控制（0低发热 1性能优先）</span><input type=\"text\"name=\"powerFlag\"value=\"%s\"></label>"  \
-                      "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>"
-
-#define SCREEN_SETTING "<form method=\"GET\" action=\"saveScreenConf\">"                                                                                           \
-                       "<label class=\"input\"><span>功耗控制（0低发热 1性能优先）</span><input type=\"text\"name=\"powerFlag\"value=\"%s\"></label>" \
-                       "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>"
-
-#define HEARTBEAT_SETTING "<form method=\"GET\" action=\"saveHeartbeatConf\">"                                                                            \
-                          "<label class=\"input\"><span>Role(0:heart,1:beat)</span><input type=\"text\"name=\"role\"value=\"%s\"></label>"                \
-                          "<label class=\"input\"><span>QQ num(填写QQ号)</span><input type=\"text\"name=\"qq_num\"value=\"%s\"></label>"                    \  
-                        "<label class=\"input\"><span>MQTT Server</span><input type=\"text\"name=\"mqtt_server\"value=\"%s\"></label>"                    \  
-                        "<label class=\"input\"><span>MQTT 端口号</span><input type=\"text\"name=\"mqtt_port\"value=\"%s\"></label>"                   \
-                        "<label class=\"input\"><span>MQTT 服务用户名(可不填)</span><input type=\"text\"name=\"mqtt_user\"value=\"%s\"></label>"  \
-                        "<label class=\"input\"><span>MQTT 服务密码(可不填)</span><input type=\"text\"name=\"mqtt_password\"value=\"%s\"></label>" \
-                        "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>"
-
-#define ANNIVERSARY_SETTING "<form method=\"GET\" action=\"saveAnniversaryConf\">"                                                      \
-                            "<label class=\"input\"><span>事件0</span><input type=\"text\"name=\"event_name0\"value=\"%s\"></label>"  \
-                            "<label class=\"input\"><span>日期0</span><input type=\"text\"name=\"target_date0\"value=\"%s\"></label>" \
-                            "<label class=\"input\"><span>事件1</span><input type=\"text\"name=\"event_name1\"value=\"%s\"></label>"  \
-                            "<label class=\"input\"><span>日期1</span><input type=\"text\"name=\"target_date1\"value=\"%s\"></label>" \
-                            "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>"
-
-#define REMOTR_SENSOR_SETTING "<form method=\"GET\" action=\"savePCResourceConf\">"                                                                                       \
-                              "<label class=\"input\"><span>PC地址</span><input type=\"text\"name=\"pc_ipaddr\"value=\"%s\"></label>"                                   \
-                              "<label class=\"input\"><span>传感器数据更新间隔(ms)</span><input type=\"text\"name=\"sensorUpdataInterval\"value=\"%s\"></label>" \
-                              "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>"
-
-void init_page_header()
-{
-    webpage_header = F("<!DOCTYPE html><html>");
-    webpage_header += F("<head>");
-    webpage_header += F("<title>HoloCubic WebServer</title>"); // NOTE: 1em = 16px
-    webpage_header += F("<meta http-equiv='Content-Type' name='viewport' content='user-scalable=yes,initial-scale=1.0,width=device-width; text/html; charset=utf-8' />");
-    webpage_header += F("<style>");
-    webpage_header += F(SETING_CSS);
-    webpage_header += F("body{max-width:65%;margin:0 auto;font-family:arial;font-size:105%;text-align:center;color:blue;background-color:#dbdadb;}");
-    webpage_header += F("ul{list-style-type:none;margin:0.1em;padding:0;border-radius:0.375em;overflow:hidden;background-color:#878588;font-size:1em;}");
-    webpage_header += F("li{float:left;border-radius:0.375em;border-right:0.06em solid #bbb;}last-child {border-right:none;font-size:85%}");
-    webpage_header += F("li a{display: block;border-radius:0.375em;padding:0.44em 0.44em;text-decoration:none;font-size:85%}");
-    webpage_header += F("li a:hover{background-color:#EAE3EA;border-radius:0.375em;font-size:85%}");
-    webpage_header += F("section {font-size:0.88em;}");
-    webpage_header += F("h1{color:white;border-radius:0.5em;font-size:1em;padding:0.2em 0.2em;background:#4c4c4d;}");
-    webpage_header += F("h2{color:orange;font-size:1.0em;}");
-    webpage_header += F("h3{font-size:0.8em;}");
-    webpage_header += F("table{font-family:arial,sans-serif;font-size:0.9em;border-collapse:collapse;width:85%;}");
-    webpage_header += F("th,td {border:0.06em solid #dddddd;text-align:left;padding:0.3em;border-bottom:0.06em solid #dddddd;}");
-    webpage_header += F("tr:nth-child(odd) {background-color:#eeeeee;}");
-    webpage_header += F(".rcorners_n {border-radius:0.5em;background:#558ED5;padding:0.3em 0.3em;width:20%;color:white;font-size:75%;}");
-    webpage_header += F(".rcorners_m {border-radius:0.5em;background:#558ED5;padding:0.3em 0.3em;width:50%;color:white;font-size:75%;}");
-    webpage_header += F(".rcorners_w {border-radius:0.5em;background:#558ED5;padding:0.3em 0.3em;width:70%;color:white;font-size:75%;}");
-    webpage_header += F(".column{float:left;width:50%;height:45%;}");
-    webpage_header += F(".row:after{content:'';display:table;clear:both;}");
-    webpage_header += F("*{box-sizing:border-box;}");
-    webpage_header += F("footer{background-color:#b1b1b1; text-align:center;padding:0.3em 0.3em;border-radius:0.375em;font-size:60%;}");
-    webpage_header += F("button{border-radius:0.5em;background:#558ED5;padding:0.3em 0.3em;width:20%;color:white;font-size:130%;}");
-    webpage_header += F(".buttons {border-radius:0.5em;background:#558ED5;padding:0.3em 0.3em;width:15%;color:white;font-size:80%;}");
-    webpage_header += F(".buttonsm{border-radius:0.5em;background:#558ED5;padding:0.3em 0.3em;width:9%; color:white;font-size:70%;}");
-    webpage_header += F(".buttonm {border-radius:0.5em;background:#558ED5;padding:0.3em 0.3em;width:15%;color:white;font-size:70%;}");
-    webpage_header += F(".buttonw {border-radius:0.5em;background:#558ED5;padding:0.3em 0.3em;width:40%;color:white;font-size:70%;}");
-    webpage_header += F("a{font-size:75%;}");
-    webpage_header += F("p{font-size:75%;}");
-
-    webpage_header += F("</style></head><body>");
-
-    webpage_header += F("<h1>HoloCubic_AIO ");
-    webpage_header += F(AIO_VERSION "</h1>");
-    webpage_header += F("<ul>");
-    webpage_header += F("<li><a href='/'>Home</a></li>"); // Lower Menu bar command entries
-    webpage_header += F("<li><a href='/download'>Download</a></li>");
-    webpage_header += F("<li><a href='/upload'>Upload</a></li>");
-    webpage_header += F("<li><a href='/delete'>Delete</a></li>");
-
-    webpage_header += F("<li><a href='/sys_setting'>系统设置</a></li>");
-
-    webpage_header += F("<li><a href='/rgb_setting'>RGB设置</a></li>");
+static const char WEATHER_SETTING[] PROGMEM =
+    "<form method=\"GET\" action=\"saveWeatherConf\">"
+    "<label class=\"input\"><span>TianQi Url</span><input type=\"text\"name=\"tianqi_url\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>城市名（或填6位城市代码）</span><input type=\"text\"name=\"tianqi_city_code\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>API的个人Key</span><input type=\"text\"name=\"tianqi_api_key\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>天气更新周期（毫秒）</span><input type=\"text\"name=\"weatherUpdataInterval\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>日期更新周期（毫秒）</span><input type=\"text\"name=\"timeUpdataInterval\"value=\"%s\"></label>"
+    "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>";
+
+static const char WEATHER_OLD_SETTING[] PROGMEM =
+    "<form method=\"GET\" action=\"saveWeatherOldConf\">"
+    "<label class=\"input\"><span>知心天气 城市名（拼音）</span><input type=\"text\"name=\"cityname\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>City Language(zh-Hans)</span><input type=\"text\"name=\"language\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>Weather Key</span><input type=\"text\"name=\"weather_key\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>天气更新周期（毫秒）</span><input type=\"text\"name=\"weatherUpdataInterval\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>日期更新周期（毫秒）</span><input type=\"text\"name=\"timeUpdataInterval\"value=\"%s\"></label>"
+    "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>";
+
+static const char BILIBILI_SETTING[] PROGMEM =
+    "<form method=\"GET\" action=\"saveBiliConf\">"
+    "<label class=\"input\"><span>Bili UID</span><input type=\"text\"name=\"bili_uid\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>数据更新周期（毫秒）</span><input type=\"text\"name=\"updataInterval\"value=\"%s\"></label>"
+    "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>";
+
+static const char STOCK_SETTING[] PROGMEM =
+    "<form method=\"GET\" action=\"saveStockConf\">"
+    "<label class=\"input\"><span>股票代码,例如：sz000001或sh601126</span><input type=\"text\"name=\"stock_id\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>数据更新周期（毫秒）</span><input type=\"text\"name=\"updataInterval\"value=\"%s\"></label>"
+    "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>";
+
+static const char PICTURE_SETTING[] PROGMEM =
+    "<form method=\"GET\" action=\"savePictureConf\">"
+    "<label class=\"input\"><span>自动切换时间间隔（毫秒）</span><input type=\"text\"name=\"switchInterval\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>jpg解码缓存上限（MB，0为关闭）</span><input type=\"text\"name=\"cacheSize\"value=\"%s\"></label>"
+    "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>";
+
+static const char MEDIA_SETTING[] PROGMEM =
+    "<form method=\"GET\" action=\"saveMediaConf\">"
+    "<label class=\"input\"><span>自动切换（0不切换 1自动切换）</span><input type=\"text\"name=\"switchFlag\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>功耗控制（0低发热 1性能优先）</span><input type=\"text\"name=\"powerFlag\"value=\"%s\"></label>"
+    "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>";
+
+static const char SCREEN_SETTING[] PROGMEM =
+    "<form method=\"GET\" action=\"saveScreenConf\">"
+    "<label class=\"input\"><span>功耗控制（0低发热 1性能优先）</span><input type=\"text\"name=\"powerFlag\"value=\"%s\"></label>"
+    "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>";
+
+static const char HEARTBEAT_SETTING[] PROGMEM =
+    "<form method=\"GET\" action=\"saveHeartbeatConf\">"
+    "<label class=\"input\"><span>Role(0:heart,1:beat)</span><input type=\"text\"name=\"role\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>QQ num(填写QQ号)</span><input type=\"text\"name=\"qq_num\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>MQTT Server</span><input type=\"text\"name=\"mqtt_server\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>MQTT 端口号</span><input type=\"text\"name=\"mqtt_port\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>MQTT 服务用户名(可不填)</span><input type=\"text\"name=\"mqtt_user\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>MQTT 服务密码(可不填)</span><input type=\"text\"name=\"mqtt_password\"value=\"%s\"></label>"
+    "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>";
+
+static const char ANNIVERSARY_SETTING[] PROGMEM =
+    "<form method=\"GET\" action=\"saveAnniversaryConf\">"
+    "<label class=\"input\"><span>事件0</span><input type=\"text\"name=\"event_name0\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>日期0</span><input type=\"text\"name=\"target_date0\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>事件1</span><input type=\"text\"name=\"event_name1\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>日期1</span><input type=\"text\"name=\"target_date1\"value=\"%s\"></label>"
+    "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>";
+
+static const char REMOTR_SENSOR_SETTING[] PROGMEM =
+    "<form method=\"GET\" action=\"savePCResourceConf\">"
+    "<label class=\"input\"><span>PC地址</span><input type=\"text\"name=\"pc_ipaddr\"value=\"%s\"></label>"
+    "<label class=\"input\"><span>传感器数据更新间隔(ms)</span><input type=\"text\"name=\"sensorUpdataInterval\"value=\"%s\"></label>"
+    "</label><input class=\"btn\" type=\"submit\" name=\"submit\" value=\"保存\"></form>";
+
+// 所有页面共用的页头（样式与菜单）
+static const char PAGE_HEADER[] PROGMEM =
+    "<!DOCTYPE html><html>"
+    "<head>"
+    "<title>HoloCubic WebServer</title>"
+    "<meta http-equiv='Content-Type' name='viewport' content='user-scalable=yes,initial-scale=1.0,width=device-width; text/html; charset=utf-8' />"
+    // 样式与脚本作为静态资源单独获取 浏览器可以缓存
+    "<link rel='stylesheet' href='/style.css?v=%s'>"
+    "<script src='/app.js?v=%s' defer></script>"
+    "</head><body>"
+    "<h1>HoloCubic_AIO "
+    AIO_VERSION "</h1>"
+    "<ul>"
+    "<li><a href='/'>Home</a></li>" // Lower Menu bar command entries
+    "<li><a href='/download'>Download</a></li>"
+    "<li><a href='/upload'>Upload</a></li>"
+    "<li><a href='/delete'>Delete</a></li>"
+    "<li><a href='/sys_setting'>系统设置</a></li>"
+    "<li><a href='/rgb_setting'>RGB设置</a></li>"
 #if APP_WEATHER_USE
-    webpage_header += F("<li><a href='/weather_setting'>新版天气</a></li>");
+    "<li><a href='/weather_setting'>新版天气</a></li>"
 #endif
 #if APP_WEATHER_OLD_USE
-    webpage_header += F("<li><a href='/weather_old_setting'>旧版天气</a></li>");
+    "<li><a href='/weather_old_setting'>旧版天气</a></li>"
 #endif
 #if APP_BILIBILI_FANS_USE
-    webpage_header += F("<li><a href='/bili_setting'>B站</a></li>");
+    "<li><a href='/bili_setting'>B站</a></li>"
 #endif
 #if APP_PICTURE_USE
-    webpage_header += F("<li><a href='/picture_setting'>相册</a></li>");
+    "<li><a href='/picture_setting'>相册</a></li>"
 #endif
 #if APP_MEDIA_PLAYER_USE
-    webpage_header += F("<li><a href='/media_setting'>媒体播放器</a></li>");
+    "<li><a href='/media_setting'>媒体播放器</a></li>"
 #endif
 #if APP_SCREEN_SHARE_USE
-    webpage_header += F("<li><a href='/screen_setting'>屏幕分享</a></li>");
+    "<li><a href='/screen_setting'>屏幕分享</a></li>"
 #endif
 #if APP_HEARTBEAT_USE
-    webpage_header += F("<li><a href='/heartbeat_setting'>心跳</a></li>");
+    "<li><a href='/heartbeat_setting'>心跳</a></li>"
 #endif
 #if APP_ANNIVERSARY_USE
-    webpage_header += F("<li><a href='/anniversary_setting'>纪念日</a></li>");
+    "<li><a href='/anniversary_setting'>纪念日</a></li>"
 #endif
 #if APP_STOCK_MARKET_USE
-    webpage_header += F("<li><a href='/stock_setting'>股票行情</a></li>");
+    "<li><a href='/stock_setting'>股票行情</a></li>"
 #endif
 #if APP_PC_RESOURCE_USE
-    webpage_header += F("<li><a href='/pc_resource_setting'>PC资源监控</a></li>");
+    "<li><a href='/pc_resource_setting'>PC资源监控</a></li>"
 #endif
-    webpage_header += F("</ul>");
+    "<li><a href='/app_stats'>APP统计</a></li>"
+    "</ul>";
+
+static const char PAGE_FOOTER[] PROGMEM =
+    "<footer>&copy;ClimbSnail 2021</footer>"
+    "</body></html>";
+
+static void send_page_begin(PageWriter *page)
+{
+    server->sendHeader("Cache-Control", "no-cache, no-store, must-revalidate");
+    server->sendHeader("Pragma", "no-cache");
+    server->sendHeader("Expires", "-1");
+    page->begin(200, "text/html");
+    const char *values[] = {web_assets_version, web_assets_version};
+    page->render_P(PAGE_HEADER, values, sizeof(values) / sizeof(values[0]));
 }
 
-void init_page_footer()
+void Send_HTML(const String &content)
 {
-    webpage_footer = F("<footer>&copy;ClimbSnail 2021</footer>");
-    webpage_footer += F("</body></html>");
+    // 检查客户端是否仍然连接
+    if (!server->client().connected()) {
+        return;
+    }
+
+    // 页头、内容、页尾依次分块发送 不再拼接成完整的页面
+    PageWriter page(server);
+    send_page_begin(&page);
+    page.print(content);
+    page.print_P(PAGE_FOOTER);
+    page.end();
+}
+
+void Send_HTML(const __FlashStringHelper *content)
+{
+    if (!server->client().connected()) {
+        return;
+    }
+
+    PageWriter page(server);
+    send_page_begin(&page);
+    page.print_P((PGM_P)content);
+    page.print_P(PAGE_FOOTER);
+    page.end();
+}
+
+// 用values依次替换模板中的"%s"后发送
+void Send_Page(PGM_P tmpl, const char *const *values, int num)
+{
+    if (!server->client().connected()) {
+        return;
+    }
+
+    PageWriter page(server);
+    send_page_begin(&page);
+    page.render_P(tmpl, values, num);
+    page.print_P(PAGE_FOOTER);
+    page.end();
+}
+
+// 发送gzip压缩的静态资源 浏览器带上相同的ETag再次请求时只回复304
+void Send_Asset(const WebAsset *asset)
+{
+    server->sendHeader("ETag", asset->etag);
+    // 引用资源的URL中带有版本号 资源更新后URL随之改变 因此可以长时间缓存
+    server->sendHeader("Cache-Control", "public, max-age=604800");
+    if (server->hasHeader("If-None-Match") &&
+        server->header("If-None-Match").indexOf(asset->etag) >= 0)
+    {
+        server->send(304);
+        return;
+    }
+    server->sendHeader("Content-Encoding", "gzip");
+    server->send_P(200, asset->content_type, (PGM_P)asset->data, asset->len);
+}
+
+#if METRICS_ENABLE
+// Prometheus文本格式的运行指标
+void Send_Metrics(void)
+{
+    PageWriter page(server);
+    page.begin(200, "text/plain; version=0.0.4");
+    metrics_print(&page);
+    page.end();
+}
+#endif
+
+// 各APP的耗时与内存统计
+void app_stats(void)
+{
+    if (!server->client().connected()) {
+        return;
+    }
+
+    PageWriter page(server);
+    send_page_begin(&page);
+    page.print_P(PSTR("<h3>APP运行统计（时间单位ms 内存单位字节）</h3><table>"
+                      "<tr><th>APP</th><th>初始化 次数/平均/最大</th><th>运行 次数/平均/最大</th>"
+                      "<th>退出 次数/平均/最大</th><th>初始化占用</th><th>退出未归还</th>"
+                      "<th>最大未归还</th><th>消息数</th></tr>"));
+    for (unsigned int pos = 0; pos < app_controller->get_app_num(); ++pos)
+    {
+        const APP_STATS *stats = app_controller->get_app_stats(pos);
+        const APP_TIME_STATS *times[] = {&stats->init, &stats->main, &stats->exit};
+        page.printf("<tr><td>%s</td>", app_controller->get_app(pos)->app_name);
+        for (int i = 0; i < 3; ++i)
+        {
+            uint32_t avg = 0 == times[i]->count ? 0 : times[i]->total_us / times[i]->count;
+            page.printf("<td>%u/%.1f/%.1f</td>", times[i]->count,
+                        avg / 1000.0, times[i]->max_us / 1000.0);
+        }
+        page.printf("<td>%d</td><td>%d</td><td>%d</td><td>%u</td></tr>",
+                    stats->init_heap, stats->leak_heap, stats->leak_max,
+                    stats->send_count);
+    }
+    page.print_P(PSTR("</table>"));
+    page.print_P(PAGE_FOOTER);
+    page.end();
 }
 
 // All supporting functions from here...
 void HomePage()
 {
     // 指定 target='_blank' 设置新建页面
-    webpage = F("<a href='https://github.com/ClimbSnail/HoloCubic_AIO' target='_blank'><button>Github</button></a>");
-    webpage += F("<a href='https://space.bilibili.com/344470052?spm_id_from=333.788.b_765f7570696e666f.1' target='_blank'><button>BiliBili教程</button></a>");
-    Send_HTML(webpage);
+    Send_HTML(F("<a href='https://github.com/ClimbSnail/HoloCubic_AIO' target='_blank'><button>Github</button></a>"
+                "<a href='https://space.bilibili.com/344470052?spm_id_from=333.788.b_765f7570696e666f.1' target='_blank'><button>BiliBili教程</button></a>"));
 }
 
 void sys_setting()
 {
-    char buf[2048];
     char ssid_0[32];
     char password_0[32];
     char power_mode[32];
@@ -285,31 +340,18 @@ void sys_setting()
                             (void *)"auto_calibration_mpu", auto_calibration_mpu);
     app_controller->send_to(SERVER_APP_NAME, "AppCtrl", APP_MESSAGE_GET_PARAM,
                             (void *)"auto_start_app", auto_start_app);
-    SysUtilConfig cfg = app_controller->sys_cfg;
     // 主要为了处理启停MPU自动校准的单选框
-    if (0 == cfg.auto_calibration_mpu)
-    {
-        sprintf(buf, SYS_SETTING,
-                ssid_0, password_0,
-                power_mode, backLight, backLight, rotation,
-                mpu_order, "checked=\"checked\"", "",
-                auto_start_app);
-    }
-    else
-    {
-        sprintf(buf, SYS_SETTING,
-                ssid_0, password_0,
-                power_mode, backLight, backLight, rotation,
-                mpu_order, "", "checked=\"checked\"",
-                auto_start_app);
-    }
-    webpage = buf;
-    Send_HTML(webpage);
+    const char *checked = "checked=\"checked\"";
+    bool calibration = 0 != app_controller->sys_cfg.auto_calibration_mpu;
+    const char *values[] = {ssid_0, password_0,
+                            power_mode, backLight, backLight, rotation,
+                            mpu_order, calibration ? "" : checked, calibration ? checked : "",
+                            auto_start_app};
+    Send_Page(SYS_SETTING, values, sizeof(values) / sizeof(values[0]));
 }
 
 void rgb_setting()
 {
-    char buf[2048];
     char min_brightness[32];
     char max_brightness[32];
     char time[32];
@@ -338,18 +380,15 @@ void rgb_setting()
                             (void *)"brightness_night_mode_end", brightness_night_mode_end);
 
     
-    sprintf(buf, RGB_SETTING,
-            min_brightness, max_brightness, time, 
-            brightness_night_mode_specified,brightness_night_mode_specified,
-            brightness_night_mode_start, 
-            brightness_night_mode_end);
-    webpage = buf;
-    Send_HTML(webpage);
+    const char *values[] = {min_brightness, max_brightness, time,
+                            brightness_night_mode_specified, brightness_night_mode_specified,
+                            brightness_night_mode_start,
+                            brightness_night_mode_end};
+    Send_Page(RGB_SETTING, values, sizeof(values) / sizeof(values[0]));
 }
 
 void weather_setting()
 {
-    char buf[2048];
     char tianqi_url[128];
     char tianqi_city_code[32];
     char tianqi_api_key[40];
@@ -368,18 +407,15 @@ void weather_setting()
                             (void *)"weatherUpdataInterval", weatherUpdataInterval);
     app_controller->send_to(SERVER_APP_NAME, "Weather", APP_MESSAGE_GET_PARAM,
                             (void *)"timeUpdataInterval", timeUpdataInterval);
-    sprintf(buf, WEATHER_SETTING,
-            tianqi_url, tianqi_city_code,
-            tianqi_api_key,
-            weatherUpdataInterval,
-            timeUpdataInterval);
-    webpage = buf;
-    Send_HTML(webpage);
+    const char *values[] = {tianqi_url, tianqi_city_code,
+                            tianqi_api_key,
+                            weatherUpdataInterval,
+                            timeUpdataInterval};
+    Send_Page(WEATHER_SETTING, values, sizeof(values) / sizeof(values[0]));
 }
 
 void weather_old_setting()
 {
-    char buf[2048];
     char cityname[32];
     char language[32];
     char weather_key[32];
@@ -398,19 +434,16 @@ void weather_old_setting()
                             (void *)"weatherUpdataInterval", weatherUpdataInterval);
     app_controller->send_to(SERVER_APP_NAME, "Weather Old", APP_MESSAGE_GET_PARAM,
                             (void *)"timeUpdataInterval", timeUpdataInterval);
-    sprintf(buf, WEATHER_OLD_SETTING,
-            cityname,
-            language,
-            weather_key,
-            weatherUpdataInterval,
-            timeUpdataInterval);
-    webpage = buf;
-    Send_HTML(webpage);
+    const char *values[] = {cityname,
+                            language,
+                            weather_key,
+                            weatherUpdataInterval,
+                            timeUpdataInterval};
+    Send_Page(WEATHER_OLD_SETTING, values, sizeof(values) / sizeof(values[0]));
 }
 
 void bili_setting()
 {
-    char buf[2048];
     char bili_uid[32];
     char updataInterval[32];
     // 读取数据
@@ -420,14 +453,12 @@ void bili_setting()
                             (void *)"bili_uid", bili_uid);
     app_controller->send_to(SERVER_APP_NAME, "Bili", APP_MESSAGE_GET_PARAM,
                             (void *)"updataInterval", updataInterval);
-    sprintf(buf, BILIBILI_SETTING, bili_uid, updataInterval);
-    webpage = buf;
-    Send_HTML(webpage);
+    const char *values[] = {bili_uid, updataInterval};
+    Send_Page(BILIBILI_SETTING, values, sizeof(values) / sizeof(values[0]));
 }
 
 void stock_setting()
 {
-    char buf[2048];
     char bili_uid[32];
     char updataInterval[32];
     // 读取数据
@@ -437,28 +468,27 @@ void stock_setting()
                             (void *)"stock_id", bili_uid);
     app_controller->send_to(SERVER_APP_NAME, "Stock", APP_MESSAGE_GET_PARAM,
                             (void *)"updataInterval", updataInterval);
-    sprintf(buf, STOCK_SETTING, bili_uid, updataInterval);
-    webpage = buf;
-    Send_HTML(webpage);
+    const char *values[] = {bili_uid, updataInterval};
+    Send_Page(STOCK_SETTING, values, sizeof(values) / sizeof(values[0]));
 }
 
 void picture_setting()
 {
-    char buf[2048];
     char switchInterval[32];
+    char cacheSize[32];
     // 读取数据
     app_controller->send_to(SERVER_APP_NAME, "Picture", APP_MESSAGE_READ_CFG,
                             NULL, NULL);
     app_controller->send_to(SERVER_APP_NAME, "Picture", APP_MESSAGE_GET_PARAM,
                             (void *)"switchInterval", switchInterval);
-    sprintf(buf, PICTURE_SETTING, switchInterval);
-    webpage = buf;
-    Send_HTML(webpage);
+    app_controller->send_to(SERVER_APP_NAME, "Picture", APP_MESSAGE_GET_PARAM,
+                            (void *)"cacheSize", cacheSize);
+    const char *values[] = {switchInterval, cacheSize};
+    Send_Page(PICTURE_SETTING, values, sizeof(values) / sizeof(values[0]));
 }
 
 void media_setting()
 {
-    char buf[2048];
     char switchFlag[32];
     char powerFlag[32];
     // 读取数据
@@ -468,28 +498,24 @@ void media_setting()
                             (void *)"switchFlag", switchFlag);
     app_controller->send_to(SERVER_APP_NAME, "Media", APP_MESSAGE_GET_PARAM,
                             (void *)"powerFlag", powerFlag);
-    sprintf(buf, MEDIA_SETTING, switchFlag, powerFlag);
-    webpage = buf;
-    Send_HTML(webpage);
+    const char *values[] = {switchFlag, powerFlag};
+    Send_Page(MEDIA_SETTING, values, sizeof(values) / sizeof(values[0]));
 }
 
 void screen_setting()
 {
-    char buf[2048];
     char powerFlag[32];
     // 读取数据
     app_controller->send_to(SERVER_APP_NAME, "Screen share", APP_MESSAGE_READ_CFG,
                             NULL, NULL);
     app_controller->send_to(SERVER_APP_NAME, "Screen share", APP_MESSAGE_GET_PARAM,
                             (void *)"powerFlag", powerFlag);
-    sprintf(buf, SCREEN_SETTING, powerFlag);
-    webpage = buf;
-    Send_HTML(webpage);
+    const char *values[] = {powerFlag};
+    Send_Page(SCREEN_SETTING, values, sizeof(values) / sizeof(values[0]));
 }
 
 void heartbeat_setting()
 {
-    char buf[2048];
     char role[32];
     char qq_num[32];
     char subtopic[32];
@@ -516,15 +542,13 @@ void heartbeat_setting()
     app_controller->send_to(SERVER_APP_NAME, "Heartbeat", APP_MESSAGE_GET_PARAM,
                             (void *)"mqtt_password", mqtt_password);
 
-    sprintf(buf, HEARTBEAT_SETTING, role, qq_num, mqtt_server,
-            mqtt_port, mqtt_user, mqtt_password);
-    webpage = buf;
-    Send_HTML(webpage);
+    const char *values[] = {role, qq_num, mqtt_server,
+                            mqtt_port, mqtt_user, mqtt_password};
+    Send_Page(HEARTBEAT_SETTING, values, sizeof(values) / sizeof(values[0]));
 }
 
 void anniversary_setting()
 {
-    char buf[2048];
     char event_name0[32];
     char target_date0[32];
     char event_name1[32];
@@ -540,14 +564,12 @@ void anniversary_setting()
                             (void *)"event_name1", event_name1);
     app_controller->send_to(SERVER_APP_NAME, "Anniversary", APP_MESSAGE_GET_PARAM,
                             (void *)"target_date1", target_date1);
-    sprintf(buf, ANNIVERSARY_SETTING, event_name0, target_date0, event_name1, target_date1);
-    webpage = buf;
-    Send_HTML(webpage);
+    const char *values[] = {event_name0, target_date0, event_name1, target_date1};
+    Send_Page(ANNIVERSARY_SETTING, values, sizeof(values) / sizeof(values[0]));
 }
 
 void pc_resource_setting()
 {
-    char buf[2048];
     char pc_ipaddr[32];
     char sensorUpdataInterval[32];
     // 读取数据
@@ -557,9 +579,8 @@ void pc_resource_setting()
                             (void *)"pc_ipaddr", pc_ipaddr);
     app_controller->send_to(SERVER_APP_NAME, "PC Resource", APP_MESSAGE_GET_PARAM,
                             (void *)"sensorUpdataInterval", sensorUpdataInterval);
-    sprintf(buf, REMOTR_SENSOR_SETTING, pc_ipaddr, sensorUpdataInterval);
-    webpage = buf;
-    Send_HTML(webpage);
+    const char *values[] = {pc_ipaddr, sensorUpdataInterval};
+    Send_Page(REMOTR_SENSOR_SETTING, values, sizeof(values) / sizeof(values[0]));
 }
 
 void saveSysConf(void)
@@ -734,6 +755,10 @@ void savePictureConf(void)
                             APP_MESSAGE_SET_PARAM,
                             (void *)"switchInterval",
                             (void *)server->arg("switchInterval").c_str());
+    app_controller->send_to(SERVER_APP_NAME, "Picture",
+                            APP_MESSAGE_SET_PARAM,
+                            (void *)"cacheSize",
+                            (void *)server->arg("cacheSize").c_str());
     // 持久化数据
     app_controller->send_to(SERVER_APP_NAME, "Picture", APP_MESSAGE_WRITE_CFG,
                             NULL, NULL);
@@ -855,15 +880,14 @@ void delete_result(void)
     boolean ret = tf.deleteFile(del_file);
     if (ret)
     {
-        webpage = "<h3>Delete succ!</h3><a href='/delete'>[Back]</a>";
+        Send_HTML(F("<h3>Delete succ!</h3><a href='/delete'>[Back]</a>"));
         tf.listDir("/image", 250);
     }
     else
     {
-        webpage = "<h3>Delete fail! Please check up file path.</h3><a href='/delete'>[Back]</a>";
+        Send_HTML(F("<h3>Delete fail! Please check up file path.</h3><a href='/delete'>[Back]</a>"));
     }
     tf.listDir("/image", 250);
-    Send_HTML(webpage);
 }
 
 void File_Download()
@@ -871,126 +895,188 @@ void File_Download()
     if (server->args() > 0)
     { // Arguments were received
         if (server->hasArg("download"))
-            sd_file_download(server->arg(0));
+            sd_file_download(server->arg("download"), true);
+        else if (server->hasArg("file"))
+            sd_file_download(server->arg("file"), false); // 浏览器直接显示/播放
     }
     else
         SelectInput("Enter filename to download", "download", "download");
 }
 
-void sd_file_download(const String &filename)
+// 按扩展名给出类型 浏览器可以直接播放/显示并拖动进度
+static const char *download_content_type(const String &filename)
+{
+    String name = filename;
+    name.toLowerCase();
+    if (name.endsWith(".jpg") || name.endsWith(".jpeg"))
+        return "image/jpeg";
+    if (name.endsWith(".bmp"))
+        return "image/bmp";
+    if (name.endsWith(".gif"))
+        return "image/gif";
+    if (name.endsWith(".mp4"))
+        return "video/mp4";
+    if (name.endsWith(".json") || name.endsWith(".txt"))
+        return "text/plain";
+    return "application/octet-stream";
+}
+
+static size_t download_read(void *ctx, uint8_t *buf, size_t len)
+{
+    return ((File *)ctx)->read(buf, len);
+}
+
+static size_t download_write(void *ctx, const uint8_t *buf, size_t len)
+{
+    WiFiClient *client = (WiFiClient *)ctx;
+    return client->connected() ? client->write(buf, len) : 0;
+}
+
+void sd_file_download(const String &filename, bool attachment)
 {
-    if (sd_present)
+    if (!sd_present)
     {
-        File download = tf.open("/" + filename);
-        if (download)
-        {
-            server->sendHeader("Content-Type", "text/text");
-            server->sendHeader("Content-Disposition", "attachment; filename=" + filename);
-            server->sendHeader("Connection", "close");
-            server->streamFile(download, "application/octet-stream");
-            download.close();
-        }
-        else
-            ReportFileNotPresent(String("download"));
-    }
-    else
         ReportSDNotPresent();
+        return;
+    }
+
+    File download = tf.open("/" + filename);
+    if (!download || download.isDirectory())
+    {
+        ReportFileNotPresent(String("download"));
+        return;
+    }
+
+    String range = server->header("Range"); // 没有时为空字符串
+    String since = server->header("If-Modified-Since");
+    HttpDownloadPlan plan;
+    http_download_plan(range.c_str(), since.c_str(), download.size(), download.getLastWrite(), &plan);
+
+    server->sendHeader("Accept-Ranges", "bytes");
+    if ('\0' != plan.last_modified[0])
+    {
+        server->sendHeader("Last-Modified", plan.last_modified);
+    }
+    if ('\0' != plan.content_range[0])
+    {
+        server->sendHeader("Content-Range", plan.content_range);
+    }
+    if (304 == plan.code || 416 == plan.code)
+    {
+        server->send(plan.code);
+        download.close();
+        return;
+    }
+
+    // 读卡缓冲区从开机时保留的池中租借 不在每次请求时申请释放
+    BufLease lease = {};
+    uint8_t *buf = buf_lease(&lease, BUF_STRIP, DOWNLOAD_BUF_OWNER);
+    if (NULL == buf)
+    {
+        server->send(503, "text/plain", "No memory");
+        download.close();
+        return;
+    }
+
+    if (attachment)
+    {
+        server->sendHeader("Content-Disposition", "attachment; filename=" + filename);
+    }
+    server->sendHeader("Connection", "close");
+    server->setContentLength(plan.len);
+    server->send(plan.code, download_content_type(filename), "");
+
+    WiFiClient client = server->client();
+    download.seek(plan.start);
+    uint32_t sent = http_copy_body(download_read, &download, download_write, &client,
+                                   buf, lease.size, plan.len);
+    METRIC_ADD(METRIC_SD_READ_BYTES, sent);
+
+    buf_return(&lease, DOWNLOAD_BUF_OWNER);
+    download.close();
 }
 
 void File_Upload()
 {
-    tf.listDir("/image", 250);
-
-    webpage = webpage_header;
-    webpage += "<h3>Select File to Upload</h3>"
-               "<FORM action='/fupload' method='post' enctype='multipart/form-data'>"
-               "<input class='buttons' style='width:40%' type='file' name='fupload' id = 'fupload' value=''><br>"
-               "<br><button class='buttons' style='width:10%' type='submit'>Upload File</button><br>"
-               "<a href='/'>[Back]</a><br><br>";
-    webpage += webpage_footer;
-    server->send(200, "text/html", webpage);
+    Send_HTML(F("<h3>Select File to Upload</h3>"
+                "<FORM action='/fupload' method='post' enctype='multipart/form-data'>"
+                "<input class='buttons' style='width:40%' type='file' name='fupload' id = 'fupload' value=''><br>"
+                "<br><button class='buttons' style='width:10%' type='submit'>Upload File</button><br>"
+                "<a href='/'>[Back]</a><br><br>"));
 }
 
-File UploadFile;
 void handleFileUpload()
 {                                                   // upload a new file to the Filing system
     HTTPUpload &uploadFileStream = server->upload(); // See https://github.com/esp8266/Arduino/tree/master/libraries/ESP8266WebServer/srcv
                                                     // For further information on 'status' structure, there are other reasons such as a failed transfer that could be used
-    String filename = uploadFileStream.filename;
+    String filename = "/image/" + uploadFileStream.filename;
     if (uploadFileStream.status == UPLOAD_FILE_START)
     {
-        // String filename = uploadFileStream.filename;
-        // if (!filename.startsWith("/image"))
-        filename = "/image/" + filename;
         Serial.print(F("Upload File Name: "));
         Serial.println(filename);
-        tf.deleteFile(filename);                    // Remove a previous version, otherwise data is appended the file again
-        UploadFile = tf.open(filename, FILE_WRITE); // Open the file for writing in SPIFFS (create it, if doesn't exist)
+        // 数据先攒成大块 再由后台任务写入SD卡 接收与写卡同时进行
+        upload_writer_begin(filename);
     }
     else if (uploadFileStream.status == UPLOAD_FILE_WRITE)
     {
-        if (UploadFile)
-            UploadFile.write(uploadFileStream.buf, uploadFileStream.currentSize); // Write the received bytes to the file
+        upload_writer_write(uploadFileStream.buf, uploadFileStream.currentSize);
     }
     else if (uploadFileStream.status == UPLOAD_FILE_END)
     {
-        if (UploadFile) // If the file was successfully created
+        UploadStats stats;
+        if (upload_writer_end(false, &stats)) // If the file was successfully created
         {
-            UploadFile.close(); // Close the file again
-            Serial.print(F("Upload Size: "));
-            Serial.println(uploadFileStream.totalSize);
-            webpage = webpage_header;
-            webpage += F("<h3>File was successfully uploaded</h3>");
-            webpage += F("<h2>Uploaded File Name: ");
-            webpage += filename + "</h2>";
-            webpage += F("<h2>File Size: ");
-            webpage += file_size(uploadFileStream.totalSize) + "</h2><br>";
-            webpage += webpage_footer;
-            server->send(200, "text/html", webpage);
-            tf.listDir("/image", 250);
+            String size = file_size(uploadFileStream.totalSize);
+            String speed = String(stats.kb_per_s / 1024.0, 2) + " MB/s";
+            const char *values[] = {filename.c_str(), size.c_str(), speed.c_str()};
+            Send_Page(PSTR("<h3>File was successfully uploaded</h3>"
+                           "<h2>Uploaded File Name: %s</h2>"
+                           "<h2>File Size: %s</h2>"
+                           "<h2>Speed: %s</h2><br>"),
+                      values, sizeof(values) / sizeof(values[0]));
         }
         else
         {
             ReportCouldNotCreateFile(String("upload"));
         }
     }
+    else if (uploadFileStream.status == UPLOAD_FILE_ABORTED)
+    {
+        upload_writer_end(true, NULL);
+    }
 }
 
 void SelectInput(String heading, String command, String arg_calling_name)
 {
-    webpage = F("<h3>");
-    webpage += heading + "</h3>";
-    webpage += F("<FORM action='/");
-    webpage += command + "' method='post'>"; // Must match the calling argument e.g. '/chart' calls '/chart' after selection but with arguments!
-    webpage += F("<input type='text' name='");
-    webpage += arg_calling_name;
-    webpage += F("' value=''><br>");
-    webpage += F("<type='submit' name='");
-    webpage += arg_calling_name;
-    webpage += F("' value=''><br>");
-    webpage += F("<a href='/'>[Back]</a>");
-    Send_HTML(webpage);
+    // command must match the calling argument e.g. '/chart' calls '/chart' after selection but with arguments!
+    const char *values[] = {heading.c_str(), command.c_str(),
+                            arg_calling_name.c_str(), arg_calling_name.c_str()};
+    Send_Page(PSTR("<h3>%s</h3>"
+                   "<FORM action='/%s' method='post'>"
+                   "<input type='text' name='%s' value=''><br>"
+                   "<type='submit' name='%s' value=''><br>"
+                   "<a href='/'>[Back]</a>"),
+              values, sizeof(values) / sizeof(values[0]));
 }
 
 void ReportSDNotPresent()
 {
-    webpage = F("<h3>No SD Card present</h3>");
-    webpage += F("<a href='/'>[Back]</a><br><br>");
-    Send_HTML(webpage);
+    Send_HTML(F("<h3>No SD Card present</h3>"
+                "<a href='/'>[Back]</a><br><br>"));
 }
 
 void ReportFileNotPresent(const String &target)
 {
-    webpage = F("<h3>File does not exist</h3>");
-    webpage += F("<a href='/");
-    webpage += target + "'>[Back]</a><br><br>";
-    Send_HTML(webpage);
+    const char *values[] = {target.c_str()};
+    Send_Page(PSTR("<h3>File does not exist</h3>"
+                   "<a href='/%s'>[Back]</a><br><br>"),
+              values, 1);
 }
 
 void ReportCouldNotCreateFile(const String &target)
 {
-    webpage = F("<h3>Could Not Create Uploaded File (write-protected?)</h3>");
-    webpage += F("<a href='/");
-    webpage += target + "'>[Back]</a><br><br>";
-    Send_HTML(webpage);
+    const char *values[] = {target.c_str()};
+    Send_Page(PSTR("<h3>Could Not Create Uploaded File (write-protected?)</h3>"
+                   "<a href='/%s'>[Back]</a><br><br>"),
+              values, 1);
 }
\ No newline at end of file
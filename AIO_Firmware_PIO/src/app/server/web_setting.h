@@ -3,11 +3,12 @@
 
 #include <WString.h>
 #include "sys/app_controller.h"
+#include "web_assets.h"
 
 extern AppController *app_controller; // APP控制器
-void init_page_header(void);
-void init_page_footer(void);
 void HomePage(void);
+void Send_Asset(const WebAsset *asset);
+void Send_Metrics(void);
 
 void File_Download(void);
 void File_Upload(void);
@@ -27,6 +28,7 @@ void screen_setting(void);
 void heartbeat_setting(void);
 void anniversary_setting(void);
 void pc_resource_setting();
+void app_stats(void);
 
 void saveSysConf(void);
 void saveRgbConf(void);
@@ -41,7 +43,8 @@ void saveHeartbeatConf(void);
 void saveAnniversaryConf(void);
 void savePCResourceConf(void);
 
-void sd_file_download(const String &filename);
+// attachment为true时让浏览器保存为文件 否则按类型直接显示/播放
+void sd_file_download(const String &filename, bool attachment);
 void SelectInput(String heading, String command, String arg_calling_name);
 void ReportSDNotPresent(void);
 void ReportFileNotPresent(const String &target);
@@ -4,6 +4,7 @@
 #include "../../common.h"
 
 // STOCKmarket的持久化配置
+#define B_CONFIG_NS "stockmarket"
 #define B_CONFIG_PATH "/stockmarket.cfg"
 struct B_Config
 {
@@ -11,41 +12,26 @@ struct B_Config
     unsigned long updataInterval; // 更新的时间间隔(s)
 };
 
+static const char *const stockmarket_cfg_keys[] = {"stock_id", "updataInterval"};
+
 static void write_config(const B_Config *cfg)
 {
-    char tmp[16];
-    // 将配置数据保存在文件中（持久化）
-    String w_data;
-    w_data = w_data + cfg->stock_id + "\n";
-    memset(tmp, 0, 16);
-    snprintf(tmp, 16, "%lu\n", cfg->updataInterval);
-    w_data += tmp;
-    g_flashCfg.writeFile(B_CONFIG_PATH, w_data.c_str());
+    // 将配置数据保存在配置存储中（持久化）
+    g_cfgStore.setString(B_CONFIG_NS, "stock_id", cfg->stock_id.c_str());
+    g_cfgStore.setUInt(B_CONFIG_NS, "updataInterval", cfg->updataInterval);
+    g_cfgStore.commit();
 }
 
 static void read_config(B_Config *cfg)
 {
-    // 如果有需要持久化配置文件 可以调用此函数将数据存在flash中
-    // 配置文件名最好以APP名为开头 以".cfg"结尾，以免多个APP读取混乱
-    char info[128] = {0};
-    uint16_t size = g_flashCfg.readFile(B_CONFIG_PATH, (uint8_t *)info);
-    info[size] = 0;
-    if (size == 0)
+    bool exist = g_cfgStore.migrate(B_CONFIG_NS, B_CONFIG_PATH, stockmarket_cfg_keys);
+    // 默认值
+    cfg->stock_id = g_cfgStore.getString(B_CONFIG_NS, "stock_id", "sh601126");      // 股票代码
+    cfg->updataInterval = g_cfgStore.getUInt(B_CONFIG_NS, "updataInterval", 10000); // 更新的时间间隔10000(10s)
+    if (!exist)
     {
-        // 默认值
-        cfg->stock_id = "sh601126";  // 股票代码
-        cfg->updataInterval = 10000; // 更新的时间间隔10000(10s)
         write_config(cfg);
     }
-    else
-    {
-        // 解析数据
-        char *param[2] = {0};
-        analyseParam(info, 2, param);
-        cfg->stock_id = param[0];
-        cfg->updataInterval = atol(param[1]);
-    }
-    //    cfg->stock_id = "sh601126";  // 股票代码
 }
 
 struct StockmarketAppRunData
@@ -110,6 +96,8 @@ static int stockmarket_init(AppController *sys)
     run_data->refresh_time_millis = GET_SYS_MILLIS() - cfg_data.updataInterval;
 
     display_stockmarket(run_data->stockdata, LV_SCR_LOAD_ANIM_NONE);
+    // 没有动作时每300ms处理一次
+    sys->set_process_interval(300);
     return 0;
 }
 
@@ -131,8 +119,6 @@ static void stockmarket_process(AppController *sys,
         sys->send_to(STOCK_APP_NAME, CTRL_NAME,
                      APP_MESSAGE_WIFI_CONN, NULL, NULL);
     }
-
-    delay(300);
 }
 
 static void stockmarket_background_task(AppController *sys,
@@ -4,6 +4,8 @@
 #include "common.h"
 #include "ESP32Time.h"
 #define TOMATO_APP_NAME "Tomato"
+#define TOMATO_RGB_NORMAL "tomato"      // 计时中的灯效
+#define TOMATO_RGB_ALARM "tomato_alarm" // 到点提醒的灯效
 #define ON 1
 #define OFF 0
 
@@ -14,10 +16,8 @@ struct TomatoAppRunData
     unsigned long time_ms;    // 毫秒数,对应倒计时显示的时间
     TimeStr t;                // 时间结构体
     TimeStr t_start;          // 倒计时结构体
-    RgbConfig rgb_cfg;        // 灯效
     bool rgb_fast;            // 使能
     bool rgb_fast_update;     // 标志位
-    RgbParam rgb_setting;     // rgb参数
     int time_mode;            // 倒计时种类
     uint8_t switch_count;     // 切换次数，用于消抖
     ACTIVE_TYPE lastAct;
@@ -37,6 +37,15 @@ static TomatoAppRunData *run_data = NULL;
 // 考虑到所有的APP公用内存，尽量减少 forever_data 的数据占用
 static TomatoAppForeverData forever_data;
 
+// 计时中: 番茄红与橙色之间缓慢呼吸
+static const RgbKeyframe rgb_normal_frames[] = {
+    {255, 40, 8, 40, 2500},
+    {255, 120, 0, 64, 2500}};
+// 到点: 红色快速闪烁
+static const RgbKeyframe rgb_alarm_frames[] = {
+    {255, 0, 0, 3, 150},
+    {255, 0, 0, 255, 150}};
+
 static int tomato_init(AppController *sys)
 {
     // 初始化运行时的参数
@@ -53,27 +62,10 @@ static int tomato_init(AppController *sys)
     run_data->lastAct = UNKNOWN;
     // run_data->count_down_init = 0;
 
-    run_data->rgb_cfg.mode = 1;
-    run_data->rgb_cfg.min_value_0 = 1;
-    run_data->rgb_cfg.min_value_1 = 32;
-    run_data->rgb_cfg.min_value_2 = 255;
-    run_data->rgb_cfg.max_value_0 = 255;
-    run_data->rgb_cfg.max_value_1 = 255;
-    run_data->rgb_cfg.max_value_2 = 255;
-    run_data->rgb_cfg.step_0 = 1;
-    run_data->rgb_cfg.step_1 = 1;
-    run_data->rgb_cfg.step_2 = 1;
-    run_data->rgb_cfg.min_brightness = 0.15;
-    run_data->rgb_cfg.max_brightness = 0.25;
-    run_data->rgb_cfg.brightness_step = 0.003;
-    run_data->rgb_cfg.time = 30;
-
-    run_data->rgb_setting = {LED_MODE_HSV,
-                             run_data->rgb_cfg.min_value_0, run_data->rgb_cfg.min_value_1, run_data->rgb_cfg.min_value_2,
-                             run_data->rgb_cfg.max_value_0, run_data->rgb_cfg.max_value_1, run_data->rgb_cfg.max_value_2,
-                             run_data->rgb_cfg.step_0, run_data->rgb_cfg.step_1, run_data->rgb_cfg.step_2,
-                             run_data->rgb_cfg.min_brightness, run_data->rgb_cfg.max_brightness,
-                             run_data->rgb_cfg.brightness_step, run_data->rgb_cfg.time};
+    rgb_effect_register(TOMATO_RGB_NORMAL, rgb_normal_frames,
+                        sizeof(rgb_normal_frames) / sizeof(rgb_normal_frames[0]), true);
+    rgb_effect_register(TOMATO_RGB_ALARM, rgb_alarm_frames,
+                        sizeof(rgb_alarm_frames) / sizeof(rgb_alarm_frames[0]), true);
     return 0;
 }
 static void time_switch()
@@ -135,85 +127,10 @@ static void rgb_ctrl()
     // Serial.println("     rgb_fast_update");
     if (run_data->rgb_fast_update == 0)
     {
-        if (run_data->rgb_fast == 1)
-        {
-            run_data->rgb_cfg.time = 10;
-            // run_data->rgb_cfg.min_brightness = 0.01;
-            // run_data->rgb_cfg.brightness_step = 0.05;
-            // run_data->rgb_cfg.max_brightness = 0.95;
-            // run_data->rgb_cfg.step_0 = 0;
-            // run_data->rgb_cfg.step_1 = 0;
-            // run_data->rgb_cfg.step_2 = 0;
-            run_data->rgb_cfg.mode = 1;
-            run_data->rgb_cfg.min_value_0 = 1;
-            run_data->rgb_cfg.min_value_1 = 32;
-            run_data->rgb_cfg.min_value_2 = 255;
-            run_data->rgb_cfg.max_value_0 = 255;
-            run_data->rgb_cfg.max_value_1 = 255;
-            run_data->rgb_cfg.max_value_2 = 255;
-            //  Serial.println("set low");
-            run_data->rgb_cfg.step_0 = 1;
-            run_data->rgb_cfg.step_1 = 1;
-            run_data->rgb_cfg.step_2 = 1;
-            run_data->rgb_cfg.min_brightness = 0.01;
-            run_data->rgb_cfg.max_brightness = 1;
-            run_data->rgb_cfg.brightness_step = 0.072;
-            //  Serial.println("set fast");
-        }
-        else
-        {
-            run_data->rgb_cfg.mode = 1;
-            run_data->rgb_cfg.min_value_0 = 1;
-            run_data->rgb_cfg.min_value_1 = 32;
-            run_data->rgb_cfg.min_value_2 = 255;
-            run_data->rgb_cfg.max_value_0 = 255;
-            run_data->rgb_cfg.max_value_1 = 255;
-            run_data->rgb_cfg.max_value_2 = 255;
-            //  Serial.println("set low");
-            run_data->rgb_cfg.step_0 = 1;
-            run_data->rgb_cfg.step_1 = 1;
-            run_data->rgb_cfg.step_2 = 1;
-            run_data->rgb_cfg.min_brightness = 0.15;
-            run_data->rgb_cfg.max_brightness = 0.25;
-            run_data->rgb_cfg.brightness_step = 0.001;
-            run_data->rgb_cfg.time = 50;
-        }
-        run_data->rgb_setting = {LED_MODE_HSV,
-                                 run_data->rgb_cfg.min_value_0, run_data->rgb_cfg.min_value_1, run_data->rgb_cfg.min_value_2,
-                                 run_data->rgb_cfg.max_value_0, run_data->rgb_cfg.max_value_1, run_data->rgb_cfg.max_value_2,
-                                 run_data->rgb_cfg.step_0, run_data->rgb_cfg.step_1, run_data->rgb_cfg.step_2,
-                                 run_data->rgb_cfg.min_brightness, run_data->rgb_cfg.max_brightness,
-                                 run_data->rgb_cfg.brightness_step, run_data->rgb_cfg.time};
-        set_rgb_and_run(&(run_data->rgb_setting));
+        rgb_effect_run(run_data->rgb_fast == 1 ? TOMATO_RGB_ALARM : TOMATO_RGB_NORMAL);
         run_data->rgb_fast_update = 1;
     }
 }
-static void rgb_reset()
-{
-
-    run_data->rgb_cfg.mode = 1;
-    run_data->rgb_cfg.min_value_0 = 1;
-    run_data->rgb_cfg.min_value_1 = 32;
-    run_data->rgb_cfg.min_value_2 = 255;
-    run_data->rgb_cfg.max_value_0 = 255;
-    run_data->rgb_cfg.max_value_1 = 255;
-    run_data->rgb_cfg.max_value_2 = 255;
-    //  Serial.println("set low");
-    run_data->rgb_cfg.step_0 = 1;
-    run_data->rgb_cfg.step_1 = 1;
-    run_data->rgb_cfg.step_2 = 1;
-    run_data->rgb_cfg.min_brightness = 0.15;
-    run_data->rgb_cfg.max_brightness = 0.25;
-    run_data->rgb_cfg.brightness_step = 0.001;
-    run_data->rgb_cfg.time = 50;
-    run_data->rgb_setting = {LED_MODE_HSV,
-                             run_data->rgb_cfg.min_value_0, run_data->rgb_cfg.min_value_1, run_data->rgb_cfg.min_value_2,
-                             run_data->rgb_cfg.max_value_0, run_data->rgb_cfg.max_value_1, run_data->rgb_cfg.max_value_2,
-                             run_data->rgb_cfg.step_0, run_data->rgb_cfg.step_1, run_data->rgb_cfg.step_2,
-                             run_data->rgb_cfg.min_brightness, run_data->rgb_cfg.max_brightness,
-                             run_data->rgb_cfg.brightness_step, run_data->rgb_cfg.time};
-    set_rgb_and_run(&(run_data->rgb_setting));
-}
 static void tomato_process(AppController *sys, const ImuAction *act_info)
 {
     static int count = 0;
@@ -367,7 +284,7 @@ static void tomato_process(AppController *sys, const ImuAction *act_info)
 static int tomato_exit_callback(void *param)
 {
     tomato_gui_del();
-    rgb_reset();
+    // RGB灯由app_exit恢复为系统灯效
     if (run_data != NULL)
     {
         // 释放资源
@@ -35,6 +35,7 @@
 // bool isUdpInit = false;
 
 // 天气的持久化配置
+#define WEATHER_CONFIG_NS "weather"
 #define WEATHER_CONFIG_PATH "/weather_2111.cfg"
 struct WT_Config
 {
@@ -45,51 +46,37 @@ struct WT_Config
     unsigned long timeUpdataInterval;    // 日期时钟更新的时间间隔(s)
 };
 
+static const char *const weather_cfg_keys[] = {
+    "tianqi_url", "tianqi_city_code", "tianqi_api_key",
+    "weatherUpdataInterval", "timeUpdataInterval"};
+
 static void write_config(WT_Config *cfg)
 {
-    char tmp[16];
-    // 将配置数据保存在文件中（持久化）
-    String w_data;
-    w_data = w_data + cfg->tianqi_url + "\n";
-    w_data = w_data + cfg->tianqi_city_code + "\n";
-    w_data = w_data + cfg->tianqi_api_key + "\n";
-    memset(tmp, 0, 16);
-    snprintf(tmp, 16, "%lu\n", cfg->weatherUpdataInterval);
-    w_data += tmp;
-    memset(tmp, 0, 16);
-    snprintf(tmp, 16, "%lu\n", cfg->timeUpdataInterval);
-    w_data += tmp;
-    g_flashCfg.writeFile(WEATHER_CONFIG_PATH, w_data.c_str());
+    // 将配置数据保存在配置存储中（持久化）
+    g_cfgStore.setString(WEATHER_CONFIG_NS, "tianqi_url", cfg->tianqi_url.c_str());
+    g_cfgStore.setString(WEATHER_CONFIG_NS, "tianqi_city_code", cfg->tianqi_city_code.c_str());
+    g_cfgStore.setString(WEATHER_CONFIG_NS, "tianqi_api_key", cfg->tianqi_api_key.c_str());
+    g_cfgStore.setUInt(WEATHER_CONFIG_NS, "weatherUpdataInterval", cfg->weatherUpdataInterval);
+    g_cfgStore.setUInt(WEATHER_CONFIG_NS, "timeUpdataInterval", cfg->timeUpdataInterval);
+    g_cfgStore.commit();
 }
 
 static void read_config(WT_Config *cfg)
 {
-    // 如果有需要持久化配置文件 可以调用此函数将数据存在flash中
-    // 配置文件名最好以APP名为开头 以".cfg"结尾，以免多个APP读取混乱
-    char info[128] = {0};
-    uint16_t size = g_flashCfg.readFile(WEATHER_CONFIG_PATH, (uint8_t *)info);
-    info[size] = 0;
-    if (size == 0)
+    bool exist = g_cfgStore.migrate(WEATHER_CONFIG_NS, WEATHER_CONFIG_PATH, weather_cfg_keys);
+    // 默认值
+    cfg->tianqi_url = g_cfgStore.getString(WEATHER_CONFIG_NS, "tianqi_url",
+                                           "restapi.amap.com/v3/weather/weatherInfo");
+    cfg->tianqi_city_code = g_cfgStore.getString(WEATHER_CONFIG_NS, "tianqi_city_code", "北京"); // "110000";
+    cfg->tianqi_api_key = g_cfgStore.getString(WEATHER_CONFIG_NS, "tianqi_api_key", "");
+    // 天气更新的时间间隔900000(900s)
+    cfg->weatherUpdataInterval = g_cfgStore.getUInt(WEATHER_CONFIG_NS, "weatherUpdataInterval", 900000);
+    // 日期时钟更新的时间间隔900000(900s)
+    cfg->timeUpdataInterval = g_cfgStore.getUInt(WEATHER_CONFIG_NS, "timeUpdataInterval", 900000);
+    if (!exist)
     {
-        // 默认值
-        cfg->tianqi_url = "restapi.amap.com/v3/weather/weatherInfo";
-        cfg->tianqi_city_code = "北京"; // "110000";
-        cfg->tianqi_api_key = "";
-        cfg->weatherUpdataInterval = 900000; // 天气更新的时间间隔900000(900s)
-        cfg->timeUpdataInterval = 900000;    // 日期时钟更新的时间间隔900000(900s)
         write_config(cfg);
     }
-    else
-    {
-        // 解析数据
-        char *param[5] = {0};
-        analyseParam(info, 5, param);
-        cfg->tianqi_url = param[0];
-        cfg->tianqi_city_code = param[1];
-        cfg->tianqi_api_key = param[2];
-        cfg->weatherUpdataInterval = atol(param[3]);
-        cfg->timeUpdataInterval = atol(param[4]);
-    }
 }
 
 struct WeatherAppRunData
@@ -532,13 +519,13 @@ static void weather_process(AppController *sys,
         }
         run_data->coactusUpdateFlag = 0x00; // 取消强制更新标志
         display_space();
-        delay(30);
+        sys->set_process_interval(30); // 太空人动画的帧间隔
     }
     else if (run_data->clock_page == 1)
     {
         // 仅在切换界面时获取一次未来天气
         display_curve(run_data->wea.daily_max, run_data->wea.daily_min, anim_type);
-        delay(300);
+        sys->set_process_interval(300);
     }
 }
 
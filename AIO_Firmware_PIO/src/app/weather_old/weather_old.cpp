@@ -16,6 +16,7 @@ struct Weather
 };
 
 // 天气的持久化配置
+#define WEATHER_OLD_CONFIG_NS "weather_old"
 #define WEATHER_OLD_CONFIG_PATH "/weather_old.cfg"
 struct WT_Config
 {
@@ -26,50 +27,36 @@ struct WT_Config
     unsigned long timeUpdataInterval;    // 日期时钟更新的时间间隔(s)
 };
 
+static const char *const weather_old_cfg_keys[] = {
+    "cityname", "language", "weather_key",
+    "weatherUpdataInterval", "timeUpdataInterval"};
+
 static void write_config(const WT_Config *cfg)
 {
-    char tmp[16];
-    // 将配置数据保存在文件中（持久化）
-    String w_data;
-    w_data = w_data + cfg->cityname + "\n";
-    w_data = w_data + cfg->language + "\n";
-    w_data = w_data + cfg->weather_key + "\n";
-    memset(tmp, 0, 16);
-    snprintf(tmp, 16, "%lu\n", cfg->weatherUpdataInterval);
-    w_data += tmp;
-    memset(tmp, 0, 16);
-    snprintf(tmp, 16, "%lu\n", cfg->timeUpdataInterval);
-    w_data += tmp;
-    g_flashCfg.writeFile(WEATHER_OLD_CONFIG_PATH, w_data.c_str());
+    // 将配置数据保存在配置存储中（持久化）
+    g_cfgStore.setString(WEATHER_OLD_CONFIG_NS, "cityname", cfg->cityname.c_str());
+    g_cfgStore.setString(WEATHER_OLD_CONFIG_NS, "language", cfg->language.c_str());
+    g_cfgStore.setString(WEATHER_OLD_CONFIG_NS, "weather_key", cfg->weather_key.c_str());
+    g_cfgStore.setUInt(WEATHER_OLD_CONFIG_NS, "weatherUpdataInterval", cfg->weatherUpdataInterval);
+    g_cfgStore.setUInt(WEATHER_OLD_CONFIG_NS, "timeUpdataInterval", cfg->timeUpdataInterval);
+    g_cfgStore.commit();
 }
 
 static void read_config(WT_Config *cfg)
 {
-    // 如果有需要持久化配置文件 可以调用此函数将数据存在flash中
-    // 配置文件名最好以APP名为开头 以".cfg"结尾，以免多个APP读取混乱
-    char info[128] = {0};
-    uint16_t size = g_flashCfg.readFile(WEATHER_OLD_CONFIG_PATH, (uint8_t *)info);
-    info[size] = 0;
-    if (size == 0)
+    bool exist = g_cfgStore.migrate(WEATHER_OLD_CONFIG_NS, WEATHER_OLD_CONFIG_PATH, weather_old_cfg_keys);
+    // 默认值
+    cfg->cityname = g_cfgStore.getString(WEATHER_OLD_CONFIG_NS, "cityname", "Beijing");
+    cfg->language = g_cfgStore.getString(WEATHER_OLD_CONFIG_NS, "language", "zh-Hans");
+    cfg->weather_key = g_cfgStore.getString(WEATHER_OLD_CONFIG_NS, "weather_key", "");
+    // 天气更新的时间间隔900000(900s)
+    cfg->weatherUpdataInterval = g_cfgStore.getUInt(WEATHER_OLD_CONFIG_NS, "weatherUpdataInterval", 900000);
+    // 日期时钟更新的时间间隔900000(900s)
+    cfg->timeUpdataInterval = g_cfgStore.getUInt(WEATHER_OLD_CONFIG_NS, "timeUpdataInterval", 900000);
+    if (!exist)
     {
-        // 默认值
-        cfg->cityname = "Beijing";
-        cfg->language = "zh-Hans";
-        cfg->weatherUpdataInterval = 900000; // 天气更新的时间间隔900000(900s)
-        cfg->timeUpdataInterval = 900000;    // 日期时钟更新的时间间隔900000(900s)
         write_config(cfg);
     }
-    else
-    {
-        // 解析数据
-        char *param[5] = {0};
-        analyseParam(info, 5, param);
-        cfg->cityname = param[0];
-        cfg->language = param[1];
-        cfg->weather_key = param[2];
-        cfg->weatherUpdataInterval = atol(param[3]);
-        cfg->timeUpdataInterval = atol(param[4]);
-    }
 }
 
 struct WeatherAppRunData
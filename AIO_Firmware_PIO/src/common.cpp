@@ -7,8 +7,11 @@ Pixel rgb;
 // Config g_cfg;       // 全局配置文件
 Network g_network;  // 网络连接
 FlashFS g_flashCfg; // flash中的文件系统（替代原先的Preferences）
+ConfigStore g_cfgStore; // 所有APP共用的配置存储
 Display screen;     // 屏幕对象
 Ambient ambLight;   // 光线传感器对象
+I2cBus g_i2cBus;    // IMU与光线传感器共用的I2C总线
+BacklightCtrl g_backlight; // 背光控制
 
 // lvgl handle的锁
 SemaphoreHandle_t lvgl_mutex = xSemaphoreCreateMutex();
@@ -8,11 +8,15 @@
 #include "Arduino.h"
 #include "driver/rgb_led.h"
 #include "driver/flash_fs.h"
+#include "driver/config_store.h"
 #include "driver/sd_card.h"
 #include "driver/display.h"
+#include "driver/i2c_bus.h"
 #include "driver/ambient.h"
+#include "driver/backlight.h"
 #include "driver/imu.h"
 #include "network.h"
+#include "sys/metrics.h"
 
 // RGB
 #define RGB_LED_PIN 27
@@ -33,8 +37,11 @@ extern Pixel rgb;
 // extern Config g_cfg;       // 全局配置文件
 extern Network g_network;  // 网络连接
 extern FlashFS g_flashCfg; // flash中的文件系统（替代原先的Preferences）
+extern ConfigStore g_cfgStore; // 所有APP共用的配置存储
 extern Display screen;     // 屏幕对象
 extern Ambient ambLight;   // 光纤传感器对象
+extern I2cBus g_i2cBus;    // IMU与光线传感器共用的I2C总线
+extern BacklightCtrl g_backlight; // 背光控制
 
 boolean doDelayMillisTime(unsigned long interval,
                           unsigned long *previousMillis,
@@ -70,7 +77,9 @@ boolean doDelayMillisTime(unsigned long interval,
 // 优先级定义(数值越小优先级越低)
 // 最高为 configMAX_PRIORITIES-1
 #define TASK_RGB_PRIORITY 0  // RGB的任务优先级
+#define TASK_BACKLIGHT_PRIORITY 1 // 背光控制的任务优先级
 #define TASK_LVGL_PRIORITY 2 // LVGL的页面优先级
+#define TASK_IMU_PRIORITY 3  // IMU采样的任务优先级
 
 // lvgl 操作的锁
 extern SemaphoreHandle_t lvgl_mutex;
@@ -17,35 +17,66 @@ void Ambient::init(int mode)
         break;
     }
 
-    Wire.begin(AMB_I2C_SDA, AMB_I2C_SCL);
-
+    // 总线已由g_i2cBus初始化（与MPU6050共用）
     delay(50);
 
+    // 转换完成后由总线在空闲时读取 与IMU的读取合并在一起
+    // 先登记但不启动 由setEnabled()开始测量（init之前的setEnabled()不生效）
+    job = g_i2cBus.addJob(ADDRESS_BH1750FVI, sample_time, readSensor, this);
+    enabled = true;
+    setEnabled(false);
+}
+
+void Ambient::setEnabled(bool enable)
+{
+    if (job < 0 || enable == enabled || !g_i2cBus.lock(ADDRESS_BH1750FVI))
+    {
+        return;
+    }
+    enabled = enable;
+    valid = false;
     Wire.beginTransmission(ADDRESS_BH1750FVI); //"notify" the matching device
-    Wire.write(mMode);                         // set operation mode
-    Wire.endTransmission();
+    // 开启时启动一次测量 之后每次读取时再启动下一次
+    Wire.write(enable ? mMode : BH1750_POWER_DOWN);
+    bool ok = 0 == Wire.endTransmission();
+    g_i2cBus.setJobActive(job, enable);
+    g_i2cBus.unlock(ok);
 }
 
-unsigned int Ambient::getLux()
+void Ambient::setSampleTime(long ms)
 {
-    if (GET_SYS_MILLIS() - last_time > sample_time)
+    long min_time = ONE_TIME_L_RESOLUTION_MODE == mMode ? 20 : 125;
+    sample_time = max(ms, min_time);
+    g_i2cBus.setJobPeriod(job, sample_time);
+}
+
+bool Ambient::readSensor(void *user_data)
+{
+    Ambient *amb = (Ambient *)user_data;
+    if (2 != Wire.requestFrom(ADDRESS_BH1750FVI, 2)) // ask Arduino to read back 2 bytes from the sensor
     {
-        last_time = GET_SYS_MILLIS();
-        Wire.requestFrom(ADDRESS_BH1750FVI, 2); // ask Arduino to read back 2 bytes from the sensor
-        highByte = Wire.read();                 // get the high byte
-        lowByte = Wire.read();                  // get the low byte
+        return false;
+    }
+    amb->highByte = Wire.read(); // get the high byte
+    amb->lowByte = Wire.read();  // get the low byte
 
-        sensorOut = (highByte << 8) | lowByte;
-        illuminance = sensorOut / 1.2;
+    amb->sensorOut = (amb->highByte << 8) | amb->lowByte;
+    amb->illuminance = amb->sensorOut / 1.2;
 
-        for (int i = 4; i > 0; i--)
-            lux[i] = lux[i - 1];
-        lux[0] = illuminance;
+    for (int i = 4; i > 0; i--)
+        amb->lux[i] = amb->lux[i - 1];
+    amb->lux[0] = amb->illuminance;
+    amb->valid = true;
 
-        Wire.beginTransmission(ADDRESS_BH1750FVI); //"notify" the matching device
-        Wire.write(mMode);                         // set operation mode
-        Wire.endTransmission();
-    }
+    Wire.beginTransmission(ADDRESS_BH1750FVI); //"notify" the matching device
+    Wire.write(amb->mMode);                    // set operation mode
+    return 0 == Wire.endTransmission();
+}
+
+unsigned int Ambient::getLux()
+{
+    // IMU采样任务会顺带完成读取 这里只在读取滞后时补一次
+    g_i2cBus.poll();
 
     unsigned int avg = 0;
     for (int i = 4; i >= 0; i--)
@@ -7,6 +7,7 @@
 #define ONE_TIME_H_RESOLUTION_MODE 0x20  // 1lux for 120ms
 #define ONE_TIME_H_RESOLUTION_MODE2 0x21 // 0.5lux for 120ms
 #define ONE_TIME_L_RESOLUTION_MODE 0x23  // 4lux for 16ms
+#define BH1750_POWER_DOWN 0x00           // 掉电（上电后默认也处于掉电状态）
 
 class Ambient
 {
@@ -19,11 +20,20 @@ private:
 
     unsigned int lux[5];
     long sample_time = 125;
-    long last_time;
+    int8_t job = -1;    // 在I2C总线上登记的周期读取
+    bool valid = false; // 开启后是否成功读取过（未焊接光感时一直为false）
+    bool enabled = false;
+
+    static bool readSensor(void *user_data); // 由I2C总线按sample_time周期调用
 
 public:
     void init(int mode);
     unsigned int getLux();
+    unsigned int getLastLux() { return illuminance; } // 最近一次的读数（不平均）
+    bool isValid() { return valid; }
+    void setSampleTime(long ms); // 调整读取间隔（不小于转换时间）
+    // 开始或停止周期读取 停止时传感器掉电（只有自动亮度需要光感 默认不开启）
+    void setEnabled(bool enable);
 };
 
 #endif
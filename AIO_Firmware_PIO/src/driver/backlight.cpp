@@ -0,0 +1,209 @@
+#include "backlight.h"
+#include "common.h"
+
+void backlight_default_config(BacklightConfig *cfg)
+{
+    cfg->auto_mode = 0;
+    cfg->dark_lux = 0;
+    cfg->lux_0 = 0;
+    cfg->lux_1 = 20;
+    cfg->lux_2 = 200;
+    cfg->lux_3 = 1000;
+    cfg->level_0 = 20;
+    cfg->level_1 = 50;
+    cfg->level_2 = 80;
+    cfg->level_3 = 100;
+}
+
+const char *const backlight_param_name[BACKLIGHT_PARAM_NUM] = {
+    "auto_mode", "dark_lux", "lux_0", "lux_1", "lux_2", "lux_3",
+    "level_0", "level_1", "level_2", "level_3"};
+
+uint16_t *backlight_param(BacklightConfig *cfg, const char *name)
+{
+    // 与backlight_param_name的顺序一致
+    uint16_t *params[BACKLIGHT_PARAM_NUM] = {
+        &cfg->auto_mode, &cfg->dark_lux, &cfg->lux_0, &cfg->lux_1, &cfg->lux_2,
+        &cfg->lux_3, &cfg->level_0, &cfg->level_1, &cfg->level_2, &cfg->level_3};
+    for (int pos = 0; pos < BACKLIGHT_PARAM_NUM; ++pos)
+    {
+        if (!strcmp(name, backlight_param_name[pos]))
+        {
+            return params[pos];
+        }
+    }
+    return NULL;
+}
+
+BacklightCtrl::BacklightCtrl()
+{
+    m_task = NULL;
+    m_cfg = NULL;
+    m_force = true;
+    m_user_level = 100;
+    m_night_level = 100;
+    m_night_start = 0;
+    m_night_end = 0;
+    m_schedule_time = 0;
+    m_lux_init = false;
+    m_lux_x16 = 0;
+    m_period = BACKLIGHT_FAST_PERIOD;
+    m_dark = false;
+    m_level = 0xFF;
+}
+
+void BacklightCtrl::begin(void)
+{
+    xTaskCreate(task, "Backlight", 3 * 1024, this,
+                TASK_BACKLIGHT_PRIORITY, &m_task);
+    METRIC_WATCH_TASK("Backlight", m_task);
+}
+
+void BacklightCtrl::setConfig(const BacklightConfig *cfg)
+{
+    m_cfg = cfg;
+    m_lux_init = false;
+    m_period = BACKLIGHT_FAST_PERIOD;
+    update();
+}
+
+void BacklightCtrl::setUserLevel(uint8_t level)
+{
+    m_user_level = level;
+    update();
+}
+
+void BacklightCtrl::setNightMode(uint8_t level, uint8_t start, uint8_t end)
+{
+    m_night_level = level;
+    m_night_start = start;
+    m_night_end = end;
+    update();
+}
+
+void BacklightCtrl::update(void)
+{
+    m_force = true;
+    if (NULL != m_task)
+    {
+        xTaskNotifyGive(m_task);
+    }
+}
+
+void BacklightCtrl::task(void *parameter)
+{
+    BacklightCtrl *ctrl = (BacklightCtrl *)parameter;
+    for (;;)
+    {
+        uint32_t period = ctrl->step();
+        // 参数变化时由update()提前唤醒
+        ulTaskNotifyTake(pdTRUE, period / portTICK_PERIOD_MS);
+    }
+}
+
+uint32_t BacklightCtrl::step(void)
+{
+    bool force = m_force;
+    m_force = false;
+
+    unsigned long now = GET_SYS_MILLIS();
+    if (force || now - m_schedule_time >= BACKLIGHT_SCHEDULE_PERIOD)
+    {
+        m_schedule_time = now;
+        screen.night_mode = is_night_mode_time(m_night_start, m_night_end);
+    }
+    uint8_t level = screen.night_mode ? m_night_level : m_user_level;
+
+    // 只有自动亮度需要光感 关闭时停止读取并让传感器掉电
+    bool auto_mode = NULL != m_cfg && 0 != m_cfg->auto_mode;
+    ambLight.setEnabled(auto_mode);
+
+    // 未开启自动亮度或光感不可用时 只需按时检查夜间模式
+    if (!auto_mode || !ambLight.isValid())
+    {
+        if (force || level != m_level)
+        {
+            apply(level);
+        }
+        // 刚开启时等待光感的第一次读数
+        return auto_mode && !m_lux_init ? BACKLIGHT_FAST_PERIOD : BACKLIGHT_SCHEDULE_PERIOD;
+    }
+
+    int32_t lux_x16 = ambLight.getLastLux() * 16;
+    if (!m_lux_init)
+    {
+        m_lux_init = true;
+        m_lux_x16 = lux_x16;
+    }
+    int32_t delta = lux_x16 - m_lux_x16;
+    m_lux_x16 += delta / 4;
+
+    // 环境光在变化时加快采样 稳定后逐步放慢
+    if (abs(delta) > m_lux_x16 / 4 + BACKLIGHT_LUX_NOISE * 16)
+    {
+        m_period = BACKLIGHT_FAST_PERIOD;
+    }
+    else
+    {
+        m_period = min(m_period * 2, (uint32_t)BACKLIGHT_SLOW_PERIOD);
+    }
+    ambLight.setSampleTime(m_period);
+
+    level = level * mapLux(m_lux_x16 / 16) / 100;
+    if (force || level != m_level)
+    {
+        // 变化很小时不改写PWM 避免亮度随光感噪声抖动
+        if (force || 0 == level || 0 == m_level ||
+            abs((int)level - (int)m_level) >= BACKLIGHT_MIN_STEP)
+        {
+            apply(level);
+        }
+    }
+    return m_period;
+}
+
+uint8_t BacklightCtrl::mapLux(uint32_t lux)
+{
+    // 关闭背光后需要明显变亮才重新点亮
+    if (0 != m_cfg->dark_lux)
+    {
+        m_dark = m_dark ? lux < m_cfg->dark_lux * 2u : lux < m_cfg->dark_lux;
+        if (m_dark)
+        {
+            return 0;
+        }
+    }
+
+    const uint16_t lux_points[BACKLIGHT_CURVE_POINTS] = {
+        m_cfg->lux_0, m_cfg->lux_1, m_cfg->lux_2, m_cfg->lux_3};
+    const uint16_t level_points[BACKLIGHT_CURVE_POINTS] = {
+        m_cfg->level_0, m_cfg->level_1, m_cfg->level_2, m_cfg->level_3};
+
+    if (lux <= lux_points[0])
+    {
+        return min(level_points[0], (uint16_t)100);
+    }
+    for (int pos = 1; pos < BACKLIGHT_CURVE_POINTS; ++pos)
+    {
+        if (lux < lux_points[pos])
+        {
+            int32_t span = lux_points[pos] - lux_points[pos - 1];
+            int32_t level = level_points[pos - 1] +
+                            (int32_t)(level_points[pos] - level_points[pos - 1]) *
+                                (int32_t)(lux - lux_points[pos - 1]) / max(span, (int32_t)1);
+            return constrain(level, 0, 100);
+        }
+    }
+    return min(level_points[BACKLIGHT_CURVE_POINTS - 1], (uint16_t)100);
+}
+
+void BacklightCtrl::apply(uint8_t level)
+{
+    if (level == m_level)
+    {
+        return;
+    }
+    m_level = level;
+    screen.setBackLight(level / 100.0);
+    Serial.printf("[Backlight] level %u\n", level);
+}
@@ -0,0 +1,80 @@
+#ifndef BACKLIGHT_H
+#define BACKLIGHT_H
+
+#include <Arduino.h>
+
+#define BACKLIGHT_CURVE_POINTS 4      // 照度-亮度曲线的点数
+#define BACKLIGHT_FAST_PERIOD 500     // 环境光变化时的采样间隔 ms
+#define BACKLIGHT_SLOW_PERIOD 8000    // 环境光稳定后的最长采样间隔 ms
+#define BACKLIGHT_SCHEDULE_PERIOD 30000 // 检查夜间模式时间段的间隔 ms
+#define BACKLIGHT_MIN_STEP 3          // 亮度变化小于此值(%)时不改写PWM
+#define BACKLIGHT_LUX_NOISE 5         // 照度的波动小于此值时视为稳定
+
+// 自动背光的参数 全部使用uint16_t 方便按名字统一读写
+struct BacklightConfig
+{
+    uint16_t auto_mode; // 是否根据环境光调整亮度
+    uint16_t dark_lux;  // 照度低于此值时关闭背光 0表示不关闭
+    // 照度-亮度曲线 lux从小到大 level为用户设定亮度的百分比 之间线性插值
+    uint16_t lux_0;
+    uint16_t lux_1;
+    uint16_t lux_2;
+    uint16_t lux_3;
+    uint16_t level_0;
+    uint16_t level_1;
+    uint16_t level_2;
+    uint16_t level_3;
+};
+
+/*
+ * 背光控制
+ * 合并用户亮度、夜间模式时间段与环境光 只在亮度有明显变化时才改写PWM
+ * 环境光稳定时逐步降低光感的采样频率 其余时间任务处于休眠
+ */
+class BacklightCtrl
+{
+public:
+    BacklightCtrl();
+
+    void begin(void);
+    void setConfig(const BacklightConfig *cfg); // cfg需要一直有效
+    void setUserLevel(uint8_t level);           // 用户设定的亮度 0~100
+    void setNightMode(uint8_t level, uint8_t start, uint8_t end);
+    void update(void); // 参数变化后立即重新计算亮度
+    uint8_t getLevel(void) const { return m_level; }
+
+private:
+    static void task(void *parameter);
+    uint32_t step(void);
+    uint8_t mapLux(uint32_t lux);
+    void apply(uint8_t level);
+
+private:
+    TaskHandle_t m_task;
+    const BacklightConfig *m_cfg;
+    volatile bool m_force; // 下一次计算时忽略最小变化量 并重新检查时间段
+
+    uint8_t m_user_level;
+    uint8_t m_night_level;
+    uint8_t m_night_start;
+    uint8_t m_night_end;
+    unsigned long m_schedule_time;
+
+    bool m_lux_init;
+    int32_t m_lux_x16;  // 平滑后的照度 放大16倍保留小数
+    uint32_t m_period;  // 当前的采样间隔
+    bool m_dark;        // 已因环境过暗关闭背光
+    uint8_t m_level;    // 当前写入的亮度
+};
+
+// 默认参数（不开启自动亮度）
+void backlight_default_config(BacklightConfig *cfg);
+
+// 参数的名字（同时也是配置存储中的键名）
+#define BACKLIGHT_PARAM_NUM 10
+extern const char *const backlight_param_name[BACKLIGHT_PARAM_NUM];
+
+// 按名字取得参数的地址 名字不存在时返回NULL
+uint16_t *backlight_param(BacklightConfig *cfg, const char *name);
+
+#endif
@@ -0,0 +1,366 @@
+#include "config_store.h"
+#include "flash_fs.h"
+#include <SPIFFS.h>
+
+extern FlashFS g_flashCfg;
+
+struct CfgFileHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count; // 记录条数
+};
+
+struct CfgRecordHeader
+{
+    uint8_t version;
+    uint8_t type;
+    uint8_t key_len;
+    uint8_t reserved;
+    uint16_t value_len;
+    uint16_t reserved2;
+    uint32_t crc; // 覆盖type、key、value
+};
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len)
+{
+    crc = ~crc;
+    while (len--)
+    {
+        crc ^= *data++;
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static uint32_t record_crc(uint8_t type, const char *key, uint8_t key_len,
+                           const uint8_t *value, uint16_t value_len)
+{
+    uint32_t crc = crc32_update(0, &type, 1);
+    crc = crc32_update(crc, (const uint8_t *)key, key_len);
+    return crc32_update(crc, value, value_len);
+}
+
+static void make_key(char *dst, const char *ns, const char *key)
+{
+    snprintf(dst, CFG_KEY_MAX_LEN, "%s.%s", ns, key);
+}
+
+ConfigStore::ConfigStore()
+{
+    m_dirty = false;
+    m_commit_pending = false;
+    m_commit_time = 0;
+    m_flash_writes = 0;
+}
+
+bool ConfigStore::begin(void)
+{
+    // 上一次替换文件时掉电 只剩下临时文件
+    if (!SPIFFS.exists(CFG_STORE_PATH) && SPIFFS.exists(CFG_STORE_TMP_PATH))
+    {
+        SPIFFS.rename(CFG_STORE_TMP_PATH, CFG_STORE_PATH);
+    }
+    else if (SPIFFS.exists(CFG_STORE_TMP_PATH))
+    {
+        // 临时文件未写完 正式文件仍然完整
+        SPIFFS.remove(CFG_STORE_TMP_PATH);
+    }
+
+    bool ret = load(CFG_STORE_PATH);
+    Serial.printf("[Config] %u items loaded\n", m_items.size());
+    return ret;
+}
+
+bool ConfigStore::load(const char *path)
+{
+    m_items.clear();
+    File file = SPIFFS.open(path);
+    if (!file || file.isDirectory())
+    {
+        return false;
+    }
+
+    size_t file_size = file.size();
+    CfgFileHeader header;
+    if (file_size > CFG_STORE_MAX_SIZE ||
+        file.read((uint8_t *)&header, sizeof(header)) != sizeof(header) ||
+        CFG_STORE_MAGIC != header.magic || CFG_STORE_VERSION != header.version)
+    {
+        Serial.println(F("[Config] bad config file"));
+        file.close();
+        return false;
+    }
+
+    char key[CFG_KEY_MAX_LEN];
+    uint8_t value[CFG_VALUE_MAX_LEN + 1];
+    for (uint16_t cnt = 0; cnt < header.count; ++cnt)
+    {
+        CfgRecordHeader rec;
+        if (file.read((uint8_t *)&rec, sizeof(rec)) != sizeof(rec))
+        {
+            break;
+        }
+        // 长度异常时无法定位到下一条记录 只能放弃剩余部分
+        if (rec.key_len >= CFG_KEY_MAX_LEN || rec.value_len > CFG_VALUE_MAX_LEN ||
+            file.read((uint8_t *)key, rec.key_len) != rec.key_len ||
+            file.read(value, rec.value_len) != rec.value_len)
+        {
+            Serial.println(F("[Config] truncated record"));
+            break;
+        }
+        key[rec.key_len] = 0;
+        value[rec.value_len] = 0;
+
+        // 版本不认识或校验失败的记录单独丢弃
+        if (CFG_RECORD_VERSION != rec.version ||
+            rec.crc != record_crc(rec.type, key, rec.key_len, value, rec.value_len))
+        {
+            Serial.printf("[Config] drop record %s\n", key);
+            continue;
+        }
+
+        CfgItem item;
+        strncpy(item.key, key, CFG_KEY_MAX_LEN);
+        item.type = (CFG_VALUE_TYPE)rec.type;
+        item.num = 0;
+        if (CFG_TYPE_INT == rec.type && sizeof(uint32_t) == rec.value_len)
+        {
+            memcpy(&item.num, value, sizeof(uint32_t));
+        }
+        else if (CFG_TYPE_STR == rec.type)
+        {
+            item.str = (const char *)value;
+        }
+        else
+        {
+            continue;
+        }
+        m_items.push_back(item);
+    }
+    file.close();
+    m_dirty = false;
+    return true;
+}
+
+void ConfigStore::commit(void)
+{
+    if (!m_dirty)
+    {
+        return;
+    }
+    // 每次提交都重新开始计时 连续的修改合并为一次写入
+    m_commit_pending = true;
+    m_commit_time = millis();
+}
+
+void ConfigStore::routine(void)
+{
+    if (m_commit_pending && millis() - m_commit_time >= CFG_COMMIT_DELAY)
+    {
+        if (!flush())
+        {
+            // 写入失败 稍后重试
+            commit();
+        }
+    }
+}
+
+bool ConfigStore::flush(void)
+{
+    m_commit_pending = false;
+    if (!m_dirty)
+    {
+        return true;
+    }
+
+    File file = SPIFFS.open(CFG_STORE_TMP_PATH, FILE_WRITE);
+    if (!file)
+    {
+        Serial.println(F("[Config] failed to open file for writing"));
+        return false;
+    }
+
+    bool ret = true;
+    CfgFileHeader header = {CFG_STORE_MAGIC, CFG_STORE_VERSION, (uint16_t)m_items.size()};
+    ret &= file.write((const uint8_t *)&header, sizeof(header)) == sizeof(header);
+    for (std::list<CfgItem>::iterator item = m_items.begin(); item != m_items.end(); ++item)
+    {
+        const uint8_t *value = CFG_TYPE_INT == item->type
+                                   ? (const uint8_t *)&item->num
+                                   : (const uint8_t *)item->str.c_str();
+        CfgRecordHeader rec;
+        memset(&rec, 0, sizeof(rec));
+        rec.version = CFG_RECORD_VERSION;
+        rec.type = item->type;
+        rec.key_len = strlen(item->key);
+        rec.value_len = CFG_TYPE_INT == item->type ? sizeof(uint32_t)
+                                                   : min(item->str.length(), (unsigned int)CFG_VALUE_MAX_LEN);
+        rec.crc = record_crc(rec.type, item->key, rec.key_len, value, rec.value_len);
+        ret &= file.write((const uint8_t *)&rec, sizeof(rec)) == sizeof(rec);
+        ret &= file.write((const uint8_t *)item->key, rec.key_len) == rec.key_len;
+        ret &= file.write(value, rec.value_len) == rec.value_len;
+    }
+    file.close();
+
+    if (!ret)
+    {
+        Serial.println(F("[Config] write failed"));
+        SPIFFS.remove(CFG_STORE_TMP_PATH);
+        return false;
+    }
+
+    // SPIFFS不支持覆盖式重命名 begin()中会处理两步之间掉电的情况
+    SPIFFS.remove(CFG_STORE_PATH);
+    if (!SPIFFS.rename(CFG_STORE_TMP_PATH, CFG_STORE_PATH))
+    {
+        Serial.println(F("[Config] rename failed"));
+        return false;
+    }
+    m_dirty = false;
+    ++m_flash_writes;
+    Serial.printf("[Config] flash write #%u\n", m_flash_writes);
+    return true;
+}
+
+bool ConfigStore::hasSection(const char *ns)
+{
+    size_t len = strlen(ns);
+    for (std::list<CfgItem>::iterator item = m_items.begin(); item != m_items.end(); ++item)
+    {
+        if (!strncmp(item->key, ns, len) && '.' == item->key[len])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ConfigStore::migrate(const char *ns, const char *legacy_path,
+                          const char *const *keys, int key_num)
+{
+    if (hasSection(ns))
+    {
+        return true;
+    }
+
+    char info[CFG_LEGACY_MAX_SIZE + 1] = {0};
+    uint16_t size = g_flashCfg.readFile(legacy_path, (uint8_t *)info, CFG_LEGACY_MAX_SIZE);
+    if (0 == size)
+    {
+        return false;
+    }
+    info[size] = 0;
+
+    // 旧文件为每行一个参数 行数不足时只导入已有的部分
+    char *line = info;
+    for (int cnt = 0; cnt < key_num && NULL != line; ++cnt)
+    {
+        char *end = strchr(line, '\n');
+        if (NULL == end)
+        {
+            break;
+        }
+        *end = 0;
+        setString(ns, keys[cnt], line);
+        line = end + 1;
+    }
+    Serial.printf("[Config] migrated %s\n", legacy_path);
+    commit();
+    return true;
+}
+
+CfgItem *ConfigStore::find(const char *ns, const char *key)
+{
+    char full_key[CFG_KEY_MAX_LEN];
+    make_key(full_key, ns, key);
+    for (std::list<CfgItem>::iterator item = m_items.begin(); item != m_items.end(); ++item)
+    {
+        if (!strcmp(item->key, full_key))
+        {
+            return &(*item);
+        }
+    }
+    return NULL;
+}
+
+CfgItem *ConfigStore::obtain(const char *ns, const char *key)
+{
+    CfgItem *item = find(ns, key);
+    if (NULL == item)
+    {
+        CfgItem new_item;
+        make_key(new_item.key, ns, key);
+        new_item.type = CFG_TYPE_NONE;
+        new_item.num = 0;
+        m_items.push_back(new_item);
+        item = &m_items.back();
+    }
+    return item;
+}
+
+int32_t ConfigStore::getInt(const char *ns, const char *key, int32_t def)
+{
+    return (int32_t)getUInt(ns, key, (uint32_t)def);
+}
+
+uint32_t ConfigStore::getUInt(const char *ns, const char *key, uint32_t def)
+{
+    CfgItem *item = find(ns, key);
+    if (NULL == item)
+    {
+        return def;
+    }
+    // 从旧版文本迁移过来的数值以字符串保存
+    return CFG_TYPE_INT == item->type ? item->num : (uint32_t)atol(item->str.c_str());
+}
+
+String ConfigStore::getString(const char *ns, const char *key, const char *def)
+{
+    CfgItem *item = find(ns, key);
+    if (NULL == item)
+    {
+        return String(def);
+    }
+    return CFG_TYPE_STR == item->type ? item->str : String(item->num);
+}
+
+void ConfigStore::getString(const char *ns, const char *key, char *value,
+                            size_t size, const char *def)
+{
+    snprintf(value, size, "%s", getString(ns, key, def).c_str());
+}
+
+void ConfigStore::setInt(const char *ns, const char *key, int32_t value)
+{
+    setUInt(ns, key, (uint32_t)value);
+}
+
+void ConfigStore::setUInt(const char *ns, const char *key, uint32_t value)
+{
+    CfgItem *item = obtain(ns, key);
+    if (CFG_TYPE_INT == item->type && value == item->num)
+    {
+        return;
+    }
+    item->type = CFG_TYPE_INT;
+    item->num = value;
+    item->str = "";
+    m_dirty = true;
+}
+
+void ConfigStore::setString(const char *ns, const char *key, const char *value)
+{
+    CfgItem *item = obtain(ns, key);
+    if (CFG_TYPE_STR == item->type && item->str == value)
+    {
+        return;
+    }
+    item->type = CFG_TYPE_STR;
+    item->num = 0;
+    item->str = value;
+    m_dirty = true;
+}
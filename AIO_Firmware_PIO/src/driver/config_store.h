@@ -0,0 +1,95 @@
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <Arduino.h>
+#include <list>
+
+// 所有APP的配置统一保存在一个二进制文件中（替代原先每个APP一个.cfg文本文件）
+#define CFG_STORE_PATH "/config.db"
+#define CFG_STORE_TMP_PATH "/config.tmp"
+#define CFG_STORE_MAGIC 0x434F4941 // "AIOC"
+#define CFG_STORE_VERSION 1        // 文件格式版本
+#define CFG_RECORD_VERSION 1       // 单条记录的格式版本
+#define CFG_STORE_MAX_SIZE 16384   // 配置文件的最大长度
+#define CFG_KEY_MAX_LEN 48         // "命名空间.键名"的最大长度（含结束符）
+#define CFG_VALUE_MAX_LEN 256      // 单个值的最大长度
+#define CFG_LEGACY_MAX_SIZE 512    // 旧版文本配置文件的最大读取长度
+#define CFG_COMMIT_DELAY 3000      // 最后一次修改后静默多久才写入flash ms
+
+enum CFG_VALUE_TYPE : uint8_t
+{
+    CFG_TYPE_INT = 0, // 32位整数
+    CFG_TYPE_STR,     // 字符串
+
+    CFG_TYPE_NONE
+};
+
+struct CfgItem
+{
+    char key[CFG_KEY_MAX_LEN];
+    CFG_VALUE_TYPE type;
+    uint32_t num;
+    String str;
+};
+
+class ConfigStore
+{
+public:
+    ConfigStore();
+
+    // 启动时调用一次 加载全部配置到内存
+    bool begin(void);
+
+    // 命名空间下是否已经有配置
+    bool hasSection(const char *ns);
+
+    // 旧版本每个APP各有一个文本配置文件（每行一个参数） 现只用于迁移
+    // 命名空间下没有配置时 从legacy_path按keys的顺序导入（只导入已有的行）
+    // 返回值表示命名空间下是否有可用的配置 APP一般在读取配置时传入自己的键表调用
+    template <int N>
+    bool migrate(const char *ns, const char *legacy_path, const char *const (&keys)[N])
+    {
+        return migrate(ns, legacy_path, keys, N);
+    }
+    bool migrate(const char *ns, const char *legacy_path,
+                 const char *const *keys, int key_num);
+
+    int32_t getInt(const char *ns, const char *key, int32_t def = 0);
+    uint32_t getUInt(const char *ns, const char *key, uint32_t def = 0);
+    String getString(const char *ns, const char *key, const char *def = "");
+    // 读取到定长的字符数组中
+    void getString(const char *ns, const char *key, char *value,
+                   size_t size, const char *def = "");
+
+    void setInt(const char *ns, const char *key, int32_t value);
+    void setUInt(const char *ns, const char *key, uint32_t value);
+    void setString(const char *ns, const char *key, const char *value);
+
+    // 提交修改 实际在静默CFG_COMMIT_DELAY后由routine()写入flash
+    // 短时间内的多次提交只会产生一次flash写入
+    void commit(void);
+
+    // 立即将未写入的修改写入flash（先写临时文件再替换 保证掉电时旧配置仍然可用）
+    // APP退出、关机或重启前调用
+    bool flush(void);
+
+    // 在主循环中调用 到期后写入延迟的修改
+    void routine(void);
+
+    // 本次开机以来写入flash的次数
+    uint32_t getFlashWrites(void) { return m_flash_writes; }
+
+private:
+    CfgItem *find(const char *ns, const char *key);
+    CfgItem *obtain(const char *ns, const char *key);
+    bool load(const char *path);
+
+private:
+    std::list<CfgItem> m_items;
+    bool m_dirty;
+    bool m_commit_pending;       // 是否有等待写入的提交
+    unsigned long m_commit_time; // 最后一次提交的时间
+    uint32_t m_flash_writes;
+};
+
+#endif
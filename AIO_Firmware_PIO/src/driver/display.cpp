@@ -12,6 +12,7 @@ static lv_color_t buf[SCREEN_HOR_RES * LV_HOR_RES_MAX_LEN];
 
 void my_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p)
 {
+    METRIC_TIME_START(flush_start);
     uint32_t w = (area->x2 - area->x1 + 1);
     uint32_t h = (area->y2 - area->y1 + 1);
 
@@ -23,6 +24,7 @@ void my_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color
     // Initiate DMA - blocking only if last DMA is not complete
     // tft->pushImageDMA(area->x1, area->y1, w, h, bitmap, &color_p->full);
 
+    METRIC_TIME_END_US(METRIC_LVGL_FLUSH_US, flush_start);
     lv_disp_flush_ready(disp);
 }
 
@@ -63,9 +65,11 @@ void Display::init(uint8_t rotation, uint8_t backLight)
     lv_disp_drv_register(&disp_drv);
 }
 
-void Display::routine()
+uint32_t Display::routine()
 {
-    AIO_LVGL_OPERATE_LOCK(lv_timer_handler();)
+    uint32_t next_ms = 0;
+    AIO_LVGL_OPERATE_LOCK(next_ms = lv_timer_handler();)
+    return next_ms;
 }
 
 /**
@@ -9,7 +9,7 @@ public:
     bool night_mode = false; // 是否处于夜间模式
 
     void init(uint8_t rotation, uint8_t backLight);
-    void routine();
+    uint32_t routine(); // 返回距离LVGL下一个定时任务的时间 ms
     void setBackLight(float);
     uint8_t getBrightness();
 private:
@@ -120,7 +120,7 @@ void FlashFS::listDir(const char *dirname, uint8_t levels)
 //     }
 // }
 
-uint16_t FlashFS::readFile(const char *path, uint8_t *info)
+uint16_t FlashFS::readFile(const char *path, uint8_t *info, uint16_t max_len)
 {
     Serial.printf("Reading file: %s\r\n", path);
 
@@ -133,9 +133,9 @@ uint16_t FlashFS::readFile(const char *path, uint8_t *info)
     }
 
     // Serial.println("- read from file:");
-    while (file.available())
+    while (file.available() && ret_len < max_len)
     {
-        ret_len += file.read(info + ret_len, 15);
+        ret_len += file.read(info + ret_len, min(15, max_len - ret_len));
         // Serial.write(file.read());
     }
     file.close();
@@ -16,7 +16,8 @@ public:
 
     // void removeDir(const char *path);
 
-    uint16_t readFile(const char *path, uint8_t *info);
+    // 最多读取max_len个字节 返回实际读取的长度
+    uint16_t readFile(const char *path, uint8_t *info, uint16_t max_len);
 
     void writeFile(const char *path, const char *message);
 
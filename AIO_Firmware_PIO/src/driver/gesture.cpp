@@ -0,0 +1,228 @@
+#include "gesture.h"
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+#define SHAKE_ENERGY_SHIFT 3 // 角速度强度的滤波系数
+
+void gesture_default_config(GestureConfig *cfg)
+{
+    cfg->tilt_enter = 4000;
+    cfg->tilt_exit = 3000;
+    cfg->pitch_enter = 5000;
+    cfg->pitch_exit = 4000;
+    cfg->shake_gyro = 20000;
+    cfg->settle_time = 30;
+    cfg->hold_time = 400;
+    cfg->repeat_time = 200;
+    cfg->shake_time = 150;
+    cfg->filter_shift = 2;
+}
+
+static int16_t clamp_int16(int16_t value, int16_t low, int16_t high)
+{
+    return value < low ? low : (value > high ? high : value);
+}
+
+const char *const gesture_param_name[GESTURE_PARAM_NUM] = {
+    "tilt_enter", "tilt_exit", "pitch_enter", "pitch_exit", "shake_gyro",
+    "settle_time", "hold_time", "repeat_time", "shake_time", "filter_shift"};
+
+int16_t *gesture_param(GestureConfig *cfg, const char *name)
+{
+    // 与gesture_param_name的顺序一致
+    int16_t *params[GESTURE_PARAM_NUM] = {
+        &cfg->tilt_enter, &cfg->tilt_exit, &cfg->pitch_enter, &cfg->pitch_exit,
+        &cfg->shake_gyro, &cfg->settle_time, &cfg->hold_time, &cfg->repeat_time,
+        &cfg->shake_time, &cfg->filter_shift};
+    for (int pos = 0; pos < GESTURE_PARAM_NUM; ++pos)
+    {
+        if (!strcmp(name, gesture_param_name[pos]))
+        {
+            return params[pos];
+        }
+    }
+    return NULL;
+}
+
+GestureEngine::GestureEngine()
+{
+    gesture_default_config(&m_cfg);
+    m_cb = NULL;
+    m_user_data = NULL;
+
+    const ACTIVE_TYPE types[4] = {TURN_LEFT, TURN_RIGHT, UP, DOWN};
+    const ACTIVE_TYPE long_types[4] = {UNKNOWN, UNKNOWN, GO_FORWORD, RETURN};
+    for (int pos = 0; pos < 4; ++pos)
+    {
+        m_tilt[pos].type = types[pos];
+        m_tilt[pos].long_type = long_types[pos];
+    }
+    reset();
+}
+
+void GestureEngine::setConfig(const GestureConfig *cfg)
+{
+    m_cfg = *cfg;
+    // 退出阈值不能高于进入阈值 否则滞回失效
+    m_cfg.tilt_exit = std::min(m_cfg.tilt_exit, m_cfg.tilt_enter);
+    m_cfg.pitch_exit = std::min(m_cfg.pitch_exit, m_cfg.pitch_enter);
+    m_cfg.filter_shift = clamp_int16(m_cfg.filter_shift, 0, 6);
+    // 时间不能为负 之后与无符号的时间差比较
+    m_cfg.settle_time = clamp_int16(m_cfg.settle_time, 0, INT16_MAX);
+    m_cfg.hold_time = clamp_int16(m_cfg.hold_time, 0, INT16_MAX);
+    m_cfg.repeat_time = clamp_int16(m_cfg.repeat_time, 0, INT16_MAX);
+    m_cfg.shake_time = clamp_int16(m_cfg.shake_time, 0, INT16_MAX);
+    reset();
+}
+
+void GestureEngine::setCallback(gesture_event_cb_t cb, void *user_data)
+{
+    m_cb = cb;
+    m_user_data = user_data;
+}
+
+void GestureEngine::reset(void)
+{
+    memset(&m_filtered, 0, sizeof(m_filtered));
+    m_filtered.active = ACTIVE_TYPE::UNKNOWN;
+    m_shake_energy = 0;
+    m_shaking = false;
+    m_shake_reported = false;
+    m_shake_start = 0;
+    m_time = 0;
+    for (int pos = 0; pos < 4; ++pos)
+    {
+        m_tilt[pos].state = GESTURE_IDLE;
+        m_tilt[pos].enter_time = 0;
+        m_tilt[pos].last_report = 0;
+    }
+}
+
+void GestureEngine::update(const ImuAction *sample, uint16_t dt)
+{
+    m_time += dt;
+
+    // 加速度低通滤波 保留重力方向（即设备的倾斜）
+    int32_t div = 1 << m_cfg.filter_shift;
+    m_filtered.v_ax += (sample->v_ax - m_filtered.v_ax) / div;
+    m_filtered.v_ay += (sample->v_ay - m_filtered.v_ay) / div;
+    m_filtered.v_az += (sample->v_az - m_filtered.v_az) / div;
+    m_filtered.v_gx = sample->v_gx;
+    m_filtered.v_gy = sample->v_gy;
+    m_filtered.v_gz = sample->v_gz;
+
+    // 角速度强度 用于区分晃动与倾斜
+    int32_t energy = abs(sample->v_gx) + abs(sample->v_gy) + abs(sample->v_gz);
+    m_shake_energy += (energy - m_shake_energy) >> SHAKE_ENERGY_SHIFT;
+    updateShake();
+
+    // 同一时间只允许一个倾斜动作 按旧版的优先级（左右优先于前后）
+    int32_t values[4] = {m_filtered.v_ay, -m_filtered.v_ay,
+                         m_filtered.v_ax, -m_filtered.v_ax};
+    for (int pos = 0; pos < 4; ++pos)
+    {
+        bool blocked = m_shaking;
+        for (int other = 0; other < 4 && !blocked; ++other)
+        {
+            blocked = other != pos && GESTURE_IDLE != m_tilt[other].state;
+        }
+        if (pos < 2)
+        {
+            updateTilt(&m_tilt[pos], values[pos], m_cfg.tilt_enter, m_cfg.tilt_exit, blocked);
+        }
+        else
+        {
+            updateTilt(&m_tilt[pos], values[pos], m_cfg.pitch_enter, m_cfg.pitch_exit, blocked);
+        }
+    }
+}
+
+void GestureEngine::updateTilt(GestureState *gesture, int32_t value,
+                               int32_t enter, int32_t exit, bool blocked)
+{
+    switch (gesture->state)
+    {
+    case GESTURE_IDLE:
+        if (!blocked && value > enter)
+        {
+            gesture->state = GESTURE_PENDING;
+            gesture->enter_time = m_time;
+        }
+        break;
+    case GESTURE_PENDING:
+        if (value < exit || m_shaking)
+        {
+            // 没有保持足够长的时间 视为抖动
+            gesture->state = GESTURE_IDLE;
+        }
+        else if (m_time - gesture->enter_time >= (unsigned long)m_cfg.settle_time)
+        {
+            gesture->state = GESTURE_ACTIVE;
+            gesture->last_report = m_time;
+            report(gesture->type, false);
+        }
+        break;
+    case GESTURE_ACTIVE:
+        if (value < exit)
+        {
+            gesture->state = GESTURE_IDLE;
+        }
+        else if (UNKNOWN != gesture->long_type)
+        {
+            if (m_time - gesture->enter_time >= (unsigned long)m_cfg.hold_time)
+            {
+                gesture->state = GESTURE_HELD;
+                report(gesture->long_type, true);
+            }
+        }
+        else if (m_time - gesture->last_report >= (unsigned long)m_cfg.repeat_time)
+        {
+            gesture->last_report = m_time;
+            report(gesture->type, false);
+        }
+        break;
+    case GESTURE_HELD:
+        if (value < exit)
+        {
+            gesture->state = GESTURE_IDLE;
+        }
+        break;
+    default:
+        gesture->state = GESTURE_IDLE;
+        break;
+    }
+}
+
+void GestureEngine::updateShake(void)
+{
+    if (!m_shaking)
+    {
+        if (m_shake_energy > m_cfg.shake_gyro)
+        {
+            m_shaking = true;
+            m_shake_reported = false;
+            m_shake_start = m_time;
+        }
+        return;
+    }
+
+    // 回落到阈值的一半以下才算结束
+    if (m_shake_energy < m_cfg.shake_gyro / 2)
+    {
+        m_shaking = false;
+    }
+    else if (!m_shake_reported && m_time - m_shake_start >= (unsigned long)m_cfg.shake_time)
+    {
+        m_shake_reported = true;
+        report(ACTIVE_TYPE::SHAKE, false);
+    }
+}
+
+void GestureEngine::report(ACTIVE_TYPE active, bool long_time)
+{
+    if (NULL != m_cb)
+    {
+        m_cb(active, long_time, m_user_data);
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef GESTURE_H
+#define GESTURE_H
+
+#include "imu_types.h"
+
+// 动作识别的阈值（原始数据单位 加速度16384为1g 陀螺仪131为1°/s）
+// 全部使用int16_t 方便按名字统一读写
+struct GestureConfig
+{
+    int16_t tilt_enter;    // 左右倾的进入阈值
+    int16_t tilt_exit;     // 左右倾的退出阈值（小于进入阈值 形成滞回）
+    int16_t pitch_enter;   // 前后倾的进入阈值
+    int16_t pitch_exit;    // 前后倾的退出阈值
+    int16_t shake_gyro;    // 判定为晃动的角速度强度
+    int16_t settle_time;   // 超过阈值持续多久才确认动作 ms
+    int16_t hold_time;     // 前后倾保持多久识别为长按 ms
+    int16_t repeat_time;   // 左右倾保持时重复上报的间隔 ms
+    int16_t shake_time;    // 晃动持续多久才确认 ms
+    int16_t filter_shift;  // 加速度低通滤波 新样本的权重为1/(2^shift)
+};
+
+// 识别出一个动作时的回调
+typedef void (*gesture_event_cb_t)(ACTIVE_TYPE active, bool long_time, void *user_data);
+
+/*
+ * 动作识别引擎
+ * 不依赖具体的传感器 输入按时间顺序排列、已调整过方向的样本即可
+ * 因此也可以用记录下来的样本回放调试阈值
+ */
+class GestureEngine
+{
+public:
+    GestureEngine();
+
+    void setConfig(const GestureConfig *cfg);
+    void setCallback(gesture_event_cb_t cb, void *user_data);
+    void reset(void);
+
+    // 输入一个样本 dt为与上一个样本的间隔 ms
+    void update(const ImuAction *sample, uint16_t dt);
+
+    // 滤波后的数据
+    const ImuAction *getFiltered(void) const { return &m_filtered; }
+    unsigned long getTime(void) const { return m_time; }
+
+private:
+    enum GESTURE_STATE
+    {
+        GESTURE_IDLE = 0, // 未触发
+        GESTURE_PENDING,  // 超过进入阈值 等待确认
+        GESTURE_ACTIVE,   // 已上报短按
+        GESTURE_HELD      // 已上报长按 等待回到退出阈值以下
+    };
+
+    struct GestureState
+    {
+        ACTIVE_TYPE type;
+        ACTIVE_TYPE long_type; // 长按对应的动作 UNKNOWN表示没有长按（保持时重复上报）
+        GESTURE_STATE state;
+        unsigned long enter_time;
+        unsigned long last_report;
+    };
+
+    void updateTilt(GestureState *gesture, int32_t value,
+                    int32_t enter, int32_t exit, bool blocked);
+    void updateShake(void);
+    void report(ACTIVE_TYPE active, bool long_time);
+
+private:
+    GestureConfig m_cfg;
+    gesture_event_cb_t m_cb;
+    void *m_user_data;
+
+    ImuAction m_filtered;
+    int32_t m_shake_energy; // 角速度强度的滤波值
+    bool m_shaking;         // 角速度强度超过阈值（此时不识别倾斜）
+    bool m_shake_reported;  // 本次晃动已上报
+    unsigned long m_shake_start;
+    unsigned long m_time;
+
+    GestureState m_tilt[4]; // 左、右、前、后
+};
+
+// 默认阈值（与旧版的固定阈值一致）
+void gesture_default_config(GestureConfig *cfg);
+
+// 阈值的名字（同时也是配置存储中的键名）
+#define GESTURE_PARAM_NUM 10
+extern const char *const gesture_param_name[GESTURE_PARAM_NUM];
+
+// 按名字取得阈值的地址 名字不存在时返回NULL
+int16_t *gesture_param(GestureConfig *cfg, const char *name);
+
+#endif
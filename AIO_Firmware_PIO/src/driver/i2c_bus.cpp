@@ -0,0 +1,170 @@
+#include "i2c_bus.h"
+#include "common.h"
+
+I2cBus::I2cBus()
+{
+    m_mutex = NULL;
+    m_started = false;
+    m_owner = 0;
+    m_lock_start = 0;
+    m_job_num = 0;
+    m_dev_num = 0;
+}
+
+void I2cBus::begin(int sda, int scl, uint32_t freq)
+{
+    if (m_started)
+    {
+        return;
+    }
+    m_mutex = xSemaphoreCreateMutex();
+    Wire.begin(sda, scl);
+    Wire.setClock(freq);
+    m_started = true;
+}
+
+bool I2cBus::lock(uint8_t addr, TickType_t wait)
+{
+    if (NULL == m_mutex || pdTRUE != xSemaphoreTake(m_mutex, wait))
+    {
+        return false;
+    }
+    m_owner = addr;
+    m_lock_start = micros();
+    return true;
+}
+
+void I2cBus::unlock(bool ok)
+{
+    record(m_owner, ok, micros() - m_lock_start);
+    // 趁总线空闲把到期的周期读取一起做完 避免之后再单独抢占一次总线
+    runJobs();
+    xSemaphoreGive(m_mutex);
+}
+
+int8_t I2cBus::addJob(uint8_t addr, uint16_t period, i2c_job_cb_t cb, void *user_data)
+{
+    if (m_job_num >= I2C_BUS_MAX_JOBS)
+    {
+        return -1;
+    }
+    I2cJob *job = &m_jobs[m_job_num];
+    job->addr = addr;
+    job->period = period;
+    job->next_time = GET_SYS_MILLIS() + period;
+    job->active = true;
+    job->cb = cb;
+    job->user_data = user_data;
+    return m_job_num++;
+}
+
+void I2cBus::setJobPeriod(int8_t job, uint16_t period)
+{
+    if (job >= 0 && job < m_job_num)
+    {
+        m_jobs[job].period = period;
+    }
+}
+
+void I2cBus::setJobActive(int8_t job, bool active)
+{
+    if (job >= 0 && job < m_job_num)
+    {
+        m_jobs[job].next_time = GET_SYS_MILLIS() + m_jobs[job].period;
+        m_jobs[job].active = active;
+    }
+}
+
+void I2cBus::poll(void)
+{
+    if (!hasDueJob(GET_SYS_MILLIS()) || NULL == m_mutex)
+    {
+        return;
+    }
+    if (pdTRUE == xSemaphoreTake(m_mutex, portMAX_DELAY))
+    {
+        runJobs();
+        xSemaphoreGive(m_mutex);
+    }
+}
+
+bool I2cBus::hasDueJob(unsigned long now)
+{
+    for (uint8_t pos = 0; pos < m_job_num; ++pos)
+    {
+        if (m_jobs[pos].active && (long)(now - m_jobs[pos].next_time) >= 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void I2cBus::runJobs(void)
+{
+    unsigned long now = GET_SYS_MILLIS();
+    for (uint8_t pos = 0; pos < m_job_num; ++pos)
+    {
+        I2cJob *job = &m_jobs[pos];
+        if (!job->active || (long)(now - job->next_time) < 0)
+        {
+            continue;
+        }
+        uint32_t start = micros();
+        bool ok = job->cb(job->user_data);
+        record(job->addr, ok, micros() - start);
+
+        // 按固定节拍推进 落后太多时（例如长时间校准占用总线）直接对齐到当前时间
+        job->next_time += job->period;
+        if ((long)(now - job->next_time) >= 0)
+        {
+            job->next_time = now + job->period;
+        }
+    }
+}
+
+void I2cBus::record(uint8_t addr, bool ok, uint32_t elapsed)
+{
+    I2cDevStats *stats = (I2cDevStats *)getStats(addr);
+    if (NULL == stats)
+    {
+        if (m_dev_num >= I2C_BUS_MAX_DEVICES)
+        {
+            return;
+        }
+        stats = &m_stats[m_dev_num++];
+        memset(stats, 0, sizeof(I2cDevStats));
+        stats->addr = addr;
+    }
+    ++stats->count;
+    stats->total_us += elapsed;
+    stats->max_us = max(stats->max_us, elapsed);
+    if (!ok)
+    {
+        ++stats->errors;
+    }
+}
+
+const I2cDevStats *I2cBus::getStats(uint8_t addr)
+{
+    for (uint8_t pos = 0; pos < m_dev_num; ++pos)
+    {
+        if (addr == m_stats[pos].addr)
+        {
+            return &m_stats[pos];
+        }
+    }
+    return NULL;
+}
+
+void I2cBus::printStats(Print *out)
+{
+    for (uint8_t pos = 0; pos < m_dev_num; ++pos)
+    {
+        const I2cDevStats *stats = &m_stats[pos];
+        out->printf("[I2C] 0x%02X count %u errors %u avg %uus max %uus\n",
+                      stats->addr, stats->count, stats->errors,
+                      stats->count ? stats->total_us / stats->count : 0,
+                      stats->max_us);
+    }
+}
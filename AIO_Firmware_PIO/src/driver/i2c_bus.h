@@ -0,0 +1,81 @@
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define I2C_BUS_FREQ 400000    // 总线时钟 Hz
+#define I2C_BUS_MAX_DEVICES 4  // 统计信息最多记录的设备数
+#define I2C_BUS_MAX_JOBS 4     // 最多登记的周期读取
+
+// 一次周期读取 返回false表示传输出错
+typedef bool (*i2c_job_cb_t)(void *user_data);
+
+// 每个设备的传输统计
+struct I2cDevStats
+{
+    uint8_t addr;
+    uint32_t count;  // 传输次数
+    uint32_t errors; // 出错次数
+    uint32_t total_us;
+    uint32_t max_us;
+};
+
+/*
+ * I2C总线管理
+ * IMU与光线传感器共用同一组引脚 且分别在不同的任务中访问
+ * 所有对Wire的访问都必须在lock()/unlock()之间进行
+ * 周期性的读取通过addJob()登记 到期后在下一次释放总线前集中完成
+ */
+class I2cBus
+{
+public:
+    I2cBus();
+
+    void begin(int sda, int scl, uint32_t freq = I2C_BUS_FREQ);
+
+    // 占用总线 addr用于统计
+    bool lock(uint8_t addr, TickType_t wait = portMAX_DELAY);
+    // 释放总线 ok为本次传输是否成功
+    void unlock(bool ok = true);
+
+    // 登记周期读取 返回编号 已满时返回-1
+    int8_t addJob(uint8_t addr, uint16_t period, i2c_job_cb_t cb, void *user_data);
+    void setJobPeriod(int8_t job, uint16_t period);
+    // 暂停或恢复周期读取（恢复后一个周期才到期） 需在占用总线时调用
+    void setJobActive(int8_t job, bool active);
+    // 没有其他传输时 由调用者触发已到期的周期读取
+    void poll(void);
+
+    const I2cDevStats *getStats(uint8_t addr);
+    void printStats(Print *out);
+
+private:
+    struct I2cJob
+    {
+        uint8_t addr;
+        uint16_t period; // ms
+        unsigned long next_time;
+        bool active;
+        i2c_job_cb_t cb;
+        void *user_data;
+    };
+
+    bool hasDueJob(unsigned long now);
+    void runJobs(void);
+    void record(uint8_t addr, bool ok, uint32_t elapsed);
+
+private:
+    SemaphoreHandle_t m_mutex;
+    bool m_started;
+    uint8_t m_owner;       // 当前占用总线的设备
+    uint32_t m_lock_start; // 本次传输的开始时间 us
+
+    I2cJob m_jobs[I2C_BUS_MAX_JOBS];
+    uint8_t m_job_num;
+
+    I2cDevStats m_stats[I2C_BUS_MAX_DEVICES];
+    uint8_t m_dev_num;
+};
+
+#endif
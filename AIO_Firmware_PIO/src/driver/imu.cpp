@@ -1,23 +1,42 @@
 #include "imu.h"
+#include "gesture.h"
 #include "common.h"
+#include "sys/loop_wake.h"
 
 const char *active_type_info[] = {"TURN_RIGHT", "RETURN",
                                   "TURN_LEFT", "UP",
                                   "DOWN", "GO_FORWORD",
                                   "SHAKE", "UNKNOWN"};
 
+#if IMU_INT_PIN >= 0
+static TaskHandle_t imu_task_handle = NULL;
+
+static void IRAM_ATTR imu_data_ready_isr(void)
+{
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(imu_task_handle, &woken);
+    if (woken)
+    {
+        portYIELD_FROM_ISR();
+    }
+}
+#endif
+
 IMU::IMU()
 {
     action_info.isValid = false;
     action_info.active = ACTIVE_TYPE::UNKNOWN;
     action_info.long_time = true;
-    // 初始化数据
-    for (int pos = 0; pos < ACTION_HISTORY_BUF_LEN; ++pos)
-    {
-        // act_info_history.push_back(UNKNOWN);
-        act_info_history[pos] = UNKNOWN;
-    }
-    act_info_history_ind = ACTION_HISTORY_BUF_LEN - 1;
+    m_task = NULL;
+    m_event_queue = NULL;
+    m_engine = NULL;
+    m_new_cfg = NULL;
+    m_trace = false;
+    m_drift_state = DRIFT_IDLE;
+    m_offsets_valid = false;
+    m_sample_count = 0;
+    m_drift_num = 0;
+    m_offsets_ready = false;
     this->order = 0; // 表示方位
 }
 
@@ -25,156 +44,377 @@ void IMU::init(uint8_t order, uint8_t auto_calibration,
                SysMpuConfig *mpu_cfg)
 {
     this->setOrder(order); // 设置方向
-    Wire.begin(IMU_I2C_SDA, IMU_I2C_SCL);
-    Wire.setClock(400000);
+    // 总线已由g_i2cBus初始化（与光线传感器共用）
     unsigned long timeout = 5000;
     unsigned long preMillis = GET_SYS_MILLIS();
     // mpu = MPU6050(0x68, &Wire);
-    mpu = MPU6050(0x68);
-    while (!mpu.testConnection() && !doDelayMillisTime(timeout, &preMillis, false))
-        ;
+    mpu = MPU6050(MPU6050_DEFAULT_ADDRESS);
+    bool connected = false;
+    do
+    {
+        g_i2cBus.lock(MPU6050_DEFAULT_ADDRESS);
+        connected = mpu.testConnection();
+        g_i2cBus.unlock(connected);
+        if (!connected)
+        {
+            // 在启动任务中执行 让出CPU以免触发看门狗
+            delay(10);
+        }
+    } while (!connected && !doDelayMillisTime(timeout, &preMillis, false));
 
-    if (!mpu.testConnection())
+    if (!connected)
     {
         Serial.print(F("Unable to connect to MPU6050.\n"));
         return;
     }
 
-    Serial.print(F("Initialization MPU6050 now, Please don't move.\n"));
+    Serial.print(F("Initialization MPU6050 now.\n"));
+    g_i2cBus.lock(MPU6050_DEFAULT_ADDRESS);
     mpu.initialize();
 
-    if (auto_calibration == 0)
+    // 直接使用保存的校准值 全为0表示从未校准过
+    m_offsets_valid = 0 != mpu_cfg->x_gyro_offset || 0 != mpu_cfg->y_gyro_offset ||
+                      0 != mpu_cfg->z_gyro_offset || 0 != mpu_cfg->x_accel_offset ||
+                      0 != mpu_cfg->y_accel_offset || 0 != mpu_cfg->z_accel_offset;
+    mpu.setXGyroOffset(mpu_cfg->x_gyro_offset);
+    mpu.setYGyroOffset(mpu_cfg->y_gyro_offset);
+    mpu.setZGyroOffset(mpu_cfg->z_gyro_offset);
+    mpu.setXAccelOffset(mpu_cfg->x_accel_offset);
+    mpu.setYAccelOffset(mpu_cfg->y_accel_offset);
+    mpu.setZAccelOffset(mpu_cfg->z_accel_offset);
+
+    if (0 != auto_calibration)
     {
-        // supply your own gyro offsets here, scaled for min sensitivity
-        mpu.setXGyroOffset(mpu_cfg->x_gyro_offset);
-        mpu.setYGyroOffset(mpu_cfg->y_gyro_offset);
-        mpu.setZGyroOffset(mpu_cfg->z_gyro_offset);
-        mpu.setXAccelOffset(mpu_cfg->x_accel_offset);
-        mpu.setYAccelOffset(mpu_cfg->y_accel_offset);
-        mpu.setZAccelOffset(mpu_cfg->z_accel_offset); // 1688 factory default for my test chip
+        // 自动校准改为在后台检查零漂 只有超出阈值（或从未校准过）才重新校准
+        m_drift_state = DRIFT_WAIT;
     }
-    else
-    {
-        // 启动自动校准
-        // 7次循环自动校正
-        mpu.CalibrateAccel(7);
-        mpu.CalibrateGyro(7);
-        mpu.PrintActiveOffsets();
 
-        mpu_cfg->x_gyro_offset = mpu.getXGyroOffset();
-        mpu_cfg->y_gyro_offset = mpu.getYGyroOffset();
-        mpu_cfg->z_gyro_offset = mpu.getZGyroOffset();
-        mpu_cfg->x_accel_offset = mpu.getXAccelOffset();
-        mpu_cfg->y_accel_offset = mpu.getYAccelOffset();
-        mpu_cfg->z_accel_offset = mpu.getZAccelOffset();
-    }
+    // 陀螺仪与加速度计的数据按固定采样率写入FIFO 由采样任务批量读取
+    mpu.setDLPFMode(MPU6050_DLPF_BW_42);
+    mpu.setRate(1000 / IMU_SAMPLE_RATE - 1); // 开启DLPF时内部输出频率为1kHz
+    mpu.setFIFOEnabled(false);
+    mpu.setAccelFIFOEnabled(true);
+    mpu.setXGyroFIFOEnabled(true);
+    mpu.setYGyroFIFOEnabled(true);
+    mpu.setZGyroFIFOEnabled(true);
+    mpu.resetFIFO();
+    mpu.setFIFOEnabled(true);
+#if IMU_INT_PIN >= 0
+    mpu.setIntDataReadyEnabled(true);
+#endif
+    g_i2cBus.unlock();
+
+    m_engine = new GestureEngine();
+    m_engine->setCallback(onGesture, this);
+    m_event_queue = xQueueCreate(IMU_EVENT_QUEUE_LEN, sizeof(ImuAction));
+    xTaskCreatePinnedToCore(sampleTask, "ImuSample", 4 * 1024, this,
+                            TASK_IMU_PRIORITY, &m_task, 0);
+    METRIC_WATCH_TASK("ImuSample", m_task);
+#if IMU_INT_PIN >= 0
+    imu_task_handle = m_task;
+    pinMode(IMU_INT_PIN, INPUT);
+    attachInterrupt(IMU_INT_PIN, imu_data_ready_isr, RISING);
+#endif
 
     Serial.print(F("Initialization MPU6050 success.\n"));
 }
 
-void IMU::setOrder(uint8_t order) // 设置方向
+void IMU::sampleTask(void *parameter)
 {
-    this->order = order; // 表示方位
+    IMU *imu = (IMU *)parameter;
+    for (;;)
+    {
+        // 有中断引脚时由数据就绪中断唤醒 否则按IMU_POLL_PERIOD定时读取
+        ulTaskNotifyTake(pdTRUE, IMU_POLL_PERIOD / portTICK_PERIOD_MS);
+        // 释放总线时会顺带完成其他设备已到期的读取
+        g_i2cBus.lock(MPU6050_DEFAULT_ADDRESS);
+        imu->readFifo();
+        g_i2cBus.unlock();
+
+        if (DRIFT_RECALIBRATE == imu->m_drift_state)
+        {
+            // 校准耗时较长 不能一直占用总线 在其中每次访问寄存器时单独占用
+            imu->recalibrate();
+            imu->m_drift_state = DRIFT_IDLE;
+        }
+    }
 }
 
-bool IMU::Encoder_GetIsPush(void)
+void IMU::readFifo(void)
 {
-#ifdef PEAK
-    return (digitalRead(CONFIG_ENCODER_PUSH_PIN) == LOW);
-#else
-    return false;
-#endif
+    // 调用者需已占用I2C总线
+    const uint8_t sample_size = 12; // 加速度计与陀螺仪各6字节
+    uint8_t buf[IMU_FIFO_BATCH * sample_size];
+
+    uint16_t count = mpu.getFIFOCount();
+    if (count > 1024 - sample_size)
+    {
+        // FIFO即将溢出 数据已经错位 直接丢弃
+        mpu.resetFIFO();
+        return;
+    }
+
+    while (count >= sample_size)
+    {
+        uint16_t num = min(count / sample_size, IMU_FIFO_BATCH);
+        mpu.getFIFOBytes(buf, num * sample_size);
+        for (uint16_t pos = 0; pos < num; ++pos)
+        {
+            uint8_t *data = buf + pos * sample_size;
+            ImuAction sample;
+            sample.v_ax = (int16_t)((data[0] << 8) | data[1]);
+            sample.v_ay = (int16_t)((data[2] << 8) | data[3]);
+            sample.v_az = (int16_t)((data[4] << 8) | data[5]);
+            sample.v_gx = (int16_t)((data[6] << 8) | data[7]);
+            sample.v_gy = (int16_t)((data[8] << 8) | data[9]);
+            sample.v_gz = (int16_t)((data[10] << 8) | data[11]);
+            processSample(&sample);
+            if (DRIFT_RECALIBRATE == m_drift_state)
+            {
+                // 剩下的样本在校准后随FIFO一起丢弃
+                return;
+            }
+        }
+        count -= num * sample_size;
+    }
 }
 
-ImuAction *IMU::getAction(void)
+void IMU::processSample(ImuAction *sample)
 {
-    // 基本方法: 通过对近来的动作数据简单的分析，确定出动作的类型
-    ImuAction tmp_info;
-    getVirtureMotion6(&tmp_info);
+    if (NULL != m_new_cfg)
+    {
+        m_engine->setConfig(m_new_cfg);
+        m_new_cfg = NULL;
+    }
 
-    // Serial.printf("gx = %d\tgy = %d\tgz = %d", tmp_info.v_gx, tmp_info.v_gy, tmp_info.v_gz);
-    // Serial.printf("\tax = %d\tay = %d\taz = %d\n", tmp_info.v_ax, tmp_info.v_ay, tmp_info.v_az);
+    ++m_sample_count;
+    if (DRIFT_IDLE != m_drift_state)
+    {
+        checkDrift(sample); // 使用未调整方向的数据 与校准值的坐标一致
+    }
 
-    tmp_info.active = ACTIVE_TYPE::UNKNOWN;
+    applyOrder(sample);
+    m_engine->update(sample, IMU_SAMPLE_PERIOD);
+    if (m_trace)
+    {
+        // 格式: IMU,时间,ax,ay,az,gx,gy,gz
+        Serial.printf("IMU,%lu,%d,%d,%d,%d,%d,%d\n", m_engine->getTime(),
+                      sample->v_ax, sample->v_ay, sample->v_az,
+                      sample->v_gx, sample->v_gy, sample->v_gz);
+    }
+}
 
-    // 原先判断的只是加速度，现在要加上陀螺仪
-    if (ACTIVE_TYPE::UNKNOWN == tmp_info.active)
+void IMU::checkDrift(const ImuAction *raw)
+{
+    if (DRIFT_WAIT == m_drift_state)
     {
-        if (tmp_info.v_ay > 4000)
-        {
-            tmp_info.active = ACTIVE_TYPE::TURN_LEFT;
-        }
-        else if (tmp_info.v_ay < -4000)
-        {
-            tmp_info.active = ACTIVE_TYPE::TURN_RIGHT;
-        }
-        else if (tmp_info.v_ay > 1000 || tmp_info.v_ay < -1000)
+        if (m_sample_count * IMU_SAMPLE_PERIOD >= IMU_DRIFT_CHECK_DELAY)
         {
-            // 震动检测
-            tmp_info.active = ACTIVE_TYPE::SHAKE;
+            m_drift_state = DRIFT_CHECK;
+            m_drift_num = 0;
         }
+        return;
     }
 
-    if (ACTIVE_TYPE::UNKNOWN == tmp_info.active)
+    const int16_t gyro[3] = {raw->v_gx, raw->v_gy, raw->v_gz};
+    for (int axis = 0; axis < 3; ++axis)
     {
-        if (tmp_info.v_ax > 5000)
+        if (0 == m_drift_num)
         {
-            tmp_info.active = ACTIVE_TYPE::UP;
+            m_drift_sum[axis] = 0;
+            m_drift_min[axis] = gyro[axis];
+            m_drift_max[axis] = gyro[axis];
         }
-        else if (tmp_info.v_ax < -5000)
+        m_drift_sum[axis] += gyro[axis];
+        m_drift_min[axis] = min(m_drift_min[axis], gyro[axis]);
+        m_drift_max[axis] = max(m_drift_max[axis], gyro[axis]);
+    }
+    if (++m_drift_num < IMU_DRIFT_WINDOW)
+    {
+        return;
+    }
+    m_drift_num = 0;
+
+    bool drift = !m_offsets_valid;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        if (m_drift_max[axis] - m_drift_min[axis] > IMU_DRIFT_STILL_RANGE)
         {
-            tmp_info.active = ACTIVE_TYPE::DOWN;
+            // 设备在运动 下一个窗口再检查
+            return;
         }
-        else if (action_info.v_ax > 1000 || action_info.v_ax < -1000)
+        drift |= abs(m_drift_sum[axis] / IMU_DRIFT_WINDOW) > IMU_DRIFT_THRESHOLD;
+    }
+
+    Serial.printf("[IMU] drift check: %ld %ld %ld\n",
+                  (long)(m_drift_sum[0] / IMU_DRIFT_WINDOW),
+                  (long)(m_drift_sum[1] / IMU_DRIFT_WINDOW),
+                  (long)(m_drift_sum[2] / IMU_DRIFT_WINDOW));
+    // 静止且零漂超限时 由采样任务在本批样本处理完后重新校准
+    m_drift_state = drift ? DRIFT_RECALIBRATE : DRIFT_IDLE;
+}
+
+void IMU::readMean(int32_t mean[6])
+{
+    memset(mean, 0, 6 * sizeof(int32_t));
+    for (int num = 0; num < IMU_CALIB_SAMPLES; ++num)
+    {
+        int16_t raw[6];
+        g_i2cBus.lock(MPU6050_DEFAULT_ADDRESS);
+        mpu.getMotion6(&raw[0], &raw[1], &raw[2], &raw[3], &raw[4], &raw[5]);
+        g_i2cBus.unlock();
+        for (int axis = 0; axis < 6; ++axis)
         {
-            // 震动检测
-            tmp_info.active = ACTIVE_TYPE::SHAKE;
+            mean[axis] += raw[axis];
         }
+        // 等待下一个采样
+        vTaskDelay(IMU_SAMPLE_PERIOD / portTICK_PERIOD_MS);
     }
+    for (int axis = 0; axis < 6; ++axis)
+    {
+        mean[axis] /= IMU_CALIB_SAMPLES;
+    }
+}
 
-    // 储存当前检测的动作数据到动作缓冲区中
-    act_info_history_ind = (act_info_history_ind + 1) % ACTION_HISTORY_BUF_LEN;
-    int index = act_info_history_ind;
-    act_info_history[index] = tmp_info.active;
+void IMU::recalibrate(void)
+{
+    Serial.print(F("[IMU] recalibrating...\n"));
+    // 代替库中的CalibrateAccel/CalibrateGyro（整个过程需要独占总线数秒）
+    // 按均值逐次修正偏移寄存器 每次访问寄存器时才占用总线
+    int16_t offsets[6];
+    g_i2cBus.lock(MPU6050_DEFAULT_ADDRESS);
+    // 校准期间直接读取寄存器 暂停FIFO
+    mpu.setFIFOEnabled(false);
+    offsets[0] = mpu.getXAccelOffset();
+    offsets[1] = mpu.getYAccelOffset();
+    offsets[2] = mpu.getZAccelOffset();
+    offsets[3] = mpu.getXGyroOffset();
+    offsets[4] = mpu.getYGyroOffset();
+    offsets[5] = mpu.getZGyroOffset();
+    int32_t gravity = 16384 >> mpu.getFullScaleAccelRange();
+    g_i2cBus.unlock();
 
-    // 本次流程的动作识别
-    if (!action_info.isValid)
+    for (int round = 0; round < IMU_CALIB_ROUNDS; ++round)
     {
-        bool isHoldDown = false; // 长按的标志位
-        // 本次流程的动作识别
-        int second = (index + ACTION_HISTORY_BUF_LEN - 1) % ACTION_HISTORY_BUF_LEN;
-        int third = (index + ACTION_HISTORY_BUF_LEN - 2) % ACTION_HISTORY_BUF_LEN;
-        // 先识别"短按" （注：不要写成else if）
-        if (ACTIVE_TYPE::UNKNOWN != tmp_info.active)
+        int32_t mean[6];
+        readMean(mean);
+        mean[2] -= gravity; // 静止时Z轴为1g
+
+        bool done = true;
+        for (int axis = 0; axis < 6; ++axis)
         {
-            action_info.isValid = 1;
-            action_info.active = tmp_info.active;
+            done &= abs(mean[axis]) <= (axis < 3 ? IMU_CALIB_ACCEL_TOLERANCE : IMU_CALIB_GYRO_TOLERANCE);
         }
-        // 识别"长按","长按"相对"短按"高级（所以键值升级放在短按之后）
-        if (act_info_history[index] == act_info_history[second] && act_info_history[second] == act_info_history[third])
+        if (done)
         {
-            // 目前只识别前后的长按
-            if (ACTIVE_TYPE::UP == tmp_info.active)
-            {
-                isHoldDown = true;
-                action_info.isValid = 1;
-                action_info.active = ACTIVE_TYPE::GO_FORWORD;
-            }
-            else if (ACTIVE_TYPE::DOWN == tmp_info.active)
-            {
-                isHoldDown = true;
-                action_info.isValid = 1;
-                action_info.active = ACTIVE_TYPE::RETURN;
-            }
-            // 如需左右的长按可在此处添加"else if"的逻辑
+            break;
+        }
 
-            if (isHoldDown)
-            {
-                // 本次识别为长按，则手动清除识别过的历史数据 避免对下次动作识别的影响
-                act_info_history[second] = ACTIVE_TYPE::UNKNOWN;
-                act_info_history[third] = ACTIVE_TYPE::UNKNOWN;
-            }
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            // 加速度偏移寄存器的1位约为8个原始值 最低位保留不能修改
+            int16_t value = offsets[axis] - mean[axis] / 8;
+            offsets[axis] = (value & ~1) | (offsets[axis] & 1);
         }
+        for (int axis = 3; axis < 6; ++axis)
+        {
+            // 陀螺仪偏移寄存器的1位为4个原始值（±250°/s量程）
+            offsets[axis] -= mean[axis] / 4;
+        }
+        g_i2cBus.lock(MPU6050_DEFAULT_ADDRESS);
+        mpu.setXAccelOffset(offsets[0]);
+        mpu.setYAccelOffset(offsets[1]);
+        mpu.setZAccelOffset(offsets[2]);
+        mpu.setXGyroOffset(offsets[3]);
+        mpu.setYGyroOffset(offsets[4]);
+        mpu.setZGyroOffset(offsets[5]);
+        g_i2cBus.unlock();
+    }
+    Serial.printf("[IMU] offsets: %d %d %d %d %d %d\n", offsets[0], offsets[1], offsets[2],
+                  offsets[3], offsets[4], offsets[5]);
+
+    m_new_offsets.x_accel_offset = offsets[0];
+    m_new_offsets.y_accel_offset = offsets[1];
+    m_new_offsets.z_accel_offset = offsets[2];
+    m_new_offsets.x_gyro_offset = offsets[3];
+    m_new_offsets.y_gyro_offset = offsets[4];
+    m_new_offsets.z_gyro_offset = offsets[5];
+    m_offsets_valid = true;
+    m_offsets_ready = true;
+
+    // 校准期间FIFO中的数据已经无效 清空后重新开始 下次读取时会重新获取数量
+    g_i2cBus.lock(MPU6050_DEFAULT_ADDRESS);
+    mpu.resetFIFO();
+    mpu.setFIFOEnabled(true);
+    g_i2cBus.unlock();
+}
+
+bool IMU::getNewOffsets(SysMpuConfig *mpu_cfg)
+{
+    if (!m_offsets_ready)
+    {
+        return false;
+    }
+    *mpu_cfg = m_new_offsets;
+    m_offsets_ready = false;
+    return true;
+}
+
+void IMU::onGesture(ACTIVE_TYPE active, bool long_time, void *user_data)
+{
+    IMU *imu = (IMU *)user_data;
+    if (imu->m_trace)
+    {
+        // 格式: IMU_EVT,时间,动作,是否长按
+        Serial.printf("IMU_EVT,%lu,%s,%d\n", imu->m_engine->getTime(),
+                      active_type_info[active], long_time);
+    }
+
+    ImuAction event = *imu->m_engine->getFiltered();
+    event.active = active;
+    event.isValid = true;
+    event.long_time = long_time;
+    if (pdTRUE != xQueueSend(imu->m_event_queue, &event, 0))
+    {
+        // 队列已满 丢弃最早的动作
+        ImuAction drop;
+        xQueueReceive(imu->m_event_queue, &drop, 0);
+        xQueueSend(imu->m_event_queue, &event, 0);
+    }
+    loop_wake(); // 主循环取出动作
+}
+
+void IMU::setGestureConfig(const GestureConfig *cfg)
+{
+    // 由采样任务在下一个样本前应用 避免与识别过程冲突
+    m_new_cfg = cfg;
+}
+
+void IMU::setTrace(bool enable)
+{
+    m_trace = enable;
+}
+
+ImuAction *IMU::getAction(void)
+{
+    // 动作由采样任务识别 这里只取出结果 不再访问I2C
+    ImuAction event;
+    if (!action_info.isValid && NULL != m_event_queue &&
+        pdTRUE == xQueueReceive(m_event_queue, &event, 0))
+    {
+        action_info.active = event.active;
+        action_info.long_time = event.long_time;
+        action_info.isValid = true;
+    }
+    if (NULL != m_engine)
+    {
+        const ImuAction *filtered = m_engine->getFiltered();
+        action_info.v_ax = filtered->v_ax;
+        action_info.v_ay = filtered->v_ay;
+        action_info.v_az = filtered->v_az;
+        action_info.v_gx = filtered->v_gx;
+        action_info.v_gy = filtered->v_gy;
+        action_info.v_gz = filtered->v_gz;
     }
 
     return &action_info;
@@ -182,10 +422,16 @@ ImuAction *IMU::getAction(void)
 
 void IMU::getVirtureMotion6(ImuAction *action_info)
 {
+    g_i2cBus.lock(MPU6050_DEFAULT_ADDRESS);
     mpu.getMotion6(&(action_info->v_ax), &(action_info->v_ay),
                    &(action_info->v_az), &(action_info->v_gx),
                    &(action_info->v_gy), &(action_info->v_gz));
+    g_i2cBus.unlock();
+    applyOrder(action_info);
+}
 
+void IMU::applyOrder(ImuAction *action_info)
+{
     if (order & X_DIR_TYPE)
     {
         action_info->v_ax = -action_info->v_ax;
@@ -4,26 +4,31 @@
 #include <I2Cdev.h>
 #include <MPU6050.h>
 #include "lv_port_indev.h"
+#include "imu_types.h"
 #include <list>
-#define ACTION_HISTORY_BUF_LEN 5
+
+#define IMU_SAMPLE_RATE 100     // FIFO的采样率 Hz
+#define IMU_SAMPLE_PERIOD (1000 / IMU_SAMPLE_RATE)
+#define IMU_INT_PIN -1          // MPU6050的INT引脚（-1表示未连接 定时读取FIFO）
+#define IMU_POLL_PERIOD 20      // 读取FIFO的最长间隔 ms
+#define IMU_FIFO_BATCH 10       // 单次I2C读取的最大样本数
+#define IMU_EVENT_QUEUE_LEN 8   // 已识别动作的队列长度
+
+// 陀螺仪零漂检查（开机后在后台进行 代替每次开机都阻塞校准）
+#define IMU_DRIFT_CHECK_DELAY 3000 // 开机后多久开始检查 ms
+#define IMU_DRIFT_WINDOW 100       // 每次检查的样本数
+#define IMU_DRIFT_STILL_RANGE 200  // 窗口内角速度的波动小于此值视为静止
+#define IMU_DRIFT_THRESHOLD 40     // 静止时角速度的均值超过此值则重新校准
+#define IMU_CALIB_ROUNDS 6         // 重新校准时最多调整偏移的次数
+#define IMU_CALIB_SAMPLES 50       // 每次调整前取均值的样本数
+#define IMU_CALIB_ACCEL_TOLERANCE 24 // 加速度均值的误差小于此值即完成校准
+#define IMU_CALIB_GYRO_TOLERANCE 4   // 角速度均值的误差小于此值即完成校准
 
 extern int32_t encoder_diff;
 extern lv_indev_state_t encoder_state;
 
 extern const char *active_type_info[];
 
-enum ACTIVE_TYPE
-{
-    TURN_RIGHT = 0,
-    RETURN,
-    TURN_LEFT,
-    UP,
-    DOWN,
-    GO_FORWORD,
-    SHAKE,
-    UNKNOWN
-};
-
 // 方向类型
 enum MPU_DIR_TYPE
 {
@@ -45,41 +50,62 @@ struct SysMpuConfig
     int16_t z_accel_offset;
 };
 
-struct ImuAction
-{
-    volatile ACTIVE_TYPE active;
-    boolean isValid;
-    boolean long_time;
-    int16_t v_ax; // v表示虚拟参数（用于调整6050的初始方位）
-    int16_t v_ay;
-    int16_t v_az;
-    int16_t v_gx;
-    int16_t v_gy;
-    int16_t v_gz;
-};
+class GestureEngine;
+struct GestureConfig;
 
 class IMU
 {
 private:
     MPU6050 mpu;
-    int flag;
-    long last_update_time;
     uint8_t order; // 表示方位，x与y是否对换
 
+    TaskHandle_t m_task;          // 采样任务
+    QueueHandle_t m_event_queue;  // 识别出的动作
+    GestureEngine *m_engine;      // 动作识别（只在采样任务中调用）
+    const GestureConfig *m_new_cfg; // 等待采样任务应用的新阈值
+    bool m_trace;                 // 是否从串口输出原始样本
+
+    // 零漂检查
+    enum DRIFT_STATE
+    {
+        DRIFT_IDLE = 0, // 不检查
+        DRIFT_WAIT,     // 等待开始
+        DRIFT_CHECK,    // 等待静止并统计
+        DRIFT_RECALIBRATE
+    };
+    volatile DRIFT_STATE m_drift_state;
+    bool m_offsets_valid;         // 当前使用的是否为有效的校准值
+    uint32_t m_sample_count;
+    uint16_t m_drift_num;
+    int32_t m_drift_sum[3];
+    int16_t m_drift_min[3];
+    int16_t m_drift_max[3];
+    SysMpuConfig m_new_offsets;   // 后台校准得到的新值
+    volatile bool m_offsets_ready;
+
+    static void sampleTask(void *parameter);
+    void checkDrift(const ImuAction *raw);
+    void recalibrate(void);
+    void readMean(int32_t mean[6]);
+    static void onGesture(ACTIVE_TYPE active, bool long_time, void *user_data);
+    void readFifo(void);
+    void processSample(ImuAction *sample);
+    void applyOrder(ImuAction *action_info);
+
 public:
     ImuAction action_info;
-    // 用来储存历史动作
-    // std::list<ACTIVE_TYPE> act_info_history;
-    ACTIVE_TYPE act_info_history[ACTION_HISTORY_BUF_LEN];
-    int act_info_history_ind; // 标志储存的位置
 
 public:
     IMU();
     void init(uint8_t order, uint8_t auto_calibration,
               SysMpuConfig *mpu_cfg);
     void setOrder(uint8_t order); // 设置方向
+    void setGestureConfig(const GestureConfig *cfg); // 设置动作识别的阈值（cfg需要一直有效）
+    void setTrace(bool enable);   // 开关原始样本的串口输出（用于离线调试阈值）
+    // 后台重新校准完成后 取出新的校准值（用于保存） 没有新值时返回false
+    bool getNewOffsets(SysMpuConfig *mpu_cfg);
     bool Encoder_GetIsPush(void); // 适配Peak的编码器中键 开关机使用
-    ImuAction *getAction(void); // 获取动作
+    ImuAction *getAction(void); // 获取动作（不阻塞 只取出队列中已识别的动作）
     void getVirtureMotion6(ImuAction *action_info);
 };
 
@@ -0,0 +1,32 @@
+#ifndef IMU_TYPES_H
+#define IMU_TYPES_H
+
+// 动作识别用到的类型 不依赖Arduino与传感器驱动 方便在电脑上回放样本测试
+#include <stdint.h>
+
+enum ACTIVE_TYPE
+{
+    TURN_RIGHT = 0,
+    RETURN,
+    TURN_LEFT,
+    UP,
+    DOWN,
+    GO_FORWORD,
+    SHAKE,
+    UNKNOWN
+};
+
+struct ImuAction
+{
+    volatile ACTIVE_TYPE active;
+    bool isValid;
+    bool long_time;
+    int16_t v_ax; // v表示虚拟参数（用于调整6050的初始方位）
+    int16_t v_ay;
+    int16_t v_az;
+    int16_t v_gx;
+    int16_t v_gy;
+    int16_t v_gz;
+};
+
+#endif
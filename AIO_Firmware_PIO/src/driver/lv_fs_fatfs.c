@@ -15,7 +15,12 @@
  *      DEFINES
  *********************/
 #define LV_FS_FATFS_LETTER 'S'
-#define LV_FS_FATFS_CACHE_SIZE 0
+/* LVGL为每个打开的文件分配的读缓存（lv_fs_read中使用），0为关闭。
+ * LV_IMG_CACHE_DEF_SIZE为0时，.bin图片每次绘制都会按行读取，缓存后可大幅减少SD卡访问
+ * 可在编译选项中覆盖（LVGL中为uint16_t 不能超过65535） 设为0后对比lvfs统计即可看出缓存的效果 */
+#ifndef LV_FS_FATFS_CACHE_SIZE
+    #define LV_FS_FATFS_CACHE_SIZE (4 * 1024)
+#endif
 
 #if LV_FS_FATFS_LETTER == '\0'
     #error "LV_FS_FATFS_LETTER must be an upper case ASCII letter"
@@ -43,6 +48,7 @@ static lv_fs_res_t fs_dir_close(lv_fs_drv_t * drv, void * dir_p);
 /**********************
  *  STATIC VARIABLES
  **********************/
+static lv_fs_fatfs_stats_t fs_stats;
 
 /**********************
  *      MACROS
@@ -85,6 +91,16 @@ void lv_fs_fatfs_init(void)
     lv_fs_drv_register(&fs_drv);
 }
 
+void lv_fs_fatfs_get_stats(lv_fs_fatfs_stats_t * stats)
+{
+    *stats = fs_stats;
+}
+
+void lv_fs_fatfs_reset_stats(void)
+{
+    lv_memset_00(&fs_stats, sizeof(fs_stats));
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -116,6 +132,7 @@ static void * fs_open(lv_fs_drv_t * drv, const char * path, lv_fs_mode_t mode)
     if(f == NULL) return NULL;
 
     FRESULT res = f_open(f, path, flags);
+    fs_stats.open_calls++;
     if(res == FR_OK) {
         return f;
     }
@@ -154,6 +171,9 @@ static lv_fs_res_t fs_read(lv_fs_drv_t * drv, void * file_p, void * buf, uint32_
 {
     LV_UNUSED(drv);
     FRESULT res = f_read(file_p, buf, btr, (UINT *)br);
+    /*LVGL的缓存命中时不会调用到这里 统计的是实际读卡的次数*/
+    fs_stats.read_calls++;
+    fs_stats.read_bytes += *br;
     if(res == FR_OK) return LV_FS_RES_OK;
     else return LV_FS_RES_UNKNOWN;
 }
@@ -187,6 +207,7 @@ static lv_fs_res_t fs_write(lv_fs_drv_t * drv, void * file_p, const void * buf,
 static lv_fs_res_t fs_seek(lv_fs_drv_t * drv, void * file_p, uint32_t pos, lv_fs_whence_t whence)
 {
     LV_UNUSED(drv);
+    fs_stats.seek_calls++;
     switch(whence) {
         case LV_FS_SEEK_SET:
             f_lseek(file_p, pos);
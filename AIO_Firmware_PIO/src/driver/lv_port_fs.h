@@ -26,12 +26,23 @@ extern "C" {
 /**********************
  *      TYPEDEFS
  **********************/
+/*FatFS驱动的读取统计（LVGL缓存未命中 实际从SD卡读取的部分）*/
+typedef struct {
+    uint32_t open_calls; /*打开文件的次数*/
+    uint32_t read_calls; /*调用f_read的次数*/
+    uint32_t read_bytes; /*从SD卡读取的字节数*/
+    uint32_t seek_calls; /*调用f_lseek的次数*/
+} lv_fs_fatfs_stats_t;
 
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
 void lv_fs_fatfs_init(void);
 
+void lv_fs_fatfs_get_stats(lv_fs_fatfs_stats_t * stats);
+
+void lv_fs_fatfs_reset_stats(void);
+
 /**********************
  *      MACROS
  **********************/
@@ -2,10 +2,65 @@
 #include "common.h"
 #include <Arduino.h>
 
+static uint8_t gamma_lut[256]; // 颜色的gamma校正表
+
 void Pixel::init()
 {
-    FastLED.addLeds<WS2812, RGB_LED_PIN, GRB>(rgb_buffers, RGB_LED_NUM);
-    FastLED.setBrightness(200);
+    for (int value = 0; value < 256; ++value)
+    {
+        gamma_lut[value] = (uint8_t)(powf(value / 255.0f, RGB_GAMMA) * 255.0f + 0.5f);
+    }
+    updateScale(200);
+
+    FastLED.addLeds<WS2812, RGB_LED_PIN, GRB>(out_buffers, RGB_LED_NUM);
+    // 亮度由scale_lut换算 关闭抖动后相同的颜色不需要重复刷新
+    FastLED.setBrightness(255);
+    FastLED.setDither(DISABLE_DITHER);
+}
+
+void Pixel::updateScale(uint8_t value)
+{
+    brightness = value;
+    for (int pos = 0; pos < 256; ++pos)
+    {
+        scale_lut[pos] = ((uint16_t)gamma_lut[pos] * (value + 1)) >> 8;
+    }
+}
+
+void Pixel::refresh()
+{
+    bool dirty = false;
+    for (int pos = 0; pos < RGB_LED_NUM; ++pos)
+    {
+        CRGB out(scale_lut[rgb_buffers[pos].r],
+                 scale_lut[rgb_buffers[pos].g],
+                 scale_lut[rgb_buffers[pos].b]);
+        if (out != out_buffers[pos])
+        {
+            out_buffers[pos] = out;
+            dirty = true;
+        }
+    }
+
+    if (dirty)
+    {
+        FastLED.show();
+    }
+}
+
+Pixel &Pixel::setColor(const CRGB &color, uint8_t value)
+{
+    for (int pos = 0; pos < RGB_LED_NUM; ++pos)
+    {
+        rgb_buffers[pos] = color;
+    }
+    if (value != brightness)
+    {
+        updateScale(value);
+    }
+    refresh();
+
+    return *this;
 }
 
 Pixel &Pixel::setRGB(int r, int g, int b)
@@ -14,7 +69,7 @@ Pixel &Pixel::setRGB(int r, int g, int b)
     {
         rgb_buffers[pos] = CRGB(r, g, b);
     }
-    FastLED.show();
+    refresh();
 
     return *this;
 }
@@ -25,7 +80,7 @@ Pixel &Pixel::setHVS(uint8_t ih, uint8_t is, uint8_t iv)
     {
         rgb_buffers[pos].setHSV(ih, is, iv);
     }
-    FastLED.show();
+    refresh();
 
     return *this;
 }
@@ -34,8 +89,8 @@ Pixel &Pixel::fill_rainbow(int min_r, int max_r,
                            int min_g, int max_g,
                            int min_b, int max_b)
 {
-    fill_gradient(rgb_buffers, 0, CHSV(50, 255, 255), 29, CHSV(150, 255, 255), SHORTEST_HUES);
-    FastLED.show();
+    fill_gradient(rgb_buffers, 0, CHSV(50, 255, 255), RGB_LED_NUM - 1, CHSV(150, 255, 255), SHORTEST_HUES);
+    refresh();
 
     return *this;
 }
@@ -43,8 +98,12 @@ Pixel &Pixel::fill_rainbow(int min_r, int max_r,
 Pixel &Pixel::setBrightness(float duty)
 {
     duty = constrain(duty, 0, 1);
-    FastLED.setBrightness((uint8_t)(255 * duty));
-    FastLED.show();
+    uint8_t value = (uint8_t)(255 * duty);
+    if (value != brightness)
+    {
+        updateScale(value);
+        refresh();
+    }
 
     return *this;
 }
@@ -56,14 +115,58 @@ BaseType_t taskRgbReturned;
 TaskHandle_t handleLed = NULL;
 TimerHandle_t xTimer_rgb = NULL;
 
+// 当前运行的关键帧效果 为NULL时按g_rgb渐变
+// 正在运行的效果（g_rgb rgb_status kf_*）只在LED任务（或定时器回调）中修改
+static const RgbKeyframe *kf_frames = NULL;
+static uint8_t kf_num = 0;
+static bool kf_loop = false;
+static unsigned long kf_start = 0;
+
+// 待切换的效果 调用者在临界区内整体写入 LED任务在下一次变化前取走
+struct RgbPending
+{
+    bool valid;
+    RgbParam param;            // 参数渐变（frames为NULL时使用）
+    const RgbKeyframe *frames; // 关键帧
+    uint8_t frame_num;
+    bool loop;
+};
+static RgbPending rgb_pending;
+static portMUX_TYPE rgb_mux = portMUX_INITIALIZER_UNLOCKED;
+
+struct RgbEffect
+{
+    char name[RGB_EFFECT_NAME_LEN];
+    RgbParam param;            // 参数渐变（frames为NULL时使用）
+    const RgbKeyframe *frames; // 关键帧
+    uint8_t frame_num;
+    bool loop;
+};
+
+static const RgbKeyframe off_frames[] = {{0, 0, 0, 0, 0}};
+static RgbEffect effect_list[RGB_EFFECT_MAX] = {
+    {RGB_EFFECT_OFF, {}, off_frames, 1, false}};
+static uint8_t effect_num = 1;
+
 void led_timerHandler(TimerHandle_t xTimer);
 void led_taskHandler(void *parameter);
 static void hsvModeChange(void);
 static void rgbModeChange(void);
-static void onceChange(void);
+static uint32_t keyframeChange(void);
+static uint32_t onceChange(void);
 static void count_cur_brightness(void);
+static bool publish_effect(const RgbParam *param, const RgbKeyframe *frames,
+                           uint8_t frame_num, bool loop, LED_RUN_MODE mode);
+static void take_pending(void);
+static bool start_run(LED_RUN_MODE mode, uint32_t period);
 
 bool set_rgb_and_run(RgbParam *rgb_setting, LED_RUN_MODE mode)
+{
+    return publish_effect(rgb_setting, NULL, 0, false, mode);
+}
+
+static bool publish_effect(const RgbParam *param, const RgbKeyframe *frames,
+                           uint8_t frame_num, bool loop, LED_RUN_MODE mode)
 {
     if (RUN_MODE_NONE <= mode)
     {
@@ -71,15 +174,44 @@ bool set_rgb_and_run(RgbParam *rgb_setting, LED_RUN_MODE mode)
         return false;
     }
 
-    if (run_mode != mode)
+    // 效果整体交给LED任务 避免它读到一半的kf_frames与kf_num
+    portENTER_CRITICAL(&rgb_mux);
+    if (NULL != param)
     {
-        // 运行模式发生变化
-        rgb_stop();
-        run_mode = mode;
+        rgb_pending.param = *param;
     }
+    rgb_pending.frames = frames;
+    rgb_pending.frame_num = frame_num;
+    rgb_pending.loop = loop;
+    rgb_pending.valid = true;
+    portEXIT_CRITICAL(&rgb_mux);
 
-    g_rgb = *rgb_setting;
+    return start_run(mode, NULL == frames ? param->time : RGB_KEYFRAME_PERIOD);
+}
 
+// 在LED任务（或定时器回调）中取走待切换的效果
+static void take_pending(void)
+{
+    RgbPending pending;
+    portENTER_CRITICAL(&rgb_mux);
+    pending = rgb_pending;
+    rgb_pending.valid = false;
+    portEXIT_CRITICAL(&rgb_mux);
+    if (!pending.valid)
+    {
+        return;
+    }
+
+    kf_frames = pending.frames;
+    kf_num = pending.frame_num;
+    kf_loop = pending.loop;
+    kf_start = GET_SYS_MILLIS();
+    if (NULL != kf_frames)
+    {
+        return;
+    }
+
+    g_rgb = pending.param;
     // 拷贝数据
     if (LED_MODE_RGB == g_rgb.mode)
     {
@@ -97,6 +229,16 @@ bool set_rgb_and_run(RgbParam *rgb_setting, LED_RUN_MODE mode)
         rgb_status.current_brightness = g_rgb.min_brightness;
         rgb_status.pos = 0;
     }
+}
+
+static bool start_run(LED_RUN_MODE mode, uint32_t period)
+{
+    if (run_mode != mode)
+    {
+        // 运行模式发生变化
+        rgb_stop();
+        run_mode = mode;
+    }
 
     // 选择启动两种运行模式
     if (RUN_MODE_TIMER == run_mode)
@@ -107,7 +249,7 @@ bool set_rgb_and_run(RgbParam *rgb_setting, LED_RUN_MODE mode)
             xTimer_rgb = NULL;
         }
         xTimer_rgb = xTimerCreate("led_timerHandler",
-                                  g_rgb.time / portTICK_PERIOD_MS,
+                                  period / portTICK_PERIOD_MS,
                                   pdTRUE, (void *)0, led_timerHandler);
         xTimerStart(xTimer_rgb, 0); // 开启定时器
     }
@@ -119,18 +261,93 @@ bool set_rgb_and_run(RgbParam *rgb_setting, LED_RUN_MODE mode)
                 led_taskHandler,
                 "led_taskHandler",
                 8 * 128, // 实际上 7*128就够用
-                (void *)&g_rgb.time,
+                NULL,
                 TASK_RGB_PRIORITY,
                 &handleLed);
             if (taskRgbReturned != pdPASS)
             {
                 return false;
             }
+            METRIC_WATCH_TASK("RgbLed", handleLed);
+        }
+        else
+        {
+            // 唤醒任务 立即切换到新的效果
+            xTaskNotifyGive(handleLed);
         }
     }
     return true;
 }
 
+bool rgb_effect_register(const char *name, const RgbParam *param)
+{
+    RgbEffect *effect = NULL;
+    for (uint8_t pos = 0; pos < effect_num && NULL == effect; ++pos)
+    {
+        if (!strcmp(effect_list[pos].name, name))
+        {
+            effect = &effect_list[pos];
+        }
+    }
+    if (NULL == effect)
+    {
+        if (effect_num >= RGB_EFFECT_MAX)
+        {
+            return false;
+        }
+        effect = &effect_list[effect_num++];
+        snprintf(effect->name, RGB_EFFECT_NAME_LEN, "%s", name);
+    }
+
+    if (NULL != param)
+    {
+        effect->param = *param;
+    }
+    effect->frames = NULL;
+    effect->frame_num = 0;
+    effect->loop = false;
+    return true;
+}
+
+bool rgb_effect_register(const char *name, const RgbKeyframe *frames,
+                         uint8_t frame_num, bool loop)
+{
+    if (NULL == frames || 0 == frame_num || !rgb_effect_register(name, NULL))
+    {
+        return false;
+    }
+    for (uint8_t pos = 0; pos < effect_num; ++pos)
+    {
+        if (!strcmp(effect_list[pos].name, name))
+        {
+            effect_list[pos].frames = frames;
+            effect_list[pos].frame_num = frame_num;
+            effect_list[pos].loop = loop;
+        }
+    }
+    return true;
+}
+
+bool rgb_effect_run(const char *name, LED_RUN_MODE mode)
+{
+    if (RUN_MODE_NONE <= mode)
+    {
+        return false;
+    }
+    for (uint8_t pos = 0; pos < effect_num; ++pos)
+    {
+        RgbEffect *effect = &effect_list[pos];
+        if (strcmp(effect->name, name))
+        {
+            continue;
+        }
+        return publish_effect(&effect->param, effect->frames,
+                              effect->frame_num, effect->loop, mode);
+    }
+    Serial.printf("[RGB] unknown effect %s\n", name);
+    return false;
+}
+
 void led_timerHandler(TimerHandle_t xTimer)
 {
     onceChange();
@@ -138,11 +355,11 @@ void led_timerHandler(TimerHandle_t xTimer)
 
 void led_taskHandler(void *parameter)
 {
-    int *ms = (int *)parameter; // 控制时间
     for (;;)
     {
-        onceChange();
-        vTaskDelay(*ms);
+        uint32_t ms = onceChange(); // 控制时间
+        // 效果切换时由start_run()提前唤醒
+        ulTaskNotifyTake(pdTRUE, ms);
 
         // if (pdTRUE == xSemaphoreTake(lvgl_mutex, portMAX_DELAY))
         // {
@@ -152,8 +369,15 @@ void led_taskHandler(void *parameter)
     }
 }
 
-static void onceChange(void)
+// 返回距离下一次变化的时间
+static uint32_t onceChange(void)
 {
+    take_pending();
+    if (NULL != kf_frames)
+    {
+        return keyframeChange();
+    }
+
     if (LED_MODE_RGB == g_rgb.mode)
     {
         rgbModeChange();
@@ -162,6 +386,54 @@ static void onceChange(void)
     {
         hsvModeChange();
     }
+    return g_rgb.time;
+}
+
+static void setFrame(const RgbKeyframe *from, const RgbKeyframe *to, uint8_t frac)
+{
+    // frac为0~255 表示从from到to的进度
+    CRGB color(lerp8by8(from->r, to->r, frac),
+               lerp8by8(from->g, to->g, frac),
+               lerp8by8(from->b, to->b, frac));
+    rgb.setColor(color, lerp8by8(from->brightness, to->brightness, frac));
+}
+
+static uint32_t keyframeChange(void)
+{
+    const RgbKeyframe *last = &kf_frames[kf_num - 1];
+    uint32_t cycle = 0;
+    for (uint8_t pos = 1; pos < kf_num; ++pos)
+    {
+        cycle += kf_frames[pos].time;
+    }
+    if (kf_loop)
+    {
+        cycle += kf_frames[0].time;
+    }
+
+    uint32_t elapsed = GET_SYS_MILLIS() - kf_start;
+    if (0 == cycle || (!kf_loop && elapsed >= cycle))
+    {
+        // 静态效果或已经播放完 保持最后一帧直到切换效果
+        setFrame(last, last, 0);
+        return portMAX_DELAY;
+    }
+    if (kf_loop)
+    {
+        elapsed %= cycle;
+    }
+
+    for (uint8_t pos = 1; pos <= kf_num; ++pos)
+    {
+        const RgbKeyframe *to = &kf_frames[pos % kf_num];
+        if (elapsed < to->time)
+        {
+            setFrame(&kf_frames[pos - 1], to, elapsed * 256 / to->time);
+            break;
+        }
+        elapsed -= to->time;
+    }
+    return RGB_KEYFRAME_PERIOD;
 }
 
 static void hsvModeChange(void)
@@ -206,11 +478,11 @@ static void hsvModeChange(void)
     // 计算当前背光值
     count_cur_brightness();
 
-    // 设置HSV状态
-    rgb.setHVS(rgb_status.current_h,
-               rgb_status.current_s,
-               rgb_status.current_v)
-        .setBrightness(rgb_status.current_brightness / 1000.0f);
+    // 设置HSV状态（颜色与亮度一起更新 只刷新一次）
+    rgb.setColor(CHSV(rgb_status.current_h,
+                      rgb_status.current_s,
+                      rgb_status.current_v),
+                 min(rgb_status.current_brightness, (uint16_t)1000) * 255 / 1000);
 }
 
 static void rgbModeChange(void)
@@ -262,11 +534,11 @@ static void rgbModeChange(void)
     // 计算当前背光值
     count_cur_brightness();
 
-    // 设置RGB状态
-    rgb.setRGB(rgb_status.current_r,
-               rgb_status.current_g,
-               rgb_status.current_b)
-        .setBrightness(rgb_status.current_brightness / 1000.0f);
+    // 设置RGB状态（颜色与亮度一起更新 只刷新一次）
+    rgb.setColor(CRGB(rgb_status.current_r,
+                      rgb_status.current_g,
+                      rgb_status.current_b),
+                 min(rgb_status.current_brightness, (uint16_t)1000) * 255 / 1000);
 }
 
 static void count_cur_brightness(void)
@@ -303,6 +575,7 @@ void rgb_stop(void)
     if (RUN_MODE_TASK == run_mode &&
         NULL != handleLed)
     {
+        METRIC_UNWATCH_TASK(handleLed);
         vTaskDelete(handleLed);
         handleLed = NULL;
     }
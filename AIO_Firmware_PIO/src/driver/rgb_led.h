@@ -5,6 +5,13 @@
 #include <esp32-hal-timer.h>
 
 #define RGB_LED_NUM 2
+#define RGB_GAMMA 2.2f          // 颜色的gamma校正系数
+#define RGB_KEYFRAME_PERIOD 20  // 关键帧效果的刷新间隔 ms
+#define RGB_EFFECT_MAX 8        // 最多可注册的效果数
+#define RGB_EFFECT_NAME_LEN 16  // 效果名字的最大长度
+
+#define RGB_EFFECT_SYSTEM "system" // 系统设置中的灯效（APP退出后恢复）
+#define RGB_EFFECT_OFF "off"       // 关闭
 
 #define LED_MODE_RGB 0
 #define LED_MODE_HSV 1
@@ -19,11 +26,20 @@ enum LED_RUN_MODE : unsigned char
 class Pixel
 {
 private:
-    CRGB rgb_buffers[RGB_LED_NUM];
+    CRGB rgb_buffers[RGB_LED_NUM]; // 设置的颜色
+    CRGB out_buffers[RGB_LED_NUM]; // 经过gamma与亮度换算后实际输出的颜色
+    uint8_t brightness;
+    uint8_t scale_lut[256];        // 当前亮度下 颜色值到输出值的映射
+
+    void updateScale(uint8_t value);
+    void refresh(); // 输出有变化时才刷新WS2812（刷新期间会关闭中断）
 
 public:
     void init();
 
+    // 同时设置颜色与亮度（0~255） 只刷新一次
+    Pixel &setColor(const CRGB &color, uint8_t value);
+
     Pixel &setRGB(int r, int g, int b);
 
     Pixel &setHVS(uint8_t ih, uint8_t is, uint8_t iv);
@@ -140,8 +156,25 @@ struct RgbRunStatus
     uint16_t current_brightness; // 亮度值 0~1000
 };
 
+// 关键帧 相邻帧之间按时间线性插值
+struct RgbKeyframe
+{
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    uint8_t brightness; // 0~255
+    uint16_t time;      // 从上一帧过渡到本帧的时间 ms（循环时第一帧为从最后一帧回到第一帧的时间）
+};
+
 bool set_rgb_and_run(RgbParam *rgb_setting,
                      LED_RUN_MODE mode = RUN_MODE_TASK);
 void rgb_stop(void);
 
+// 注册有名字的灯效 同名时覆盖（frames需要一直有效）
+bool rgb_effect_register(const char *name, const RgbParam *param);
+bool rgb_effect_register(const char *name, const RgbKeyframe *frames,
+                         uint8_t frame_num, bool loop);
+// 运行已注册的灯效
+bool rgb_effect_run(const char *name, LED_RUN_MODE mode = RUN_MODE_TASK);
+
 #endif
@@ -13,6 +13,19 @@ const char *HOST_NAME = "HoloCubic";   // 主机名
 
 uint16_t ap_timeout = 0; // ap无连接的超时时间
 
+#if METRICS_ENABLE
+static unsigned long wifi_conn_start = 0; // 发起连接的时间 0表示没有在等待连接
+
+static void wifi_got_ip(WiFiEvent_t event, WiFiEventInfo_t info)
+{
+    if (0 != wifi_conn_start)
+    {
+        METRIC_OBSERVE(METRIC_WIFI_CONNECT_MS, GET_SYS_MILLIS() - wifi_conn_start);
+        wifi_conn_start = 0;
+    }
+}
+#endif
+
 TimerHandle_t xTimer_ap;
 
 Network::Network()
@@ -69,6 +82,15 @@ boolean Network::start_conn_wifi(const char *ssid, const char *password)
     // esp_wifi_set_ps(WIFI_PS_NONE);
     // 修改主机名
     WiFi.setHostname(HOST_NAME);
+#if METRICS_ENABLE
+    static bool event_registered = false;
+    if (!event_registered)
+    {
+        WiFi.onEvent(wifi_got_ip, SYSTEM_EVENT_STA_GOT_IP);
+        event_registered = true;
+    }
+    wifi_conn_start = GET_SYS_MILLIS();
+#endif
     WiFi.begin(ssid, password);
     m_preDisWifiConnInfoMillis = GET_SYS_MILLIS();
 
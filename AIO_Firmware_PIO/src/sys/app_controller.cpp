@@ -1,7 +1,12 @@
+#define LOG_TAG "ctrl"
 #include "app_controller.h"
 #include "app_controller_gui.h"
 #include "common.h"
 #include "interface.h"
+#include "logger.h"
+#include "loop_wake.h"
+#include "buf_pool.h"
+#include "heap_monitor.h"
 #include "Arduino.h"
 
 const char *app_event_type_info[] = {"APP_MESSAGE_WIFI_CONN", "APP_MESSAGE_WIFI_AP",
@@ -11,18 +16,11 @@ const char *app_event_type_info[] = {"APP_MESSAGE_WIFI_CONN", "APP_MESSAGE_WIFI_
                                      "APP_MESSAGE_READ_CFG", "APP_MESSAGE_WRITE_CFG",
                                      "APP_MESSAGE_NONE"};
 
-volatile static bool isRunEventDeal = false;
-
 // TickType_t mainFormRefreshLastTime;
 // const TickType_t xDelay500ms = pdMS_TO_TICKS(500);
 // mainFormRefreshLastTime = xTaskGetTickCount();
 // vTaskDelayUntil(&mainFormRefreshLastTime, xDelay500ms);
 
-void eventDealHandle(TimerHandle_t xTimer)
-{
-    isRunEventDeal = true;
-}
-
 AppController::AppController(const char *name)
 {
     strncpy(this->name, name, APP_CONTROLLER_NAME_LEN);
@@ -33,29 +31,18 @@ AppController::AppController(const char *name)
     // appList = new APP_OBJ[APP_MAX_NUM];
     m_wifi_status = false;
     m_preWifiReqMillis = GET_SYS_MILLIS();
-
-    // 定义一个事件处理定时器
-    xTimerEventDeal = xTimerCreate("Event Deal",
-                                   300 / portTICK_PERIOD_MS,
-                                   pdTRUE, (void *)0, eventDealHandle);
-    // 启动事件处理定时器
-    xTimerStart(xTimerEventDeal, 0);
+    memset(appStats, 0, sizeof(appStats));
+    m_exit_us = 0;
+    m_process_interval = APP_PROCESS_INTERVAL_DEFAULT;
+    // 事件改为在主循环中按时间处理 不再使用定时器周期性地唤醒
+    m_event_deal_millis = GET_SYS_MILLIS();
+    m_event_queue = xQueueCreate(EVENT_LIST_MAX_LENGTH, sizeof(EVENT_OBJ));
 }
 
 void AppController::init(void)
 {
-    // 设置CPU主频
-    if (1 == this->sys_cfg.power_mode)
-    {
-        setCpuFrequencyMhz(240);
-    }
-    else
-    {
-        setCpuFrequencyMhz(80);
-    }
-    // uint32_t freq = getXtalFrequencyMhz(); // In MHz
-    Serial.print(F("CpuFrequencyMhz: "));
-    Serial.println(getCpuFrequencyMhz());
+    // 设置CPU主频（之后由APP声明的性能等级决定）
+    cpu_governor_init(this->sys_cfg.power_mode);
 
     app_control_gui_init();
     appList[0] = new APP_OBJ();
@@ -131,21 +118,115 @@ int AppController::app_auto_start()
     // 进入自启动的APP
     app_exit_flag = 1; // 进入app, 如果已经在
     cur_app_index = index;
-    (*(appList[cur_app_index]->app_init))(this); // 执行APP初始化
+    call_app_init(cur_app_index); // 执行APP初始化
     return 0;
 }
 
+static void update_time_stats(APP_TIME_STATS *stats, uint32_t time_us)
+{
+    ++stats->count;
+    stats->total_us += time_us;
+    if (time_us > stats->max_us)
+    {
+        stats->max_us = time_us;
+    }
+}
+
+void AppController::call_app_init(int index)
+{
+    m_process_interval = APP_PROCESS_INTERVAL_DEFAULT;
+    heap_monitor_set_app(appList[index]->app_name);
+    APP_STATS *stats = &appStats[index];
+    stats->heap_before = esp_get_free_heap_size();
+    uint32_t start = micros();
+    if (NULL != appList[index]->app_init)
+    {
+        (*(appList[index]->app_init))(this);
+    }
+    update_time_stats(&stats->init, micros() - start);
+    stats->init_heap = (int32_t)stats->heap_before - (int32_t)esp_get_free_heap_size();
+}
+
+void AppController::call_app_main(int index, ImuAction *act_info)
+{
+    m_exit_us = 0;
+    uint32_t start = micros();
+    (*(appList[index]->main_process))(this, act_info);
+    update_time_stats(&appStats[index].main, micros() - start - m_exit_us);
+}
+
+void AppController::call_app_exit(int index)
+{
+    APP_STATS *stats = &appStats[index];
+    uint32_t start = micros();
+    if (NULL != appList[index]->exit_callback)
+    {
+        (*(appList[index]->exit_callback))(NULL);
+    }
+    m_exit_us = micros() - start;
+    update_time_stats(&stats->exit, m_exit_us);
+
+    // 缓冲池中的块应在exit_callback中全部归还
+    int leased = buf_pool_leased();
+    if (leased > 0)
+    {
+        LOGW("%s exited with %d pool buffers leased", appList[index]->app_name, leased);
+    }
+    heap_monitor_set_app(NULL);
+
+    // 退出后仍未归还的内存（WiFi等系统缓冲也会带来少量波动）
+    stats->leak_heap = (int32_t)stats->heap_before - (int32_t)esp_get_free_heap_size();
+    if (stats->leak_heap > stats->leak_max)
+    {
+        stats->leak_max = stats->leak_heap;
+    }
+}
+
+const APP_STATS *AppController::get_app_stats(unsigned int index)
+{
+    if (index >= app_num)
+    {
+        return NULL;
+    }
+    return &appStats[index];
+}
+
+static uint32_t avg_us(const APP_TIME_STATS *stats)
+{
+    return 0 == stats->count ? 0 : stats->total_us / stats->count;
+}
+
+void AppController::print_app_stats(Print *out)
+{
+    out->printf("%-16s %21s %21s %21s %8s %8s %8s %6s\n", "app",
+                "init n/avg/max(us)", "main n/avg/max(us)", "exit n/avg/max(us)",
+                "heap", "leak", "leak_max", "send");
+    for (unsigned int pos = 0; pos < app_num; ++pos)
+    {
+        const APP_STATS *stats = &appStats[pos];
+        out->printf("%-16s %5u/%7u/%7u %5u/%7u/%7u %5u/%7u/%7u %8d %8d %8d %6u\n",
+                    appList[pos]->app_name,
+                    stats->init.count, avg_us(&stats->init), stats->init.max_us,
+                    stats->main.count, avg_us(&stats->main), stats->main.max_us,
+                    stats->exit.count, avg_us(&stats->exit), stats->exit.max_us,
+                    stats->init_heap, stats->leak_heap, stats->leak_max,
+                    stats->send_count);
+    }
+}
+
 int AppController::main_process(ImuAction *act_info)
 {
     if (ACTIVE_TYPE::UNKNOWN != act_info->active)
     {
-        Serial.print(F("[Operate]\tact_info->active: "));
-        Serial.println(active_type_info[act_info->active]);
+        LOGD("[Operate]\tact_info->active: %s", active_type_info[act_info->active]);
+        cpu_governor_activity();
     }
 
-    if (isRunEventDeal)
+    take_events();
+    if (!eventList.empty() &&
+        GET_SYS_MILLIS() - m_event_deal_millis >= EVENT_DEAL_INTERVAL)
     {
-        isRunEventDeal = false;
+        m_event_deal_millis = GET_SYS_MILLIS();
         // 扫描事件
         this->req_event_deal();
     }
@@ -165,7 +246,7 @@ int AppController::main_process(ImuAction *act_info)
             anim_type = LV_SCR_LOAD_ANIM_MOVE_RIGHT;
             pre_app_index = cur_app_index;
             cur_app_index = (cur_app_index + 1) % app_num;
-            Serial.println(String("Current App: ") + appList[cur_app_index]->app_name);
+            LOGI("Current App: %s", appList[cur_app_index]->app_name);
         }
         else if (ACTIVE_TYPE::TURN_RIGHT == act_info->active)
         {
@@ -174,15 +255,12 @@ int AppController::main_process(ImuAction *act_info)
             // 以下等效与 processId = (processId - 1 + APP_NUM) % 4;
             // +3为了不让数据溢出成负数，而导致取模逻辑错误
             cur_app_index = (cur_app_index - 1 + app_num) % app_num; // 此处的3与p_processList的长度一致
-            Serial.println(String("Current App: ") + appList[cur_app_index]->app_name);
+            LOGI("Current App: %s", appList[cur_app_index]->app_name);
         }
         else if (ACTIVE_TYPE::GO_FORWORD == act_info->active)
         {
             app_exit_flag = 1; // 进入app
-            if (NULL != appList[cur_app_index]->app_init)
-            {
-                (*(appList[cur_app_index]->app_init))(this); // 执行APP初始化
-            }
+            call_app_init(cur_app_index); // 执行APP初始化
         }
 
         if (ACTIVE_TYPE::GO_FORWORD != act_info->active) // && UNKNOWN != act_info->active
@@ -190,7 +268,11 @@ int AppController::main_process(ImuAction *act_info)
             app_control_display_scr(appList[cur_app_index]->app_image,
                                     appList[cur_app_index]->app_name,
                                     anim_type, false);
-            vTaskDelay(200 / portTICK_PERIOD_MS);
+            if (ACTIVE_TYPE::UNKNOWN != act_info->active)
+            {
+                // 只在切换后等待动画 没有动作时直接返回 由主循环休眠
+                vTaskDelay(200 / portTICK_PERIOD_MS);
+            }
         }
     }
     else
@@ -199,13 +281,34 @@ int AppController::main_process(ImuAction *act_info)
                                 appList[cur_app_index]->app_name,
                                 LV_SCR_LOAD_ANIM_NONE, false);
         // 运行APP进程 等效于把控制权交给当前APP
-        (*(appList[cur_app_index]->main_process))(this, act_info);
+        call_app_main(cur_app_index, act_info);
     }
     act_info->active = ACTIVE_TYPE::UNKNOWN;
     act_info->isValid = 0;
     return 0;
 }
 
+uint32_t AppController::get_wait_time(void)
+{
+    // 在APP中时按APP要求的间隔 在菜单中只等待动作
+    uint32_t wait = 0 != app_exit_flag ? m_process_interval : LOOP_WAIT_FOREVER;
+    unsigned long now = GET_SYS_MILLIS();
+
+    take_events();
+    if (!eventList.empty())
+    {
+        uint32_t passed = now - m_event_deal_millis;
+        wait = min(wait, passed >= EVENT_DEAL_INTERVAL ? 0 : EVENT_DEAL_INTERVAL - passed);
+    }
+    if (0 == sys_cfg.power_mode && true == m_wifi_status)
+    {
+        // wifi自动关闭的时间
+        uint32_t passed = now - m_preWifiReqMillis;
+        wait = min(wait, passed >= WIFI_LIFE_CYCLE ? 0 : WIFI_LIFE_CYCLE - passed);
+    }
+    return wait;
+}
+
 APP_OBJ *AppController::getAppByName(const char *name)
 {
     for (int pos = 0; pos < app_num; ++pos)
@@ -237,28 +340,31 @@ int AppController::send_to(const char *from, const char *to,
                            APP_MESSAGE_TYPE type, void *message,
                            void *ext_info)
 {
-    APP_OBJ *fromApp = getAppByName(from); // 来自谁 有可能为空
+    int fromIndex = getAppIdxByName(from);
+    APP_OBJ *fromApp = fromIndex >= 0 ? appList[fromIndex] : NULL; // 来自谁 有可能为空
     APP_OBJ *toApp = getAppByName(to);     // 发送给谁 有可能为空
+    if (fromIndex >= 0)
+    {
+        ++appStats[fromIndex].send_count;
+    }
     if (type <= APP_MESSAGE_MQTT_DATA)
     {
-        // 更新事件的请求者
-        if (eventList.size() > EVENT_LIST_MAX_LENGTH)
+        // 发给控制器的消息(目前都是wifi事件)
+        // 可能来自其他任务（如TimeSync） 不能直接修改eventList 交给主循环取出
+        EVENT_OBJ new_event = {fromApp, type, message, 3, 0, 0};
+        if (pdTRUE != xQueueSend(m_event_queue, &new_event, 0))
         {
             return 1;
         }
-        // 发给控制器的消息(目前都是wifi事件)
-        EVENT_OBJ new_event = {fromApp, type, message, 3, 0, 0};
-        eventList.push_back(new_event);
-        Serial.print("[EVENT]\tAdd -> " + String(app_event_type_info[type]));
-        Serial.print(F("\tEventList Size: "));
-        Serial.println(eventList.size());
+        loop_wake(); // 唤醒主循环处理
+        LOGI("[EVENT]\tAdd -> %s", app_event_type_info[type]);
     }
     else
     {
         // 各个APP之间通信的消息
         if (NULL != toApp)
         {
-            Serial.print("[Massage]\tFrom " + String(fromApp->app_name) + "\tTo " + String(toApp->app_name) + "\n");
+            LOGD("[Massage]\tFrom %s\tTo %s", fromApp->app_name, toApp->app_name);
             if (NULL != toApp->message_handle)
             {
                 toApp->message_handle(from, to, type, message, ext_info);
@@ -266,13 +372,77 @@ int AppController::send_to(const char *from, const char *to,
         }
         else if (!strcmp(to, CTRL_NAME))
         {
-            Serial.print("[Massage]\tFrom " + String(fromApp->app_name) + "\tTo " + CTRL_NAME + "\n");
+            LOGD("[Massage]\tFrom %s\tTo " CTRL_NAME, fromApp->app_name);
             deal_config(type, (const char *)message, (char *)ext_info);
         }
     }
     return 0;
 }
 
+// 批量读写参数 所有参数仍然逐个经过send_to转发 APP不需要做任何修改
+int AppController::send_params(const char *from, const char *to,
+                               APP_MESSAGE_TYPE type, APP_PARAM *params, int num)
+{
+    if (APP_MESSAGE_GET_PARAM == type)
+    {
+        send_to(from, to, APP_MESSAGE_READ_CFG, NULL, NULL);
+        for (int pos = 0; pos < num; ++pos)
+        {
+            char value[APP_PARAM_VALUE_LEN] = {0};
+            send_to(from, to, APP_MESSAGE_GET_PARAM,
+                    (void *)params[pos].key.c_str(), value);
+            params[pos].value = value;
+        }
+    }
+    else if (APP_MESSAGE_SET_PARAM == type)
+    {
+        // 先读取一次 没有出现在params中的参数保持原值
+        send_to(from, to, APP_MESSAGE_READ_CFG, NULL, NULL);
+        for (int pos = 0; pos < num; ++pos)
+        {
+            send_to(from, to, APP_MESSAGE_SET_PARAM,
+                    (void *)params[pos].key.c_str(),
+                    (void *)params[pos].value.c_str());
+        }
+        send_to(from, to, APP_MESSAGE_WRITE_CFG, NULL, NULL);
+    }
+    else
+    {
+        return 1;
+    }
+    return 0;
+}
+
+const APP_OBJ *AppController::get_app(unsigned int index)
+{
+    if (index >= app_num)
+    {
+        return NULL;
+    }
+    return appList[index];
+}
+
+bool AppController::is_app_installed(const char *name)
+{
+    return NULL != getAppByName(name);
+}
+
+void AppController::take_events(void)
+{
+    EVENT_OBJ event;
+    while (pdTRUE == xQueueReceive(m_event_queue, &event, 0))
+    {
+        if (eventList.size() > EVENT_LIST_MAX_LENGTH)
+        {
+            LOGW("[EVENT]\tDrop -> %s", app_event_type_info[event.type]);
+            continue;
+        }
+        eventList.push_back(event);
+        LOGI("[EVENT]\tEventList Size: %u", eventList.size());
+    }
+    METRIC_SET(METRIC_EVENT_QUEUE_DEPTH, eventList.size());
+}
+
 int AppController::req_event_deal(void)
 {
     // 请求事件的处理
@@ -292,10 +462,9 @@ int AppController::req_event_deal(void)
             if ((*event).retryCount >= (*event).retryMaxNum)
             {
                 // 多次重试失败
-                Serial.print("[EVENT]\tDelete -> " + String(app_event_type_info[(*event).type]));
+                const char *type_info = app_event_type_info[(*event).type];
                 event = eventList.erase(event); // 删除该响应事件
-                Serial.print(F("\tEventList Size: "));
-                Serial.println(eventList.size());
+                LOGW("[EVENT]\tDelete -> %s\tEventList Size: %u", type_info, eventList.size());
             }
             else
             {
@@ -312,11 +481,11 @@ int AppController::req_event_deal(void)
             (*((*event).from->message_handle))(CTRL_NAME, (*event).from->app_name,
                                                (*event).type, (*event).info, NULL);
         }
-        Serial.print("[EVENT]\tDelete -> " + String(app_event_type_info[(*event).type]));
+        const char *type_info = app_event_type_info[(*event).type];
         event = eventList.erase(event); // 删除该响应完成的事件
-        Serial.print(F("\tEventList Size: "));
-        Serial.println(eventList.size());
+        LOGI("[EVENT]\tDelete -> %s\tEventList Size: %u", type_info, eventList.size());
     }
+    METRIC_SET(METRIC_EVENT_QUEUE_DEPTH, eventList.size());
     return 0;
 }
 
@@ -375,17 +544,18 @@ bool AppController::wifi_event(APP_MESSAGE_TYPE type)
     break;
     case APP_MESSAGE_MQTT_DATA:
     {
-        Serial.println("APP_MESSAGE_MQTT_DATA");
+        LOGI("APP_MESSAGE_MQTT_DATA");
         if (app_exit_flag == 1 && cur_app_index != getAppIdxByName("Heartbeat")) // 在其他app中
         {
             app_exit_flag = 0;
-            (*(appList[cur_app_index]->exit_callback))(NULL); // 退出当前app
+            call_app_exit(cur_app_index); // 退出当前app
+            cpu_governor_release(appList[cur_app_index]->app_name);
         }
         if (app_exit_flag == 0)
         {
             app_exit_flag = 1; // 进入app, 如果已经在
             cur_app_index = getAppIdxByName("Heartbeat");
-            (*(getAppByName("Heartbeat")->app_init))(this); // 执行APP初始化
+            call_app_init(cur_app_index); // 执行APP初始化
         }
     }
     break;
@@ -401,6 +571,7 @@ void AppController::app_exit()
     app_exit_flag = 0; // 退出APP
 
     // 清空该对象的所有请求
+    take_events();
     for (std::list<EVENT_OBJ>::iterator event = eventList.begin(); event != eventList.end();)
     {
         if (appList[cur_app_index] == (*event).from)
@@ -412,39 +583,19 @@ void AppController::app_exit()
             ++event;
         }
     }
+    METRIC_SET(METRIC_EVENT_QUEUE_DEPTH, eventList.size());
 
-    if (NULL != appList[cur_app_index]->exit_callback)
-    {
-        // 执行APP退出回调
-        (*(appList[cur_app_index]->exit_callback))(NULL);
-    }
+    // 执行APP退出回调
+    call_app_exit(cur_app_index);
+    // APP退出时把延迟提交的配置写入flash
+    g_cfgStore.flush();
     app_control_display_scr(appList[cur_app_index]->app_image,
                             appList[cur_app_index]->app_name,
                             LV_SCR_LOAD_ANIM_NONE, true);
 
-    // 恢复RGB灯  HSV色彩模式
-    RgbConfig *cfg = &rgb_cfg;
-    RgbParam rgb_setting = {LED_MODE_HSV,
-                            cfg->min_value_0, cfg->min_value_1, cfg->min_value_2,
-                            cfg->max_value_0, cfg->max_value_1, cfg->max_value_2,
-                            cfg->step_0, cfg->step_1, cfg->step_2,
-                            cfg->min_brightness, cfg->max_brightness,
-                            cfg->brightness_step, cfg->time, 
+    // 恢复RGB灯（系统设置中的灯效 在读写rgb配置时注册）
+    rgb_effect_run(RGB_EFFECT_SYSTEM);
 
-                            cfg->brightness_night_mode_specified, 
-                            cfg->brightness_night_mode_start, 
-                            cfg->brightness_night_mode_end};
-    set_rgb_and_run(&rgb_setting);
-
-    // 设置CPU主频
-    if (1 == this->sys_cfg.power_mode)
-    {
-        setCpuFrequencyMhz(240);
-    }
-    else
-    {
-        setCpuFrequencyMhz(80);
-    }
-    Serial.print(F("CpuFrequencyMhz: "));
-    Serial.println(getCpuFrequencyMhz());
+    // 撤销APP声明的性能等级 回到界面所需的主频
+    cpu_governor_release(appList[cur_app_index]->app_name);
 }
\ No newline at end of file
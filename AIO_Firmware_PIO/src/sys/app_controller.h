@@ -4,7 +4,9 @@
 #include "Arduino.h"
 #include "interface.h"
 #include "driver/imu.h"
+#include "driver/gesture.h"
 #include "common.h"
+#include "cpu_governor.h"
 #include <list>
 
 #define CTRL_NAME "AppCtrl"
@@ -12,7 +14,12 @@
 #define WIFI_LIFE_CYCLE 60000      // wifi的生命周期（60s）
 #define MQTT_ALIVE_CYCLE 1000      // mqtt重连周期
 #define EVENT_LIST_MAX_LENGTH 10   // 消息队列的容量
+#define EVENT_DEAL_INTERVAL 300    // 有未处理的事件时 处理事件的间隔 ms
+#define APP_PROCESS_INTERVAL_DEFAULT 0 // 默认不等待 每轮主循环都调用APP的main_process
 #define APP_CONTROLLER_NAME_LEN 16 // app控制器的名字长度
+#define APP_PARAM_VALUE_LEN 128    // GET_PARAM时APP写入参数值的缓冲区大小（天气的tianqi_url最长128）
+#define GESTURE_PARAM_PREFIX "gesture_"     // 通过GET/SET_PARAM访问阈值时的键名前缀
+#define BACKLIGHT_PARAM_PREFIX "backlight_" // 通过GET/SET_PARAM访问背光参数时的键名前缀
 
 // struct EVENT_OBJ
 // {
@@ -33,6 +40,34 @@ struct EVENT_OBJ
     unsigned long nextRunTime; // 下次运行的时间戳
 };
 
+// 单个回调的耗时统计
+struct APP_TIME_STATS
+{
+    uint32_t count;
+    uint32_t max_us;
+    uint64_t total_us;
+};
+
+// 每个APP的运行统计（与appList一一对应）
+struct APP_STATS
+{
+    APP_TIME_STATS init;  // app_init
+    APP_TIME_STATS main;  // main_process
+    APP_TIME_STATS exit;  // exit_callback
+    int32_t init_heap;    // 最近一次初始化占用的内存（初始化前后空闲内存的差）
+    int32_t leak_heap;    // 最近一次从进入到退出后没有归还的内存
+    int32_t leak_max;     // 历次没有归还内存的最大值
+    uint32_t heap_before; // 进入APP前的空闲内存
+    uint32_t send_count;  // 调用send_to的次数
+};
+
+// 批量读写参数时的一项
+struct APP_PARAM
+{
+    String key;
+    String value;
+};
+
 class AppController
 {
 public:
@@ -49,13 +84,29 @@ public:
     // 将APP的后台任务从任务队列中移除(自能通过APP退出的时候，移除自身的后台任务)
     int remove_backgroud_task(void);
     int main_process(ImuAction *act_info);
+    // 主循环在下一次调用main_process前最多可以休眠的时间 ms
+    uint32_t get_wait_time(void);
+    // 前台APP的main_process最长多久调用一次 有动作、消息时会提前调用
+    // 进入APP时恢复为APP_PROCESS_INTERVAL_DEFAULT
+    void set_process_interval(uint32_t interval_ms) { m_process_interval = interval_ms; }
     void app_exit(void); // 提供给app退出的系统调用
     // 消息发送
     int send_to(const char *from, const char *to,
                 APP_MESSAGE_TYPE type, void *message,
                 void *ext_info);
+    // 批量获取（APP_MESSAGE_GET_PARAM）或设置（APP_MESSAGE_SET_PARAM）参数
+    // 获取前只读取一次配置 设置完只保存一次配置
+    int send_params(const char *from, const char *to,
+                    APP_MESSAGE_TYPE type, APP_PARAM *params, int num);
     void deal_config(APP_MESSAGE_TYPE type,
                      const char *key, char *value);
+    // 各APP的运行统计
+    const APP_STATS *get_app_stats(unsigned int index);
+    void print_app_stats(Print *out);
+    // 已安装的APP
+    unsigned int get_app_num(void) { return app_num; }
+    const APP_OBJ *get_app(unsigned int index);
+    bool is_app_installed(const char *name);
     // 事件处理
     int req_event_deal(void);
     bool wifi_event(APP_MESSAGE_TYPE type); // wifi事件的处理
@@ -65,31 +116,46 @@ public:
     void write_config(SysMpuConfig *cfg);
     void read_config(RgbConfig *cfg);
     void write_config(RgbConfig *cfg);
+    void read_config(GestureConfig *cfg);
+    void write_config(GestureConfig *cfg);
+    void read_config(BacklightConfig *cfg);
+    void write_config(BacklightConfig *cfg);
 
 private:
     APP_OBJ *getAppByName(const char *name);
     int getAppIdxByName(const char *name);
     int app_is_legal(const APP_OBJ *app_obj);
+    // 调用APP的回调并记录耗时与内存变化
+    void call_app_init(int index);
+    void call_app_main(int index, ImuAction *act_info);
+    void call_app_exit(int index);
+    // 把其他任务发来的事件移入eventList（只在主循环中调用）
+    void take_events(void);
 
 private:
     char name[APP_CONTROLLER_NAME_LEN]; // app控制器的名字
     APP_OBJ *appList[APP_MAX_NUM];      // 预留APP_MAX_NUM个APP注册位
     APP_TYPE appTypeList[APP_MAX_NUM];  // 对应APP的运行类型
     // std::list<const APP_OBJ *> app_list; // APP注册位(为了C语言可移植，放弃使用链表)
-    std::list<EVENT_OBJ> eventList;   // 用来储存事件
+    std::list<EVENT_OBJ> eventList;   // 用来储存事件 只在主循环中访问
+    QueueHandle_t m_event_queue;      // send_to可能来自其他任务 事件先放入队列再由主循环取出
     boolean m_wifi_status;            // 表示是wifi状态 true开启 false关闭
     unsigned long m_preWifiReqMillis; // 保存上一回请求的时间戳
     unsigned int app_num;
     boolean app_exit_flag; // 表示是否退出APP应用
     int cur_app_index;     // 当前运行的APP下标
     int pre_app_index;     // 上一次运行的APP下标
-
-    TimerHandle_t xTimerEventDeal; // 事件处理定时器
+    APP_STATS appStats[APP_MAX_NUM]; // 对应APP的运行统计
+    uint32_t m_exit_us;              // 在main_process中退出时 退出花费的时间（不计入main_process）
+    uint32_t m_process_interval;     // 前台APP要求的main_process调用间隔
+    unsigned long m_event_deal_millis; // 上一次处理事件的时间
 
 public:
     SysUtilConfig sys_cfg;
     SysMpuConfig mpu_cfg;
     RgbConfig rgb_cfg;
+    GestureConfig gesture_cfg;
+    BacklightConfig backlight_cfg;
 };
 
 #endif
\ No newline at end of file
@@ -7,284 +7,154 @@
 #define MPU_CONFIG_PATH "/mpu.cfg"
 #define RGB_CONFIG_PATH "/rgb01.cfg"
 
+#define APP_CTRL_CONFIG_NS "sys"
+#define MPU_CONFIG_NS "mpu"
+#define RGB_CONFIG_NS "rgb"
+#define GESTURE_CONFIG_NS "gesture"
+#define BACKLIGHT_CONFIG_NS "backlight"
+
+// 与旧版文本配置文件中的行顺序一致
+static const char *const sys_cfg_keys[] = {
+    "ssid_0", "password_0", "ssid_1", "password_1", "ssid_2", "password_2",
+    "power_mode", "backLight", "rotation", "auto_calibration_mpu", "mpu_order",
+    "auto_start_app"};
+
+static const char *const mpu_cfg_keys[] = {
+    "x_gyro_offset", "y_gyro_offset", "z_gyro_offset",
+    "x_accel_offset", "y_accel_offset", "z_accel_offset"};
+
+static const char *const rgb_cfg_keys[] = {
+    "mode", "min_value_0", "min_value_1", "min_value_2",
+    "max_value_0", "max_value_1", "max_value_2", "step_0", "step_1", "step_2",
+    "min_brightness", "max_brightness", "brightness_step", "time",
+    "brightness_night_mode_specified", "brightness_night_mode_start",
+    "brightness_night_mode_end"};
+
 void AppController::read_config(SysUtilConfig *cfg)
 {
-    // 如果有需要持久化配置文件 可以调用此函数将数据存在flash中
-    // 配置文件名最好以APP名为开头 以".cfg"结尾，以免多个APP读取混乱
-    char info[128] = {0};
-    uint16_t size = g_flashCfg.readFile(APP_CTRL_CONFIG_PATH, (uint8_t *)info);
-    info[size] = 0;
-    if (size == 0)
+    bool exist = g_cfgStore.migrate(APP_CTRL_CONFIG_NS, APP_CTRL_CONFIG_PATH, sys_cfg_keys);
+    cfg->ssid_0 = g_cfgStore.getString(APP_CTRL_CONFIG_NS, "ssid_0");
+    cfg->password_0 = g_cfgStore.getString(APP_CTRL_CONFIG_NS, "password_0");
+    cfg->ssid_1 = g_cfgStore.getString(APP_CTRL_CONFIG_NS, "ssid_1");
+    cfg->password_1 = g_cfgStore.getString(APP_CTRL_CONFIG_NS, "password_1");
+    cfg->ssid_2 = g_cfgStore.getString(APP_CTRL_CONFIG_NS, "ssid_2");
+    cfg->password_2 = g_cfgStore.getString(APP_CTRL_CONFIG_NS, "password_2");
+    // 默认值
+    cfg->power_mode = g_cfgStore.getUInt(APP_CTRL_CONFIG_NS, "power_mode", 0);  // 功耗模式（0为节能模式 1为性能模式）
+    cfg->backLight = g_cfgStore.getUInt(APP_CTRL_CONFIG_NS, "backLight", 80);   // 屏幕亮度（1-100）
+    cfg->rotation = g_cfgStore.getUInt(APP_CTRL_CONFIG_NS, "rotation", 4);      // 屏幕旋转方向
+    cfg->auto_calibration_mpu = g_cfgStore.getUInt(APP_CTRL_CONFIG_NS, "auto_calibration_mpu", 1); // 是否自动校准陀螺仪
+    cfg->mpu_order = g_cfgStore.getUInt(APP_CTRL_CONFIG_NS, "mpu_order", 0);    // 操作方向
+    cfg->auto_start_app = g_cfgStore.getString(APP_CTRL_CONFIG_NS, "auto_start_app", "None"); // 开机自启APP的name
+    if (!exist)
     {
-        // 默认值
-        cfg->power_mode = 0;           // 功耗模式（0为节能模式 1为性能模式）
-        cfg->backLight = 80;           // 屏幕亮度（1-100）
-        cfg->rotation = 4;             // 屏幕旋转方向
-        cfg->auto_calibration_mpu = 1; // 是否自动校准陀螺仪 0关闭自动校准 1打开自动校准
-        cfg->mpu_order = 0;            // 操作方向
-        cfg->auto_start_app = "None";  // 无指定开机自启APP
         this->write_config(cfg);
     }
-    else
-    {
-        // 解析数据
-        char *param[12] = {0};
-        analyseParam(info, 12, param);
-        cfg->ssid_0 = param[0];
-        cfg->password_0 = param[1];
-        cfg->ssid_1 = param[2];
-        cfg->password_1 = param[3];
-        cfg->ssid_2 = param[4];
-        cfg->password_2 = param[5];
-        cfg->power_mode = atol(param[6]);
-        cfg->backLight = atol(param[7]);
-        cfg->rotation = atol(param[8]);
-        cfg->auto_calibration_mpu = atol(param[9]);
-        cfg->mpu_order = atol(param[10]);
-        cfg->auto_start_app = param[11]; // 开机自启APP的name
-    }
 }
 
 void AppController::write_config(SysUtilConfig *cfg)
 {
-    char tmp[25];
-    // 将配置数据保存在文件中（持久化）
-    String w_data;
-    w_data = w_data + cfg->ssid_0 + "\n";
-    w_data = w_data + cfg->password_0 + "\n";
-    w_data = w_data + cfg->ssid_1 + "\n";
-    w_data = w_data + cfg->password_1 + "\n";
-    w_data = w_data + cfg->ssid_2 + "\n";
-    w_data = w_data + cfg->password_2 + "\n";
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%u\n", cfg->power_mode);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%u\n", cfg->backLight);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%u\n", cfg->rotation);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%u\n", cfg->auto_calibration_mpu);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%u\n", cfg->mpu_order);
-    w_data += tmp;
-
-    w_data = w_data + cfg->auto_start_app + "\n";
-
-    g_flashCfg.writeFile(APP_CTRL_CONFIG_PATH, w_data.c_str());
-
-    // 立即生效相关配置
-    if(!screen.night_mode) {
-        screen.setBackLight(cfg->backLight / 100.0);
+    // 将配置数据保存在配置存储中（持久化）
+    g_cfgStore.setString(APP_CTRL_CONFIG_NS, "ssid_0", cfg->ssid_0.c_str());
+    g_cfgStore.setString(APP_CTRL_CONFIG_NS, "password_0", cfg->password_0.c_str());
+    g_cfgStore.setString(APP_CTRL_CONFIG_NS, "ssid_1", cfg->ssid_1.c_str());
+    g_cfgStore.setString(APP_CTRL_CONFIG_NS, "password_1", cfg->password_1.c_str());
+    g_cfgStore.setString(APP_CTRL_CONFIG_NS, "ssid_2", cfg->ssid_2.c_str());
+    g_cfgStore.setString(APP_CTRL_CONFIG_NS, "password_2", cfg->password_2.c_str());
+    g_cfgStore.setUInt(APP_CTRL_CONFIG_NS, "power_mode", cfg->power_mode);
+    g_cfgStore.setUInt(APP_CTRL_CONFIG_NS, "backLight", cfg->backLight);
+    g_cfgStore.setUInt(APP_CTRL_CONFIG_NS, "rotation", cfg->rotation);
+    g_cfgStore.setUInt(APP_CTRL_CONFIG_NS, "auto_calibration_mpu", cfg->auto_calibration_mpu);
+    g_cfgStore.setUInt(APP_CTRL_CONFIG_NS, "mpu_order", cfg->mpu_order);
+    g_cfgStore.setString(APP_CTRL_CONFIG_NS, "auto_start_app", cfg->auto_start_app.c_str());
+    g_cfgStore.commit();
+
+    // 立即生效相关配置（只在数值变化时重新设置）
+    g_backlight.setUserLevel(cfg->backLight); // 与夜间模式、环境光合并后由背光控制写入
+
+    static uint8_t applied_rotation = 0xFF;
+
+    if (applied_rotation != cfg->rotation)
+    {
+        applied_rotation = cfg->rotation;
+        tft->setRotation(cfg->rotation);
     }
-
-    tft->setRotation(cfg->rotation);
     mpu.setOrder(cfg->mpu_order);
 }
 
 void AppController::read_config(SysMpuConfig *cfg)
 {
-    // 如果有需要持久化配置文件 可以调用此函数将数据存在flash中
-    // 配置文件名最好以APP名为开头 以".cfg"结尾，以免多个APP读取混乱
-    char info[128] = {0};
-    uint16_t size = g_flashCfg.readFile(MPU_CONFIG_PATH, (uint8_t *)info);
-    info[size] = 0;
-    if (size == 0)
+    bool exist = g_cfgStore.migrate(MPU_CONFIG_NS, MPU_CONFIG_PATH, mpu_cfg_keys);
+    cfg->x_gyro_offset = g_cfgStore.getInt(MPU_CONFIG_NS, "x_gyro_offset", 0);
+    cfg->y_gyro_offset = g_cfgStore.getInt(MPU_CONFIG_NS, "y_gyro_offset", 0);
+    cfg->z_gyro_offset = g_cfgStore.getInt(MPU_CONFIG_NS, "z_gyro_offset", 0);
+    cfg->x_accel_offset = g_cfgStore.getInt(MPU_CONFIG_NS, "x_accel_offset", 0);
+    cfg->y_accel_offset = g_cfgStore.getInt(MPU_CONFIG_NS, "y_accel_offset", 0);
+    cfg->z_accel_offset = g_cfgStore.getInt(MPU_CONFIG_NS, "z_accel_offset", 0);
+    if (!exist)
     {
-        // 默认值
-        cfg->x_gyro_offset = 0;
-        cfg->y_gyro_offset = 0;
-        cfg->z_gyro_offset = 0;
-        cfg->x_accel_offset = 0;
-        cfg->y_accel_offset = 0;
-        cfg->z_accel_offset = 0;
-
         this->write_config(cfg);
     }
-    else
-    {
-        // 解析数据
-        char *param[6] = {0};
-        analyseParam(info, 6, param);
-        cfg->x_gyro_offset = atol(param[0]);
-        cfg->y_gyro_offset = atol(param[1]);
-        cfg->z_gyro_offset = atol(param[2]);
-        cfg->x_accel_offset = atol(param[3]);
-        cfg->y_accel_offset = atol(param[4]);
-        cfg->z_accel_offset = atol(param[5]);
-    }
 }
 
 void AppController::write_config(SysMpuConfig *cfg)
 {
-    char tmp[25];
-    // 将配置数据保存在文件中（持久化）
-    String w_data;
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%d\n", cfg->x_gyro_offset);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%d\n", cfg->y_gyro_offset);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%d\n", cfg->z_gyro_offset);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%d\n", cfg->x_accel_offset);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%d\n", cfg->y_accel_offset);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%d\n", cfg->z_accel_offset);
-    w_data += tmp;
-    g_flashCfg.writeFile(MPU_CONFIG_PATH, w_data.c_str());
+    g_cfgStore.setInt(MPU_CONFIG_NS, "x_gyro_offset", cfg->x_gyro_offset);
+    g_cfgStore.setInt(MPU_CONFIG_NS, "y_gyro_offset", cfg->y_gyro_offset);
+    g_cfgStore.setInt(MPU_CONFIG_NS, "z_gyro_offset", cfg->z_gyro_offset);
+    g_cfgStore.setInt(MPU_CONFIG_NS, "x_accel_offset", cfg->x_accel_offset);
+    g_cfgStore.setInt(MPU_CONFIG_NS, "y_accel_offset", cfg->y_accel_offset);
+    g_cfgStore.setInt(MPU_CONFIG_NS, "z_accel_offset", cfg->z_accel_offset);
+    g_cfgStore.commit();
 }
 
 void AppController::read_config(RgbConfig *cfg)
 {
-    // 如果有需要持久化配置文件 可以调用此函数将数据存在flash中
-    // 配置文件名最好以APP名为开头 以".cfg"结尾，以免多个APP读取混乱
-    char info[128] = {0};
-    uint16_t size = g_flashCfg.readFile(RGB_CONFIG_PATH, (uint8_t *)info);
-    info[size] = 0;
-    if (size == 0)
+    bool exist = g_cfgStore.migrate(RGB_CONFIG_NS, RGB_CONFIG_PATH, rgb_cfg_keys);
+    // 默认值
+    cfg->mode = g_cfgStore.getUInt(RGB_CONFIG_NS, "mode", 1);
+    cfg->min_value_0 = g_cfgStore.getUInt(RGB_CONFIG_NS, "min_value_0", 1);
+    cfg->min_value_1 = g_cfgStore.getUInt(RGB_CONFIG_NS, "min_value_1", 32);
+    cfg->min_value_2 = g_cfgStore.getUInt(RGB_CONFIG_NS, "min_value_2", 255);
+    cfg->max_value_0 = g_cfgStore.getUInt(RGB_CONFIG_NS, "max_value_0", 255);
+    cfg->max_value_1 = g_cfgStore.getUInt(RGB_CONFIG_NS, "max_value_1", 255);
+    cfg->max_value_2 = g_cfgStore.getUInt(RGB_CONFIG_NS, "max_value_2", 255);
+    cfg->step_0 = g_cfgStore.getInt(RGB_CONFIG_NS, "step_0", 1);
+    cfg->step_1 = g_cfgStore.getInt(RGB_CONFIG_NS, "step_1", 1);
+    cfg->step_2 = g_cfgStore.getInt(RGB_CONFIG_NS, "step_2", 1);
+    cfg->min_brightness = g_cfgStore.getUInt(RGB_CONFIG_NS, "min_brightness", 150);
+    cfg->max_brightness = g_cfgStore.getUInt(RGB_CONFIG_NS, "max_brightness", 250);
+    cfg->brightness_step = g_cfgStore.getInt(RGB_CONFIG_NS, "brightness_step", 1);
+    cfg->time = g_cfgStore.getInt(RGB_CONFIG_NS, "time", 30);
+    cfg->brightness_night_mode_specified = g_cfgStore.getInt(RGB_CONFIG_NS, "brightness_night_mode_specified", 100);
+    cfg->brightness_night_mode_start = g_cfgStore.getInt(RGB_CONFIG_NS, "brightness_night_mode_start", 22);
+    cfg->brightness_night_mode_end = g_cfgStore.getInt(RGB_CONFIG_NS, "brightness_night_mode_end", 7);
+    if (!exist)
     {
-        // 默认值
-        cfg->mode = 1;
-        cfg->min_value_0 = 1;
-        cfg->min_value_1 = 32;
-        cfg->min_value_2 = 255;
-        cfg->max_value_0 = 255;
-        cfg->max_value_1 = 255;
-        cfg->max_value_2 = 255;
-        cfg->step_0 = 1;
-        cfg->step_1 = 1;
-        cfg->step_2 = 1;
-        cfg->min_brightness = 150;
-        cfg->max_brightness = 250;
-        cfg->brightness_step = 1;
-        cfg->time = 30;
-        cfg->brightness_night_mode_specified = 100;
-        cfg->brightness_night_mode_start = 22;
-        cfg->brightness_night_mode_end = 7;
-
         this->write_config(cfg);
     }
-    else
-    {
-        // 解析数据
-        char *param[17] = {0};
-        analyseParam(info, 17, param);
-        cfg->mode = atol(param[0]);
-        cfg->min_value_0 = atol(param[1]);
-        cfg->min_value_1 = atol(param[2]);
-        cfg->min_value_2 = atol(param[3]);
-        cfg->max_value_0 = atol(param[4]);
-        cfg->max_value_1 = atol(param[5]);
-        cfg->max_value_2 = atol(param[6]);
-        cfg->step_0 = atol(param[7]);
-        cfg->step_1 = atol(param[8]);
-        cfg->step_2 = atol(param[9]);
-        cfg->min_brightness = atol(param[10]);
-        cfg->max_brightness = atol(param[11]);
-        cfg->brightness_step = atol(param[12]);
-        cfg->time = atol(param[13]);
-        cfg->brightness_night_mode_specified = atol(param[14]);
-        cfg->brightness_night_mode_start = atol(param[15]);
-        cfg->brightness_night_mode_end = atol(param[16]);
-    }
 }
 
 void AppController::write_config(RgbConfig *cfg)
 {
-    char tmp[25];
-    // 将配置数据保存在文件中（持久化）
-    String w_data;
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%u\n", cfg->mode);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%u\n", cfg->min_value_0);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%u\n", cfg->min_value_1);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%u\n", cfg->min_value_2);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%u\n", cfg->max_value_0);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%u\n", cfg->max_value_1);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%u\n", cfg->max_value_2);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%d\n", cfg->step_0);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%d\n", cfg->step_1);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%d\n", cfg->step_2);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%u\n", cfg->min_brightness);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%u\n", cfg->max_brightness);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%d\n", cfg->brightness_step);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%d\n", cfg->time);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%d\n", cfg->brightness_night_mode_specified);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%d\n", cfg->brightness_night_mode_start);
-    w_data += tmp;
-
-    memset(tmp, 0, 25);
-    snprintf(tmp, 25, "%d\n", cfg->brightness_night_mode_end);
-    w_data += tmp;
-
-    Serial.println("Write RGB Config:");
-    Serial.println(w_data);
-
-    g_flashCfg.writeFile(RGB_CONFIG_PATH, w_data.c_str());
+    g_cfgStore.setUInt(RGB_CONFIG_NS, "mode", cfg->mode);
+    g_cfgStore.setUInt(RGB_CONFIG_NS, "min_value_0", cfg->min_value_0);
+    g_cfgStore.setUInt(RGB_CONFIG_NS, "min_value_1", cfg->min_value_1);
+    g_cfgStore.setUInt(RGB_CONFIG_NS, "min_value_2", cfg->min_value_2);
+    g_cfgStore.setUInt(RGB_CONFIG_NS, "max_value_0", cfg->max_value_0);
+    g_cfgStore.setUInt(RGB_CONFIG_NS, "max_value_1", cfg->max_value_1);
+    g_cfgStore.setUInt(RGB_CONFIG_NS, "max_value_2", cfg->max_value_2);
+    g_cfgStore.setInt(RGB_CONFIG_NS, "step_0", cfg->step_0);
+    g_cfgStore.setInt(RGB_CONFIG_NS, "step_1", cfg->step_1);
+    g_cfgStore.setInt(RGB_CONFIG_NS, "step_2", cfg->step_2);
+    g_cfgStore.setUInt(RGB_CONFIG_NS, "min_brightness", cfg->min_brightness);
+    g_cfgStore.setUInt(RGB_CONFIG_NS, "max_brightness", cfg->max_brightness);
+    g_cfgStore.setInt(RGB_CONFIG_NS, "brightness_step", cfg->brightness_step);
+    g_cfgStore.setInt(RGB_CONFIG_NS, "time", cfg->time);
+    g_cfgStore.setInt(RGB_CONFIG_NS, "brightness_night_mode_specified", cfg->brightness_night_mode_specified);
+    g_cfgStore.setInt(RGB_CONFIG_NS, "brightness_night_mode_start", cfg->brightness_night_mode_start);
+    g_cfgStore.setInt(RGB_CONFIG_NS, "brightness_night_mode_end", cfg->brightness_night_mode_end);
+    g_cfgStore.commit();
 
     // 初始化RGB灯 HSV色彩模式
     RgbParam rgb_setting = {LED_MODE_HSV,
@@ -297,19 +167,66 @@ void AppController::write_config(RgbConfig *cfg)
                             rgb_cfg.brightness_night_mode_specified,
                             rgb_cfg.brightness_night_mode_start,
                             rgb_cfg.brightness_night_mode_end};
-    // 初始化RGB任务
-    set_rgb_and_run(&rgb_setting);
+    // 更新系统灯效并运行RGB任务
+    rgb_effect_register(RGB_EFFECT_SYSTEM, &rgb_setting);
+    rgb_effect_run(RGB_EFFECT_SYSTEM);
     
     // 立即生效数据
-    screen.night_mode = is_night_mode_time(cfg->brightness_night_mode_start, cfg->brightness_night_mode_end);
-    if(screen.night_mode) {
-        screen.setBackLight(cfg->brightness_night_mode_specified / 100.0);
-    } else {
-        Serial.println(sys_cfg.backLight / 100.0);
-        
-        screen.setBackLight(sys_cfg.backLight / 100.0);
+    g_backlight.setNightMode(cfg->brightness_night_mode_specified,
+                             cfg->brightness_night_mode_start,
+                             cfg->brightness_night_mode_end);
+}
+
+void AppController::read_config(GestureConfig *cfg)
+{
+    // 没有保存过的阈值使用默认值
+    GestureConfig def;
+    gesture_default_config(&def);
+    for (int pos = 0; pos < GESTURE_PARAM_NUM; ++pos)
+    {
+        *gesture_param(cfg, gesture_param_name[pos]) =
+            g_cfgStore.getInt(GESTURE_CONFIG_NS, gesture_param_name[pos],
+                              *gesture_param(&def, gesture_param_name[pos]));
+    }
+}
+
+void AppController::write_config(GestureConfig *cfg)
+{
+    for (int pos = 0; pos < GESTURE_PARAM_NUM; ++pos)
+    {
+        g_cfgStore.setInt(GESTURE_CONFIG_NS, gesture_param_name[pos],
+                          *gesture_param(cfg, gesture_param_name[pos]));
     }
+    g_cfgStore.commit();
 
+    // 立即生效
+    mpu.setGestureConfig(cfg);
+}
+
+void AppController::read_config(BacklightConfig *cfg)
+{
+    // 没有保存过的参数使用默认值
+    BacklightConfig def;
+    backlight_default_config(&def);
+    for (int pos = 0; pos < BACKLIGHT_PARAM_NUM; ++pos)
+    {
+        *backlight_param(cfg, backlight_param_name[pos]) =
+            g_cfgStore.getUInt(BACKLIGHT_CONFIG_NS, backlight_param_name[pos],
+                               *backlight_param(&def, backlight_param_name[pos]));
+    }
+}
+
+void AppController::write_config(BacklightConfig *cfg)
+{
+    for (int pos = 0; pos < BACKLIGHT_PARAM_NUM; ++pos)
+    {
+        g_cfgStore.setUInt(BACKLIGHT_CONFIG_NS, backlight_param_name[pos],
+                           *backlight_param(cfg, backlight_param_name[pos]));
+    }
+    g_cfgStore.commit();
+
+    // 立即生效
+    g_backlight.setConfig(cfg);
 }
 
 void AppController::deal_config(APP_MESSAGE_TYPE type,
@@ -320,7 +237,23 @@ void AppController::deal_config(APP_MESSAGE_TYPE type,
 
     case APP_MESSAGE_GET_PARAM:
     {
-        if (!strcmp(key, "ssid_0"))
+        if (!strncmp(key, GESTURE_PARAM_PREFIX, strlen(GESTURE_PARAM_PREFIX)))
+        {
+            int16_t *param = gesture_param(&gesture_cfg, key + strlen(GESTURE_PARAM_PREFIX));
+            if (NULL != param)
+            {
+                snprintf(value, 32, "%d", *param);
+            }
+        }
+        else if (!strncmp(key, BACKLIGHT_PARAM_PREFIX, strlen(BACKLIGHT_PARAM_PREFIX)))
+        {
+            uint16_t *param = backlight_param(&backlight_cfg, key + strlen(BACKLIGHT_PARAM_PREFIX));
+            if (NULL != param)
+            {
+                snprintf(value, 32, "%u", *param);
+            }
+        }
+        else if (!strcmp(key, "ssid_0"))
         {
             snprintf(value, 32, "%s", sys_cfg.ssid_0.c_str());
         }
@@ -408,7 +341,23 @@ void AppController::deal_config(APP_MESSAGE_TYPE type,
         Serial.print(" = ");
         Serial.println(value);  
         
-        if (!strcmp(key, "ssid_0"))
+        if (!strncmp(key, GESTURE_PARAM_PREFIX, strlen(GESTURE_PARAM_PREFIX)))
+        {
+            int16_t *param = gesture_param(&gesture_cfg, key + strlen(GESTURE_PARAM_PREFIX));
+            if (NULL != param)
+            {
+                *param = atol(value);
+            }
+        }
+        else if (!strncmp(key, BACKLIGHT_PARAM_PREFIX, strlen(BACKLIGHT_PARAM_PREFIX)))
+        {
+            uint16_t *param = backlight_param(&backlight_cfg, key + strlen(BACKLIGHT_PARAM_PREFIX));
+            if (NULL != param)
+            {
+                *param = atol(value);
+            }
+        }
+        else if (!strcmp(key, "ssid_0"))
         {
             sys_cfg.ssid_0 = value;
         }
@@ -435,6 +384,7 @@ void AppController::deal_config(APP_MESSAGE_TYPE type,
         else if (!strcmp(key, "power_mode"))
         {
             sys_cfg.power_mode = atol(value);
+            cpu_governor_set_power_mode(sys_cfg.power_mode);
         }
         else if (!strcmp(key, "backLight"))
         {
@@ -493,6 +443,8 @@ void AppController::deal_config(APP_MESSAGE_TYPE type,
         read_config(&sys_cfg);
         // read_config(&mpu_cfg);
         read_config(&rgb_cfg);
+        read_config(&gesture_cfg);
+        read_config(&backlight_cfg);
     }
     break;
     case APP_MESSAGE_WRITE_CFG:
@@ -500,6 +452,8 @@ void AppController::deal_config(APP_MESSAGE_TYPE type,
         write_config(&sys_cfg);
         // write_config(&mpu_cfg);  // 在取消自动校准的时候已经写过一次了
         write_config(&rgb_cfg);
+        write_config(&gesture_cfg);
+        write_config(&backlight_cfg);
     }
     break;
     default:
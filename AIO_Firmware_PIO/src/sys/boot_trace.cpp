@@ -0,0 +1,71 @@
+#include "boot_trace.h"
+#include <esp_timer.h>
+
+struct BootStage
+{
+    const char *name;
+    uint32_t time_us; // 自上电起的时间
+    uint8_t core;
+};
+
+static BootStage boot_stages[BOOT_TRACE_MAX];
+static uint8_t boot_stage_num = 0;
+static bool boot_finished = false;
+static portMUX_TYPE boot_mux = portMUX_INITIALIZER_UNLOCKED;
+
+void boot_trace_mark(const char *stage)
+{
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    portENTER_CRITICAL(&boot_mux);
+    if (!boot_finished && boot_stage_num < BOOT_TRACE_MAX)
+    {
+        BootStage *cur = &boot_stages[boot_stage_num++];
+        cur->name = stage;
+        cur->time_us = now;
+        cur->core = xPortGetCoreID();
+    }
+    portEXIT_CRITICAL(&boot_mux);
+}
+
+void boot_trace_done(void)
+{
+    boot_trace_mark("ready");
+    portENTER_CRITICAL(&boot_mux);
+    boot_finished = true;
+    portEXIT_CRITICAL(&boot_mux);
+}
+
+void boot_trace_print(Print *out)
+{
+    // 完成后不再修改 未完成时也只会追加 读取前取一次数量即可
+    portENTER_CRITICAL(&boot_mux);
+    uint8_t num = boot_stage_num;
+    portEXIT_CRITICAL(&boot_mux);
+
+    // 间隔按核分别计算 两个核上并行的阶段各自显示自己的耗时
+    out->printf("%-16s %8s %8s %s\n", "stage", "at(ms)", "+(ms)", "core");
+    uint32_t prev_us[portNUM_PROCESSORS] = {0};
+    for (uint8_t pos = 0; pos < num; ++pos)
+    {
+        const BootStage *stage = &boot_stages[pos];
+        out->printf("%-16s %8.1f %8.1f %u\n", stage->name,
+                    stage->time_us / 1000.0, (stage->time_us - prev_us[stage->core]) / 1000.0,
+                    stage->core);
+        prev_us[stage->core] = stage->time_us;
+    }
+}
+
+void boot_trace_print_metrics(Print *out)
+{
+    portENTER_CRITICAL(&boot_mux);
+    uint8_t num = boot_stage_num;
+    portEXIT_CRITICAL(&boot_mux);
+
+    out->printf("# HELP aio_boot_stage_ms Time from power on to the end of each boot stage\n"
+                "# TYPE aio_boot_stage_ms gauge\n");
+    for (uint8_t pos = 0; pos < num; ++pos)
+    {
+        out->printf("aio_boot_stage_ms{stage=\"%s\"} %u\n",
+                    boot_stages[pos].name, boot_stages[pos].time_us / 1000);
+    }
+}
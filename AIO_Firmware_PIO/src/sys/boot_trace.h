@@ -0,0 +1,21 @@
+#ifndef BOOT_TRACE_H
+#define BOOT_TRACE_H
+
+#include <Arduino.h>
+
+#define BOOT_TRACE_MAX 24 // 最多记录的启动阶段数
+
+// 记录一个启动阶段的完成时间（自上电起 微秒）
+// stage需为常量字符串 可在任意任务中调用
+void boot_trace_mark(const char *stage);
+
+// 启动完成（可以开始交互） 之后的mark不再记录
+void boot_trace_done(void);
+
+// 输出启动时间线 每个阶段的完成时间、与同一个核上一阶段的间隔和执行的核
+void boot_trace_print(Print *out);
+
+// 以Prometheus文本格式输出各阶段的完成时间
+void boot_trace_print_metrics(Print *out);
+
+#endif
@@ -0,0 +1,197 @@
+#define LOG_TAG "buf"
+#include "buf_pool.h"
+#include "logger.h"
+#include <esp_heap_caps.h>
+
+#define BUF_SLOT_NUM (BUF_STRIP_NUM + BUF_DMA_SMALL_NUM)
+#define BUF_SLOT_HEAP 0x0F // 凭证中表示从堆中申请
+
+// 凭证id: 高4位为类型+1（0表示无效） 中间4位为槽位 低8位为序号（防止归还过期的凭证）
+#define BUF_ID(type, slot, gen) ((((type) + 1) << 12) | ((slot) << 8) | (gen))
+#define BUF_ID_TYPE(id) (((id) >> 12) - 1)
+#define BUF_ID_SLOT(id) (((id) >> 8) & 0x0F)
+#define BUF_ID_GEN(id) ((id)&0xFF)
+
+struct BufSlot
+{
+    uint8_t *data;
+    const char *owner; // NULL表示空闲
+    uint8_t gen;
+};
+
+static const uint32_t buf_type_size[BUF_TYPE_NUM] = {BUF_STRIP_SIZE, BUF_FRAME_SIZE, BUF_DMA_SMALL_SIZE};
+static const char *const buf_type_name[BUF_TYPE_NUM] = {"strip", "frame", "dma_small"};
+
+// 0 ~ BUF_STRIP_NUM-1为STRIP 其后为DMA_SMALL
+static BufSlot buf_slots[BUF_SLOT_NUM];
+static uint32_t buf_heap_leases = 0; // 退回到堆中申请的次数
+static portMUX_TYPE buf_mux = portMUX_INITIALIZER_UNLOCKED;
+
+void buf_pool_init(void)
+{
+    uint8_t *frame = (uint8_t *)heap_caps_malloc(BUF_FRAME_SIZE, MALLOC_CAP_DMA);
+    uint8_t *small = (uint8_t *)heap_caps_malloc(BUF_DMA_SMALL_SIZE * BUF_DMA_SMALL_NUM, MALLOC_CAP_DMA);
+    if (NULL == frame || NULL == small)
+    {
+        // 都退回到从堆中申请
+        free(frame);
+        free(small);
+        LOGE("reserve failed, leases will use the heap");
+        return;
+    }
+    for (int pos = 0; pos < BUF_STRIP_NUM; ++pos)
+    {
+        buf_slots[pos].data = frame + pos * BUF_STRIP_SIZE;
+    }
+    for (int pos = 0; pos < BUF_DMA_SMALL_NUM; ++pos)
+    {
+        buf_slots[BUF_STRIP_NUM + pos].data = small + pos * BUF_DMA_SMALL_SIZE;
+    }
+}
+
+// 找一个空闲的槽位并标记为owner所有 FRAME占用全部STRIP 返回首个槽位 没有时返回-1
+static int take_slot(BUF_TYPE type, const char *owner)
+{
+    if (BUF_FRAME == type)
+    {
+        for (int pos = 0; pos < BUF_STRIP_NUM; ++pos)
+        {
+            if (NULL == buf_slots[pos].data || NULL != buf_slots[pos].owner)
+            {
+                return -1;
+            }
+        }
+        for (int pos = 0; pos < BUF_STRIP_NUM; ++pos)
+        {
+            buf_slots[pos].owner = owner;
+        }
+        return 0;
+    }
+
+    int start = BUF_STRIP == type ? 0 : BUF_STRIP_NUM;
+    int end = BUF_STRIP == type ? BUF_STRIP_NUM : BUF_SLOT_NUM;
+    for (int pos = start; pos < end; ++pos)
+    {
+        if (NULL != buf_slots[pos].data && NULL == buf_slots[pos].owner)
+        {
+            buf_slots[pos].owner = owner;
+            return pos;
+        }
+    }
+    return -1;
+}
+
+uint8_t *buf_lease(BufLease *lease, BUF_TYPE type, const char *owner)
+{
+    lease->data = NULL;
+    lease->size = 0;
+    lease->id = 0;
+    if (type >= BUF_TYPE_NUM)
+    {
+        return NULL;
+    }
+
+    portENTER_CRITICAL(&buf_mux);
+    int slot = take_slot(type, owner);
+    if (slot >= 0)
+    {
+        BufSlot *cur = &buf_slots[slot];
+        ++cur->gen;
+        lease->data = cur->data;
+        lease->id = BUF_ID(type, slot, cur->gen);
+    }
+    portEXIT_CRITICAL(&buf_mux);
+
+    if (slot < 0)
+    {
+        lease->data = (uint8_t *)heap_caps_malloc(buf_type_size[type], MALLOC_CAP_DMA);
+        if (NULL == lease->data)
+        {
+            LOGE("%s: no %s buffer", owner, buf_type_name[type]);
+            return NULL;
+        }
+        lease->id = BUF_ID(type, BUF_SLOT_HEAP, 0);
+        ++buf_heap_leases;
+        LOGW("%s: pool busy, %s from heap", owner, buf_type_name[type]);
+    }
+    lease->size = buf_type_size[type];
+    return lease->data;
+}
+
+void buf_return(BufLease *lease, const char *owner)
+{
+    if (NULL == lease->data || 0 == lease->id)
+    {
+        return;
+    }
+
+    int type = BUF_ID_TYPE(lease->id);
+    int slot = BUF_ID_SLOT(lease->id);
+    if (BUF_SLOT_HEAP == slot)
+    {
+        free(lease->data);
+        lease->data = NULL;
+        lease->id = 0;
+        return;
+    }
+
+    bool ok = false;
+    portENTER_CRITICAL(&buf_mux);
+    BufSlot *cur = slot < BUF_SLOT_NUM ? &buf_slots[slot] : NULL;
+    if (NULL != cur && cur->data == lease->data && cur->gen == BUF_ID_GEN(lease->id) &&
+        NULL != cur->owner && !strcmp(cur->owner, owner))
+    {
+        int num = BUF_FRAME == type ? BUF_STRIP_NUM : 1;
+        for (int pos = slot; pos < slot + num; ++pos)
+        {
+            buf_slots[pos].owner = NULL;
+        }
+        ok = true;
+    }
+    portEXIT_CRITICAL(&buf_mux);
+
+    if (!ok)
+    {
+        // 不是自己的或已过期的凭证 不归还 以免影响当前的使用者
+        LOGE("%s: bad return of %s slot %d", owner, buf_type_name[type], slot);
+        return;
+    }
+    lease->data = NULL;
+    lease->id = 0;
+}
+
+int buf_pool_leased(void)
+{
+    int num = 0;
+    portENTER_CRITICAL(&buf_mux);
+    for (int pos = 0; pos < BUF_SLOT_NUM; ++pos)
+    {
+        if (NULL != buf_slots[pos].owner)
+        {
+            ++num;
+        }
+    }
+    portEXIT_CRITICAL(&buf_mux);
+    return num;
+}
+
+void buf_pool_print(Print *out)
+{
+    BufSlot slots[BUF_SLOT_NUM];
+    portENTER_CRITICAL(&buf_mux);
+    memcpy(slots, buf_slots, sizeof(slots));
+    portEXIT_CRITICAL(&buf_mux);
+
+    if (NULL == slots[0].data)
+    {
+        out->println(F("pool not reserved, all leases use the heap"));
+    }
+    for (int pos = 0; pos < BUF_SLOT_NUM; ++pos)
+    {
+        out->printf("%-10s %u bytes  %s\n",
+                    pos < BUF_STRIP_NUM ? buf_type_name[BUF_STRIP] : buf_type_name[BUF_DMA_SMALL],
+                    pos < BUF_STRIP_NUM ? BUF_STRIP_SIZE : BUF_DMA_SMALL_SIZE,
+                    NULL != slots[pos].owner ? slots[pos].owner : "-");
+    }
+    out->printf("heap fallbacks: %u\n", buf_heap_leases);
+}
@@ -0,0 +1,53 @@
+#ifndef BUF_POOL_H
+#define BUF_POOL_H
+
+#include <Arduino.h>
+
+/*
+ * 大块缓冲区与DMA缓冲区的共用池
+ * 开机时一次性申请（此时堆还没有碎片） 之后由各APP租借、归还 不再反复malloc/free
+ * 两块STRIP在内存中连续 同时空闲时可以合起来作为一块FRAME租借
+ * 池中没有空闲的块（或开机时申请失败）时 退回到从堆中申请 保证功能可用
+ * 池的大小按各APP必需的缓冲区确定（解码器、图片推送、投屏） 图片预取这类
+ * 内存充足时才进行的缓冲不在池中（见picture_prefetch.cpp）
+ */
+
+#define BUF_STRIP_SIZE 28800 // 240*60的RGB565 四分之一屏
+#define BUF_STRIP_NUM 2
+#define BUF_FRAME_SIZE (BUF_STRIP_SIZE * BUF_STRIP_NUM) // 240*240 8位色的整屏
+#define BUF_DMA_SMALL_SIZE 512 // JPEG解码时一个MCU块的RGB565（16*16*2）
+#define BUF_DMA_SMALL_NUM 4
+
+// 所有的块都可用于DMA
+enum BUF_TYPE : uint8_t
+{
+    BUF_STRIP = 0,
+    BUF_FRAME,
+    BUF_DMA_SMALL,
+
+    BUF_TYPE_NUM
+};
+
+// 租借凭证 归还时校验类型、租借者与是否已归还
+struct BufLease
+{
+    uint8_t *data; // 未租到或已归还时为NULL
+    uint32_t size;
+    uint16_t id; // 内部使用
+};
+
+// 开机时尽早调用
+void buf_pool_init(void);
+
+// owner需为常量字符串 失败时返回NULL
+uint8_t *buf_lease(BufLease *lease, BUF_TYPE type, const char *owner);
+
+// 可以重复调用 未租到或已归还时不做任何事
+void buf_return(BufLease *lease, const char *owner);
+
+// 当前被租借的块数（不含从堆中申请的）
+int buf_pool_leased(void);
+
+void buf_pool_print(Print *out);
+
+#endif
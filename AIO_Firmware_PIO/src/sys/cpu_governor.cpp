@@ -0,0 +1,211 @@
+#define LOG_TAG "cpu"
+#include "cpu_governor.h"
+#include "logger.h"
+#include "common.h"
+
+struct GovernorRequest
+{
+    const char *owner; // NULL表示空闲
+    PERF_LEVEL level;
+    bool idle_scale;
+};
+
+static const uint32_t level_mhz[PERF_LEVEL_NUM] = {80, 160, 240};
+
+static GovernorRequest gov_requests[GOVERNOR_OWNER_MAX];
+static uint8_t gov_power_mode = 0;
+static PERF_LEVEL gov_level = PERF_LEVEL_HIGH; // 当前档位
+static unsigned long gov_activity_time = 0;    // 最近一次用户操作
+static unsigned long gov_down_since = 0;       // 开始满足降频条件的时间 0表示未满足
+static uint32_t gov_need_mhz = 0;              // 帧耗时换算的所需主频（滤波后）
+static unsigned long gov_frame_time = 0;       // 最近一次上报帧耗时
+static portMUX_TYPE gov_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static PERF_LEVEL governor_target(unsigned long now)
+{
+    if (1 == gov_power_mode)
+    {
+        return PERF_LEVEL_HIGH;
+    }
+
+    unsigned long idle = now - gov_activity_time;
+    uint8_t idle_steps = idle >= GOVERNOR_IDLE_STEP2_MS ? 2 : (idle >= GOVERNOR_IDLE_STEP_MS ? 1 : 0);
+    int target = PERF_LEVEL_LOW;
+    for (int pos = 0; pos < GOVERNOR_OWNER_MAX; ++pos)
+    {
+        const GovernorRequest *req = &gov_requests[pos];
+        if (NULL == req->owner)
+        {
+            continue;
+        }
+        int level = req->level - (req->idle_scale ? idle_steps : 0);
+        target = max(target, level);
+    }
+
+    // 帧耗时有余量时 取满足帧率的最低档（降档与保持当前档的阈值不同 形成滞回）
+    if (0 != gov_need_mhz && now - gov_frame_time < GOVERNOR_FRAME_TIMEOUT_MS)
+    {
+        int frame_level = PERF_LEVEL_LOW;
+        while (frame_level < PERF_LEVEL_HIGH)
+        {
+            uint32_t limit = frame_level < gov_level ? GOVERNOR_LOAD_DOWN : GOVERNOR_LOAD_UP;
+            if (gov_need_mhz * 100 <= level_mhz[frame_level] * limit)
+            {
+                break;
+            }
+            ++frame_level;
+        }
+        target = min(target, frame_level);
+    }
+    return (PERF_LEVEL)max(target, (int)PERF_LEVEL_LOW);
+}
+
+static void governor_update(void)
+{
+    unsigned long now = GET_SYS_MILLIS();
+    bool change = false;
+    portENTER_CRITICAL(&gov_mux);
+    PERF_LEVEL target = governor_target(now);
+    if (target > gov_level)
+    {
+        change = true;
+    }
+    else if (target < gov_level)
+    {
+        if (0 == gov_down_since)
+        {
+            gov_down_since = now;
+        }
+        else if (now - gov_down_since >= GOVERNOR_DOWN_HOLD_MS)
+        {
+            change = true;
+        }
+    }
+    else
+    {
+        gov_down_since = 0;
+    }
+    if (change)
+    {
+        gov_level = target;
+        gov_down_since = 0;
+    }
+    portEXIT_CRITICAL(&gov_mux);
+
+    if (change)
+    {
+        setCpuFrequencyMhz(level_mhz[target]);
+        LOGI("CpuFrequencyMhz: %u", getCpuFrequencyMhz());
+    }
+}
+
+void cpu_governor_init(uint8_t power_mode)
+{
+    gov_power_mode = power_mode;
+    gov_activity_time = GET_SYS_MILLIS();
+    // 按当前状态直接设置一次 不等待降频延迟
+    gov_level = governor_target(gov_activity_time);
+    setCpuFrequencyMhz(level_mhz[gov_level]);
+    LOGI("CpuFrequencyMhz: %u", getCpuFrequencyMhz());
+}
+
+void cpu_governor_set_power_mode(uint8_t power_mode)
+{
+    gov_power_mode = power_mode;
+    governor_update();
+}
+
+void cpu_governor_request(const char *owner, PERF_LEVEL level, bool idle_scale)
+{
+    portENTER_CRITICAL(&gov_mux);
+    GovernorRequest *slot = NULL;
+    for (int pos = 0; pos < GOVERNOR_OWNER_MAX; ++pos)
+    {
+        GovernorRequest *req = &gov_requests[pos];
+        if (NULL != req->owner && !strcmp(req->owner, owner))
+        {
+            slot = req;
+            break;
+        }
+        if (NULL == req->owner && NULL == slot)
+        {
+            slot = req;
+        }
+    }
+    if (NULL != slot)
+    {
+        slot->owner = owner;
+        slot->level = level;
+        slot->idle_scale = idle_scale;
+    }
+    // 声明新的需求时 重新开始计算无操作时间与帧余量
+    gov_activity_time = GET_SYS_MILLIS();
+    gov_need_mhz = 0;
+    portEXIT_CRITICAL(&gov_mux);
+
+    if (NULL == slot)
+    {
+        LOGW("too many requests, %s ignored", owner);
+    }
+    governor_update();
+}
+
+void cpu_governor_release(const char *owner)
+{
+    portENTER_CRITICAL(&gov_mux);
+    for (int pos = 0; pos < GOVERNOR_OWNER_MAX; ++pos)
+    {
+        GovernorRequest *req = &gov_requests[pos];
+        if (NULL != req->owner && !strcmp(req->owner, owner))
+        {
+            req->owner = NULL;
+        }
+    }
+    gov_need_mhz = 0;
+    portEXIT_CRITICAL(&gov_mux);
+    governor_update();
+}
+
+void cpu_governor_activity(void)
+{
+    portENTER_CRITICAL(&gov_mux);
+    gov_activity_time = GET_SYS_MILLIS();
+    portEXIT_CRITICAL(&gov_mux);
+    governor_update();
+}
+
+void cpu_governor_frame(uint32_t cost_ms, uint32_t interval_ms)
+{
+    if (0 == interval_ms)
+    {
+        return;
+    }
+    // 换算为在当前主频下刚好用满帧间隔所需的主频 再做低通滤波
+    uint32_t need = cost_ms * getCpuFrequencyMhz() / interval_ms;
+    portENTER_CRITICAL(&gov_mux);
+    gov_need_mhz = 0 == gov_need_mhz ? need : (gov_need_mhz * 7 + need) / 8;
+    gov_frame_time = GET_SYS_MILLIS();
+    portEXIT_CRITICAL(&gov_mux);
+}
+
+void cpu_governor_routine(void)
+{
+    governor_update();
+}
+
+void cpu_governor_print(Print *out)
+{
+    unsigned long now = GET_SYS_MILLIS();
+    out->printf("freq %uMHz level %u power_mode %u idle %lus need %uMHz\n",
+                getCpuFrequencyMhz(), gov_level, gov_power_mode,
+                (now - gov_activity_time) / 1000, gov_need_mhz);
+    for (int pos = 0; pos < GOVERNOR_OWNER_MAX; ++pos)
+    {
+        const GovernorRequest *req = &gov_requests[pos];
+        if (NULL != req->owner)
+        {
+            out->printf("  %-16s level %u%s\n", req->owner, req->level,
+                        req->idle_scale ? " (idle scale)" : "");
+        }
+    }
+}
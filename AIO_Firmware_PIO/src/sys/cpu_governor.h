@@ -0,0 +1,50 @@
+#ifndef CPU_GOVERNOR_H
+#define CPU_GOVERNOR_H
+
+#include <Arduino.h>
+
+/*
+ * CPU主频统一由这里设置 APP只声明需要的性能等级
+ * 最终主频取所有声明中的最高档 再根据用户是否在操作、帧耗时的余量降低
+ * 升频立即生效 降频需持续GOVERNOR_DOWN_HOLD_MS 避免来回切换
+ */
+
+// 性能等级（对应的主频见cpu_governor.cpp）
+enum PERF_LEVEL : uint8_t
+{
+    PERF_LEVEL_LOW = 0, // 80MHz 静止的界面
+    PERF_LEVEL_MID,     // 160MHz
+    PERF_LEVEL_HIGH,    // 240MHz 视频、游戏等
+
+    PERF_LEVEL_NUM
+};
+
+#define GOVERNOR_OWNER_MAX 4             // 最多同时声明性能需求的模块数
+#define GOVERNOR_IDLE_STEP_MS 90000UL    // 无操作超过该时间降一档（仅限允许降档的声明）
+#define GOVERNOR_IDLE_STEP2_MS 120000UL  // 无操作超过该时间再降一档
+#define GOVERNOR_DOWN_HOLD_MS 3000UL     // 降频需要持续满足的时间
+#define GOVERNOR_FRAME_TIMEOUT_MS 1000UL // 超过该时间没有上报帧耗时 不再参考帧余量
+#define GOVERNOR_LOAD_DOWN 75            // 降档后预计的帧耗时占比（%）低于此值才降档
+#define GOVERNOR_LOAD_UP 90              // 当前档位的帧耗时占比（%）高于此值则升档
+
+// power_mode与sys_cfg.power_mode一致 1为性能模式 始终使用最高主频
+void cpu_governor_init(uint8_t power_mode);
+void cpu_governor_set_power_mode(uint8_t power_mode);
+
+// 声明或更新性能需求 owner需为常量字符串（一般为APP名 退出APP时自动撤销）
+// idle_scale为true时 用户长时间无操作会逐档降低
+void cpu_governor_request(const char *owner, PERF_LEVEL level, bool idle_scale = true);
+void cpu_governor_release(const char *owner);
+
+// 用户有操作 恢复因无操作而降低的档位
+void cpu_governor_activity(void);
+
+// 上报一帧的处理耗时与帧间隔（ms） 余量充足时可以用低于声明的档位
+void cpu_governor_frame(uint32_t cost_ms, uint32_t interval_ms);
+
+// 在主循环中调用 处理延迟的降频
+void cpu_governor_routine(void);
+
+void cpu_governor_print(Print *out);
+
+#endif
@@ -0,0 +1,241 @@
+#define LOG_TAG "heap"
+#include "heap_monitor.h"
+#include "metrics.h"
+#include "logger.h"
+#include <esp_attr.h>
+#include <esp_system.h>
+#include <esp_heap_caps.h>
+
+#define HEAP_HISTORY_MAGIC 0x4E4F4D48 // "HMON"
+#define HEAP_NAME_LEN 16
+
+struct HeapSample
+{
+    uint32_t uptime; // s
+    uint32_t free_8bit;
+    uint32_t largest_8bit;
+    uint32_t free_dma;
+    uint32_t largest_dma;
+    uint16_t stack_min; // 栈剩余最少的任务的剩余量
+    uint16_t boot;      // 第几次软复位后的记录
+    uint8_t alarms;
+    char task[HEAP_NAME_LEN - 1]; // 栈剩余最少的任务
+    char app[HEAP_NAME_LEN];      // 前台APP
+};
+
+// 保存在RTC内存中 软复位后不会被清除（上电时内容随机 由magic判断是否有效）
+struct HeapHistory
+{
+    uint32_t magic;
+    uint16_t boot; // 上电以来的软复位次数
+    uint8_t head;  // 下一条记录的位置
+    uint8_t count;
+    HeapSample samples[HEAP_HISTORY_MAX];
+};
+
+static RTC_NOINIT_ATTR HeapHistory heap_history;
+static esp_reset_reason_t heap_reset_reason = ESP_RST_UNKNOWN;
+static const char *volatile heap_app = NULL;
+static uint8_t heap_alarms = 0;
+static portMUX_TYPE heap_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static void take_sample(HeapSample *sample)
+{
+    memset(sample, 0, sizeof(HeapSample));
+    sample->uptime = millis() / 1000;
+    sample->free_8bit = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    sample->largest_8bit = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    sample->free_dma = heap_caps_get_free_size(MALLOC_CAP_DMA);
+    sample->largest_dma = heap_caps_get_largest_free_block(MALLOC_CAP_DMA);
+    sample->boot = heap_history.boot;
+
+    sample->stack_min = 0xFFFF;
+#if METRICS_ENABLE
+    const char *names[METRICS_TASK_MAX];
+    uint32_t stack_free[METRICS_TASK_MAX];
+    int num = metrics_sample_tasks(names, stack_free, METRICS_TASK_MAX);
+    for (int pos = 0; pos < num; ++pos)
+    {
+        if (stack_free[pos] < sample->stack_min)
+        {
+            sample->stack_min = stack_free[pos];
+            strncpy(sample->task, names[pos], sizeof(sample->task) - 1);
+        }
+    }
+#endif
+
+    const char *app = heap_app;
+    strncpy(sample->app, NULL != app ? app : "menu", sizeof(sample->app) - 1);
+
+    if (sample->free_8bit < HEAP_ALARM_FREE_BYTES)
+    {
+        sample->alarms |= HEAP_ALARM_FREE;
+    }
+    if (sample->largest_8bit < HEAP_ALARM_BLOCK_BYTES)
+    {
+        sample->alarms |= HEAP_ALARM_BLOCK;
+    }
+    if (sample->largest_dma < HEAP_ALARM_DMA_BYTES)
+    {
+        sample->alarms |= HEAP_ALARM_DMA;
+    }
+    if (sample->stack_min < HEAP_ALARM_STACK_BYTES)
+    {
+        sample->alarms |= HEAP_ALARM_STACK;
+    }
+}
+
+static void record_sample(const HeapSample *sample)
+{
+    portENTER_CRITICAL(&heap_mux);
+    memcpy(&heap_history.samples[heap_history.head], sample, sizeof(HeapSample));
+    heap_history.head = (heap_history.head + 1) % HEAP_HISTORY_MAX;
+    if (heap_history.count < HEAP_HISTORY_MAX)
+    {
+        ++heap_history.count;
+    }
+    portEXIT_CRITICAL(&heap_mux);
+}
+
+static void TaskHeapMonitor(void *parameter)
+{
+    uint32_t last_record = 0;
+    bool recorded = false;
+    for (;;)
+    {
+        HeapSample sample;
+        take_sample(&sample);
+
+        uint8_t raised = sample.alarms & ~heap_alarms;
+        heap_alarms = sample.alarms;
+        if (raised)
+        {
+            LOGW("alarm 0x%02x in %s: free %u block %u dma block %u stack %u (%s)",
+                 raised, sample.app, sample.free_8bit, sample.largest_8bit,
+                 sample.largest_dma, sample.stack_min, sample.task);
+        }
+
+        uint32_t now = millis();
+        if (raised || !recorded || now - last_record >= HEAP_MONITOR_RECORD_MS)
+        {
+            record_sample(&sample);
+            last_record = now;
+            recorded = true;
+        }
+        vTaskDelay(HEAP_MONITOR_PERIOD_MS / portTICK_PERIOD_MS);
+    }
+}
+
+static const char *reset_reason_name(esp_reset_reason_t reason)
+{
+    switch (reason)
+    {
+    case ESP_RST_POWERON:
+        return "power on";
+    case ESP_RST_SW:
+        return "restart";
+    case ESP_RST_PANIC:
+        return "panic";
+    case ESP_RST_INT_WDT:
+        return "interrupt wdt";
+    case ESP_RST_TASK_WDT:
+        return "task wdt";
+    case ESP_RST_WDT:
+        return "wdt";
+    case ESP_RST_DEEPSLEEP:
+        return "deep sleep";
+    case ESP_RST_BROWNOUT:
+        return "brownout";
+    default:
+        return "unknown";
+    }
+}
+
+void heap_monitor_init(void)
+{
+    heap_reset_reason = esp_reset_reason();
+    if (HEAP_HISTORY_MAGIC != heap_history.magic || ESP_RST_POWERON == heap_reset_reason ||
+        heap_history.head >= HEAP_HISTORY_MAX || heap_history.count > HEAP_HISTORY_MAX)
+    {
+        memset(&heap_history, 0, sizeof(heap_history));
+        heap_history.magic = HEAP_HISTORY_MAGIC;
+    }
+    else
+    {
+        ++heap_history.boot;
+        if (heap_history.count > 0)
+        {
+            // 软复位前的最后一条记录 便于定位崩溃原因
+            const HeapSample *last = &heap_history.samples[(heap_history.head + HEAP_HISTORY_MAX - 1) % HEAP_HISTORY_MAX];
+            LOGW("reset by %s, last sample at %us in %.*s: free %u block %u alarms 0x%02x",
+                 reset_reason_name(heap_reset_reason), last->uptime,
+                 HEAP_NAME_LEN, last->app, last->free_8bit, last->largest_8bit, last->alarms);
+        }
+    }
+
+    TaskHandle_t task = NULL;
+    if (pdPASS != xTaskCreatePinnedToCore(TaskHeapMonitor, "HeapMonitor", 3 * 1024,
+                                          NULL, 1, &task, 0))
+    {
+        LOGE("task create failed");
+        return;
+    }
+    METRIC_WATCH_TASK("HeapMonitor", task);
+}
+
+void heap_monitor_set_app(const char *name)
+{
+    heap_app = name;
+}
+
+uint8_t heap_monitor_alarms(void)
+{
+    return heap_alarms;
+}
+
+void heap_monitor_print(Print *out)
+{
+    out->printf("reset by %s, %u soft resets since power on, alarms 0x%02x\n",
+                reset_reason_name(heap_reset_reason), heap_history.boot, heap_alarms);
+    out->printf("%4s %7s %7s %7s %7s %7s %6s %-15s %-16s %s\n", "boot", "up(s)", "free", "block",
+                "dma", "dma_blk", "stack", "task", "app", "alarms");
+
+    portENTER_CRITICAL(&heap_mux);
+    uint8_t num = heap_history.count;
+    uint8_t start = (heap_history.head + HEAP_HISTORY_MAX - num) % HEAP_HISTORY_MAX;
+    portEXIT_CRITICAL(&heap_mux);
+
+    for (uint8_t pos = 0; pos < num; ++pos)
+    {
+        HeapSample sample;
+        portENTER_CRITICAL(&heap_mux);
+        memcpy(&sample, &heap_history.samples[(start + pos) % HEAP_HISTORY_MAX], sizeof(HeapSample));
+        portEXIT_CRITICAL(&heap_mux);
+
+        // 记录可能来自崩溃前 字符串不一定完整
+        out->printf("%4u %7u %7u %7u %7u %7u %6u %-15.*s %-16.*s 0x%02x\n", sample.boot, sample.uptime,
+                    sample.free_8bit, sample.largest_8bit, sample.free_dma, sample.largest_dma,
+                    sample.stack_min, (int)sizeof(sample.task), sample.task,
+                    (int)sizeof(sample.app), sample.app, sample.alarms);
+    }
+}
+
+void heap_monitor_print_metrics(Print *out)
+{
+    out->printf("# HELP aio_heap_dma_free_bytes Free DMA capable heap\n"
+                "# TYPE aio_heap_dma_free_bytes gauge\n"
+                "aio_heap_dma_free_bytes %u\n",
+                heap_caps_get_free_size(MALLOC_CAP_DMA));
+    out->printf("# HELP aio_heap_dma_largest_block_bytes Largest allocatable DMA capable block\n"
+                "# TYPE aio_heap_dma_largest_block_bytes gauge\n"
+                "aio_heap_dma_largest_block_bytes %u\n",
+                heap_caps_get_largest_free_block(MALLOC_CAP_DMA));
+    out->printf("# HELP aio_heap_alarms Heap and stack alarm flags\n"
+                "# TYPE aio_heap_alarms gauge\n"
+                "aio_heap_alarms %u\n",
+                heap_alarms);
+    out->printf("# HELP aio_soft_resets Soft resets since power on\n"
+                "# TYPE aio_soft_resets gauge\n"
+                "aio_soft_resets %u\n",
+                heap_history.boot);
+}
@@ -0,0 +1,42 @@
+#ifndef HEAP_MONITOR_H
+#define HEAP_MONITOR_H
+
+#include <Arduino.h>
+
+/*
+ * 内存碎片与任务栈的监控
+ * 定时采样8位内存与DMA内存的剩余量、最大可分配块以及被监控任务（见metrics_watch_task）的栈剩余量
+ * 超过阈值时置告警标志 采样记录保存在RTC内存中 软复位（崩溃、看门狗、重启）后仍可查看
+ */
+
+#define HEAP_MONITOR_PERIOD_MS 5000UL     // 采样间隔
+#define HEAP_MONITOR_RECORD_MS 60000UL    // 记录到历史中的间隔（出现新的告警时立即记录）
+#define HEAP_HISTORY_MAX 32               // 保存的记录条数
+
+#define HEAP_ALARM_FREE_BYTES (24 * 1024) // 8位内存剩余量低于此值告警
+#define HEAP_ALARM_BLOCK_BYTES (10 * 1024) // 8位内存最大可分配块低于此值告警（碎片）
+#define HEAP_ALARM_DMA_BYTES (4 * 1024)   // DMA内存最大可分配块低于此值告警
+#define HEAP_ALARM_STACK_BYTES 512        // 任一任务栈剩余量低于此值告警
+
+// 告警标志
+#define HEAP_ALARM_FREE 0x01
+#define HEAP_ALARM_BLOCK 0x02
+#define HEAP_ALARM_DMA 0x04
+#define HEAP_ALARM_STACK 0x08
+
+// 开机时调用 检查上一次的记录并启动监控任务
+void heap_monitor_init(void);
+
+// 记录当前前台的APP 告警时一并保存 name需为常量字符串 NULL表示在菜单中
+void heap_monitor_set_app(const char *name);
+
+// 当前的告警标志（HEAP_ALARM_*的组合）
+uint8_t heap_monitor_alarms(void);
+
+// 输出历史记录（包括软复位之前的）
+void heap_monitor_print(Print *out);
+
+// 以Prometheus文本格式输出DMA内存与告警状态
+void heap_monitor_print_metrics(Print *out);
+
+#endif
@@ -0,0 +1,97 @@
+#include "logger.h"
+#include "metrics.h"
+#include <freertos/ringbuf.h>
+#include <stdarg.h>
+
+static const char log_level_char[] = "-EWIDV";
+
+static RingbufHandle_t log_ring = NULL;
+static uint32_t log_dropped = 0; // 缓冲区满时丢弃的条数
+static portMUX_TYPE log_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static void TaskLogOutput(void *parameter)
+{
+    for (;;)
+    {
+        size_t len = 0;
+        uint8_t *item = (uint8_t *)xRingbufferReceive(log_ring, &len, portMAX_DELAY);
+        if (NULL != item)
+        {
+            Serial.write(item, len);
+            vRingbufferReturnItem(log_ring, item);
+        }
+
+        portENTER_CRITICAL(&log_mux);
+        uint32_t dropped = log_dropped;
+        log_dropped = 0;
+        portEXIT_CRITICAL(&log_mux);
+        if (dropped > 0)
+        {
+            Serial.printf("[log] %u lines dropped\n", dropped);
+        }
+    }
+}
+
+void logger_init(void)
+{
+    if (NULL != log_ring)
+    {
+        return;
+    }
+    RingbufHandle_t ring = xRingbufferCreate(LOG_BUFFER_SIZE, RINGBUF_TYPE_NOSPLIT);
+    if (NULL == ring)
+    {
+        Serial.println(F("[log] ring buffer alloc failed, logging synchronously"));
+        return;
+    }
+    log_ring = ring;
+    // 优先级最低 只在空闲时输出
+    TaskHandle_t task = NULL;
+    if (pdPASS != xTaskCreatePinnedToCore(TaskLogOutput, "LogOutput", 2 * 1024,
+                                          NULL, 1, &task, 0))
+    {
+        log_ring = NULL;
+        vRingbufferDelete(ring);
+        Serial.println(F("[log] task create failed, logging synchronously"));
+        return;
+    }
+    METRIC_WATCH_TASK("LogOutput", task);
+}
+
+void logger_write(uint8_t level, const char *tag, const char *fmt, ...)
+{
+    char line[LOG_LINE_MAX];
+    int len = snprintf(line, sizeof(line), "[%u][%c][%s] ",
+                       (uint32_t)millis(), log_level_char[level], tag);
+
+    va_list args;
+    va_start(args, fmt);
+    int body_len = vsnprintf(line + len, sizeof(line) - len, fmt, args);
+    va_end(args);
+    if (body_len > 0)
+    {
+        len += body_len;
+    }
+
+    // 截断时保留换行的位置
+    if (len > (int)sizeof(line) - 2)
+    {
+        len = sizeof(line) - 2;
+    }
+    if ('\n' != line[len - 1])
+    {
+        line[len++] = '\n';
+    }
+
+    if (NULL == log_ring)
+    {
+        Serial.write((const uint8_t *)line, len);
+        return;
+    }
+    if (pdTRUE != xRingbufferSend(log_ring, line, len, 0))
+    {
+        portENTER_CRITICAL(&log_mux);
+        ++log_dropped;
+        portEXIT_CRITICAL(&log_mux);
+    }
+}
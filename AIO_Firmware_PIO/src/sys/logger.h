@@ -0,0 +1,65 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <Arduino.h>
+
+/*
+ * 异步日志
+ * 格式化后放入环形缓冲区 由低优先级任务写到串口 调用者不会等待串口
+ * 缓冲区满时丢弃新的日志（之后会输出丢弃的条数）
+ *
+ * 用法：在模块的.cpp中先定义LOG_TAG（以及可选的LOG_LEVEL）再包含本文件
+ *     #define LOG_TAG "ctrl"
+ *     #define LOG_LEVEL LOG_LEVEL_DEBUG
+ *     #include "sys/logger.h"
+ *     LOGI("free heap %u", esp_get_free_heap_size());
+ * 高于LOG_LEVEL的日志在编译时去掉 参数也不会被求值
+ * 不能在中断中使用
+ */
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+#define LOG_LEVEL_VERBOSE 5
+
+// 未单独指定等级的模块使用的等级 可在build_flags中用-D修改
+#ifndef LOG_LEVEL_DEFAULT
+#define LOG_LEVEL_DEFAULT LOG_LEVEL_INFO
+#endif
+
+#ifndef LOG_TAG
+#define LOG_TAG "aio"
+#endif
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_DEFAULT
+#endif
+
+#define LOG_BUFFER_SIZE 4096 // 环形缓冲区大小
+#define LOG_LINE_MAX 160     // 一条日志的最大长度（含前缀） 超出部分截断
+
+// 创建缓冲区与输出任务 之前的日志直接同步写到串口
+void logger_init(void);
+
+// 格式化一条日志 末尾没有换行时自动补上
+void logger_write(uint8_t level, const char *tag, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#define LOG_PRINT(level, fmt, ...)                                    \
+    do                                                                \
+    {                                                                 \
+        if ((level) <= LOG_LEVEL)                                     \
+        {                                                             \
+            logger_write(level, LOG_TAG, fmt, ##__VA_ARGS__);         \
+        }                                                             \
+    } while (0)
+
+#define LOGE(fmt, ...) LOG_PRINT(LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define LOGW(fmt, ...) LOG_PRINT(LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#define LOGI(fmt, ...) LOG_PRINT(LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#define LOGD(fmt, ...) LOG_PRINT(LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#define LOGV(fmt, ...) LOG_PRINT(LOG_LEVEL_VERBOSE, fmt, ##__VA_ARGS__)
+
+#endif
@@ -0,0 +1,26 @@
+#include "loop_wake.h"
+
+static TaskHandle_t loop_task = NULL;
+
+void loop_wake_init(void)
+{
+    loop_task = xTaskGetCurrentTaskHandle();
+}
+
+void loop_wake(void)
+{
+    if (NULL != loop_task)
+    {
+        xTaskNotifyGive(loop_task);
+    }
+}
+
+void loop_wake_wait(uint32_t timeout_ms)
+{
+    if (timeout_ms > LOOP_WAIT_MAX)
+    {
+        timeout_ms = LOOP_WAIT_MAX;
+    }
+    // 超时为0时只清除已有的通知 不休眠
+    ulTaskNotifyTake(pdTRUE, timeout_ms / portTICK_PERIOD_MS);
+}
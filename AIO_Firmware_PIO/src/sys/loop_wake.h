@@ -0,0 +1,24 @@
+#ifndef LOOP_WAKE_H
+#define LOOP_WAKE_H
+
+#include <Arduino.h>
+
+/*
+ * 主循环的唤醒
+ * 主循环处理完一轮后调用loop_wake_wait休眠 有动作、消息等事件时由产生事件的一方唤醒
+ * 基于任务通知 多次唤醒会合并为一次
+ */
+
+#define LOOP_WAIT_FOREVER 0xFFFFFFFFUL // 没有需要定时处理的事情
+#define LOOP_WAIT_MAX 100UL            // 最长休眠时间 ms（串口命令、配置延迟写入等仍是轮询）
+
+// 在主循环所在的任务中调用一次
+void loop_wake_init(void);
+
+// 唤醒主循环 可在任意任务中调用（不能在中断中调用）
+void loop_wake(void);
+
+// 休眠直到被唤醒或超过timeout_ms（不超过LOOP_WAIT_MAX）
+void loop_wake_wait(uint32_t timeout_ms);
+
+#endif
@@ -0,0 +1,264 @@
+#include "metrics.h"
+
+#if METRICS_ENABLE
+
+#include "common.h"
+#include "boot_trace.h"
+#include "heap_monitor.h"
+#include <esp_system.h>
+#include <esp_heap_caps.h>
+
+#define METRIC_BUCKET_MAX 8 // 直方图最多的分桶数（不含+Inf）
+
+enum METRIC_TYPE
+{
+    METRIC_TYPE_COUNTER = 0,
+    METRIC_TYPE_GAUGE,
+    METRIC_TYPE_HISTOGRAM
+};
+
+struct MetricDef
+{
+    const char *name;
+    const char *help;
+    METRIC_TYPE type;
+    const uint32_t *buckets; // 直方图各桶的上界（升序）
+    uint8_t bucket_num;
+};
+
+struct MetricValue
+{
+    int64_t value; // 计数器的值、gauge的值或直方图的总和
+    uint32_t count;
+    uint32_t buckets[METRIC_BUCKET_MAX + 1];
+};
+
+struct MetricTask
+{
+    const char *name;
+    TaskHandle_t task;
+};
+
+static const uint32_t flush_us_buckets[] = {500, 1000, 2000, 5000, 10000, 20000, 50000};
+static const uint32_t decode_ms_buckets[] = {5, 10, 20, 33, 50, 100, 200};
+static const uint32_t http_ms_buckets[] = {5, 20, 50, 100, 500, 1000, 5000};
+static const uint32_t wifi_ms_buckets[] = {500, 1000, 2000, 5000, 10000, 20000};
+
+#define METRIC_COUNTER(name, help) {name, help, METRIC_TYPE_COUNTER, NULL, 0}
+#define METRIC_GAUGE(name, help) {name, help, METRIC_TYPE_GAUGE, NULL, 0}
+#define METRIC_HISTOGRAM(name, help, buckets) \
+    {name, help, METRIC_TYPE_HISTOGRAM, buckets, sizeof(buckets) / sizeof(buckets[0])}
+
+// 顺序与METRIC_ID一致
+static const MetricDef metric_defs[METRIC_NUM] = {
+    METRIC_HISTOGRAM("aio_lvgl_flush_us", "LVGL flush time in microseconds", flush_us_buckets),
+    METRIC_COUNTER("aio_frames_rendered_total", "Video and screen share frames drawn"),
+    METRIC_COUNTER("aio_frames_dropped_total", "Video and screen share frames dropped"),
+    METRIC_HISTOGRAM("aio_media_decode_ms", "Media player read and decode time per frame", decode_ms_buckets),
+    METRIC_HISTOGRAM("aio_screen_share_decode_ms", "Screen share decode time per frame", decode_ms_buckets),
+    METRIC_COUNTER("aio_sd_read_bytes_total", "Bytes read from the SD card"),
+    METRIC_HISTOGRAM("aio_http_request_ms", "Web request handling time", http_ms_buckets),
+    METRIC_HISTOGRAM("aio_wifi_connect_ms", "Time from WiFi.begin to got IP", wifi_ms_buckets),
+    METRIC_GAUGE("aio_event_queue_depth", "Pending AppController events"),
+};
+
+static MetricValue metric_values[METRIC_NUM];
+static MetricTask metric_tasks[METRICS_TASK_MAX];
+static portMUX_TYPE metric_mux = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t task_samplers = 0; // 正在读取任务栈的采样者数
+
+void metrics_inc(METRIC_ID id, uint32_t num)
+{
+    portENTER_CRITICAL(&metric_mux);
+    metric_values[id].value += num;
+    portEXIT_CRITICAL(&metric_mux);
+}
+
+void metrics_set(METRIC_ID id, int32_t value)
+{
+    portENTER_CRITICAL(&metric_mux);
+    metric_values[id].value = value;
+    portEXIT_CRITICAL(&metric_mux);
+}
+
+void metrics_observe(METRIC_ID id, uint32_t value)
+{
+    const MetricDef *def = &metric_defs[id];
+    uint8_t pos = 0;
+    while (pos < def->bucket_num && value > def->buckets[pos])
+    {
+        ++pos;
+    }
+
+    portENTER_CRITICAL(&metric_mux);
+    MetricValue *metric = &metric_values[id];
+    metric->value += value;
+    ++metric->count;
+    ++metric->buckets[pos];
+    portEXIT_CRITICAL(&metric_mux);
+}
+
+void metrics_watch_task(const char *name, TaskHandle_t task)
+{
+    if (NULL == task)
+    {
+        return;
+    }
+    portENTER_CRITICAL(&metric_mux);
+    for (int pos = 0; pos < METRICS_TASK_MAX; ++pos)
+    {
+        if (NULL == metric_tasks[pos].task || task == metric_tasks[pos].task)
+        {
+            metric_tasks[pos].name = name;
+            metric_tasks[pos].task = task;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&metric_mux);
+}
+
+void metrics_unwatch_task(TaskHandle_t task)
+{
+    portENTER_CRITICAL(&metric_mux);
+    for (int pos = 0; pos < METRICS_TASK_MAX; ++pos)
+    {
+        if (task == metric_tasks[pos].task)
+        {
+            metric_tasks[pos].task = NULL;
+        }
+    }
+    portEXIT_CRITICAL(&metric_mux);
+
+    // 等待正在进行的采样结束（可能还在读取该任务的栈） 之后才能删除任务
+    while (true)
+    {
+        portENTER_CRITICAL(&metric_mux);
+        bool sampling = task_samplers > 0;
+        portEXIT_CRITICAL(&metric_mux);
+        if (!sampling)
+        {
+            break;
+        }
+        vTaskDelay(1);
+    }
+}
+
+int metrics_sample_tasks(const char **names, uint32_t *stack_free, int max)
+{
+    int num = 0;
+    TaskHandle_t tasks[METRICS_TASK_MAX];
+    // 锁内只拷贝任务句柄 遍历任务栈较慢 放在锁外进行
+    // task_samplers不为0时metrics_unwatch_task会等待 期间被监控的任务不会被删除
+    portENTER_CRITICAL(&metric_mux);
+    for (int pos = 0; pos < METRICS_TASK_MAX && num < max; ++pos)
+    {
+        if (NULL != metric_tasks[pos].task)
+        {
+            names[num] = metric_tasks[pos].name;
+            tasks[num] = metric_tasks[pos].task;
+            ++num;
+        }
+    }
+    ++task_samplers;
+    portEXIT_CRITICAL(&metric_mux);
+
+    for (int pos = 0; pos < num; ++pos)
+    {
+        stack_free[pos] = uxTaskGetStackHighWaterMark(tasks[pos]);
+    }
+
+    portENTER_CRITICAL(&metric_mux);
+    --task_samplers;
+    portEXIT_CRITICAL(&metric_mux);
+    return num;
+}
+
+static void print_header(Print *out, const char *name, const char *help, const char *type)
+{
+    out->printf("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+void metrics_print(Print *out)
+{
+    // 先拷贝一份 输出期间不持有锁
+    static MetricValue snapshot[METRIC_NUM];
+    portENTER_CRITICAL(&metric_mux);
+    memcpy(snapshot, metric_values, sizeof(snapshot));
+    portEXIT_CRITICAL(&metric_mux);
+
+    for (int id = 0; id < METRIC_NUM; ++id)
+    {
+        const MetricDef *def = &metric_defs[id];
+        const MetricValue *metric = &snapshot[id];
+        switch (def->type)
+        {
+        case METRIC_TYPE_COUNTER:
+            print_header(out, def->name, def->help, "counter");
+            out->printf("%s %llu\n", def->name, (unsigned long long)metric->value);
+            break;
+        case METRIC_TYPE_GAUGE:
+            print_header(out, def->name, def->help, "gauge");
+            out->printf("%s %lld\n", def->name, (long long)metric->value);
+            break;
+        case METRIC_TYPE_HISTOGRAM:
+        {
+            print_header(out, def->name, def->help, "histogram");
+            uint32_t total = 0;
+            for (int pos = 0; pos < def->bucket_num; ++pos)
+            {
+                total += metric->buckets[pos];
+                out->printf("%s_bucket{le=\"%u\"} %u\n", def->name, def->buckets[pos], total);
+            }
+            out->printf("%s_bucket{le=\"+Inf\"} %u\n", def->name, metric->count);
+            out->printf("%s_sum %lld\n", def->name, (long long)metric->value);
+            out->printf("%s_count %u\n", def->name, metric->count);
+        }
+        break;
+        default:
+            break;
+        }
+    }
+
+    // 以下在输出时采样
+    print_header(out, "aio_heap_free_bytes", "Free heap", "gauge");
+    out->printf("aio_heap_free_bytes %u\n", esp_get_free_heap_size());
+    print_header(out, "aio_heap_min_free_bytes", "Lowest free heap since boot", "gauge");
+    out->printf("aio_heap_min_free_bytes %u\n", esp_get_minimum_free_heap_size());
+    print_header(out, "aio_heap_largest_block_bytes", "Largest allocatable heap block", "gauge");
+    out->printf("aio_heap_largest_block_bytes %u\n",
+                heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+#if LV_MEM_CUSTOM == 0
+    // LVGL独立内存池的使用情况（遍历内存池 需持有LVGL的锁）
+    lv_mem_monitor_t lv_mon;
+    memset(&lv_mon, 0, sizeof(lv_mon));
+    AIO_LVGL_OPERATE_LOCK(lv_mem_monitor(&lv_mon);)
+    print_header(out, "aio_lvgl_mem_used_bytes", "LVGL pool bytes in use", "gauge");
+    out->printf("aio_lvgl_mem_used_bytes %u\n", lv_mon.total_size - lv_mon.free_size);
+    print_header(out, "aio_lvgl_mem_max_used_bytes", "LVGL pool peak usage since boot", "gauge");
+    out->printf("aio_lvgl_mem_max_used_bytes %u\n", lv_mon.max_used);
+    print_header(out, "aio_lvgl_mem_largest_block_bytes", "Largest free block in the LVGL pool", "gauge");
+    out->printf("aio_lvgl_mem_largest_block_bytes %u\n", lv_mon.free_biggest_size);
+    print_header(out, "aio_lvgl_mem_frag_percent", "LVGL pool fragmentation", "gauge");
+    out->printf("aio_lvgl_mem_frag_percent %u\n", lv_mon.frag_pct);
+#endif
+    print_header(out, "aio_cfg_flash_writes_total", "Config store flash writes since boot", "counter");
+    out->printf("aio_cfg_flash_writes_total %u\n", g_cfgStore.getFlashWrites());
+    print_header(out, "aio_uptime_seconds", "Time since boot", "counter");
+    out->printf("aio_uptime_seconds %u\n", (uint32_t)(millis() / 1000));
+
+    boot_trace_print_metrics(out);
+
+    heap_monitor_print_metrics(out);
+
+    const char *names[METRICS_TASK_MAX];
+    uint32_t stack_free[METRICS_TASK_MAX];
+    int num = metrics_sample_tasks(names, stack_free, METRICS_TASK_MAX);
+
+    print_header(out, "aio_task_stack_free_bytes", "Task stack high-water mark", "gauge");
+    for (int pos = 0; pos < num; ++pos)
+    {
+        out->printf("aio_task_stack_free_bytes{task=\"%s\"} %u\n", names[pos], stack_free[pos]);
+    }
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+
+// 设置为0时所有METRIC_*宏都为空 不占用任何内存和时间
+#define METRICS_ENABLE 1
+
+#define METRICS_TASK_MAX 8 // 最多监控的任务数（栈剩余量）
+
+enum METRIC_ID
+{
+    METRIC_LVGL_FLUSH_US = 0,   // LVGL刷屏耗时
+    METRIC_FRAMES_RENDERED,     // 视频/投屏显示的帧数
+    METRIC_FRAMES_DROPPED,      // 视频/投屏丢弃的帧数
+    METRIC_MEDIA_DECODE_MS,     // 视频播放每帧的读取+解码耗时
+    METRIC_SCREEN_DECODE_MS,    // 屏幕分享每帧的解码耗时
+    METRIC_SD_READ_BYTES,       // 从SD卡读取的字节数
+    METRIC_HTTP_REQUEST_MS,     // web请求的处理耗时
+    METRIC_WIFI_CONNECT_MS,     // 从发起连接到获得IP的耗时
+    METRIC_EVENT_QUEUE_DEPTH,   // AppController的事件队列长度
+
+    METRIC_NUM
+};
+
+#if METRICS_ENABLE
+
+void metrics_inc(METRIC_ID id, uint32_t num);
+void metrics_set(METRIC_ID id, int32_t value);
+void metrics_observe(METRIC_ID id, uint32_t value);
+
+// 监控任务的栈剩余量 任务删除前需要取消监控（会等待进行中的采样结束 不能在中断中调用）
+void metrics_watch_task(const char *name, TaskHandle_t task);
+void metrics_unwatch_task(TaskHandle_t task);
+
+// 采样被监控任务的栈剩余量（字节） 返回任务数
+int metrics_sample_tasks(const char **names, uint32_t *stack_free, int max);
+
+// 以Prometheus文本格式输出全部指标（内存与任务栈在输出时采样）
+void metrics_print(Print *out);
+
+#define METRIC_INC(id) metrics_inc(id, 1)
+#define METRIC_ADD(id, num) metrics_inc(id, num)
+#define METRIC_SET(id, value) metrics_set(id, value)
+#define METRIC_OBSERVE(id, value) metrics_observe(id, value)
+#define METRIC_WATCH_TASK(name, task) metrics_watch_task(name, task)
+#define METRIC_UNWATCH_TASK(task) metrics_unwatch_task(task)
+// 计时 start与end需要在同一个作用域中
+#define METRIC_TIME_START(var) uint32_t var = micros()
+#define METRIC_TIME_END_US(id, var) metrics_observe(id, micros() - (var))
+#define METRIC_TIME_END_MS(id, var) metrics_observe(id, (micros() - (var)) / 1000)
+
+#else
+
+#define METRIC_INC(id) ((void)0)
+#define METRIC_ADD(id, num) ((void)0)
+#define METRIC_SET(id, value) ((void)0)
+#define METRIC_OBSERVE(id, value) ((void)0)
+#define METRIC_WATCH_TASK(name, task) ((void)0)
+#define METRIC_UNWATCH_TASK(task) ((void)0)
+#define METRIC_TIME_START(var) ((void)0)
+#define METRIC_TIME_END_US(id, var) ((void)0)
+#define METRIC_TIME_END_MS(id, var) ((void)0)
+
+#endif
+
+#endif
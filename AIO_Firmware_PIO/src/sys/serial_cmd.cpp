@@ -0,0 +1,94 @@
+#include "serial_cmd.h"
+
+struct SerialCmd
+{
+    const char *name;
+    serial_cmd_cb_t cb;
+    const char *help;
+};
+
+static SerialCmd cmd_list[SERIAL_CMD_MAX];
+static uint8_t cmd_num = 0;
+static char line_buf[SERIAL_CMD_LINE_LEN];
+static uint8_t line_len = 0;
+
+bool serial_cmd_register(const char *name, serial_cmd_cb_t cb, const char *help)
+{
+    if (cmd_num >= SERIAL_CMD_MAX)
+    {
+        return false;
+    }
+    cmd_list[cmd_num].name = name;
+    cmd_list[cmd_num].cb = cb;
+    cmd_list[cmd_num].help = help;
+    ++cmd_num;
+    return true;
+}
+
+static void execute(char *line)
+{
+    char *args = line;
+    while ('\0' != *args && ' ' != *args)
+    {
+        ++args;
+    }
+    if ('\0' != *args)
+    {
+        *args++ = '\0';
+        while (' ' == *args)
+        {
+            ++args;
+        }
+    }
+
+    if (!strcmp(line, "help"))
+    {
+        for (uint8_t pos = 0; pos < cmd_num; ++pos)
+        {
+            Serial.printf("%-12s %s\n", cmd_list[pos].name, cmd_list[pos].help);
+        }
+        return;
+    }
+    for (uint8_t pos = 0; pos < cmd_num; ++pos)
+    {
+        if (!strcmp(line, cmd_list[pos].name))
+        {
+            cmd_list[pos].cb(args);
+            return;
+        }
+    }
+    Serial.printf("Unknown command: %s (try \"help\")\n", line);
+}
+
+void serial_cmd_poll(void)
+{
+    while (Serial.available())
+    {
+        int ch = Serial.peek();
+        if (0 == line_len)
+        {
+            if ('\r' == ch || '\n' == ch || ' ' == ch)
+            {
+                Serial.read(); // 上一行剩下的换行
+                continue;
+            }
+            if (ch < 'a' || ch > 'z')
+            {
+                return; // 不是命令 留给其他使用者
+            }
+        }
+        Serial.read();
+
+        if ('\r' == ch || '\n' == ch)
+        {
+            line_buf[line_len] = '\0';
+            line_len = 0;
+            execute(line_buf);
+            continue;
+        }
+        if (line_len < SERIAL_CMD_LINE_LEN - 1)
+        {
+            line_buf[line_len++] = ch;
+        }
+    }
+}
@@ -0,0 +1,19 @@
+#ifndef SERIAL_CMD_H
+#define SERIAL_CMD_H
+
+#include <Arduino.h>
+
+#define SERIAL_CMD_MAX 12     // 最多可注册的命令数
+#define SERIAL_CMD_LINE_LEN 64 // 一行命令的最大长度
+
+// args为命令名之后的内容（已去掉前导空格） 没有参数时为""
+typedef void (*serial_cmd_cb_t)(const char *args);
+
+// 注册串口命令 输入"help"列出全部命令
+bool serial_cmd_register(const char *name, serial_cmd_cb_t cb, const char *help);
+
+// 在主循环中调用 读取一行并执行
+// 只在行首为小写字母时读取 以免抢走设置APP等使用的二进制数据
+void serial_cmd_poll(void);
+
+#endif
@@ -0,0 +1,897 @@
+#ifndef GESTURE_TRACES_H
+#define GESTURE_TRACES_H
+
+// 用于回放测试的样本 格式与imu_trace的输出一致（IMU,时间,ax,ay,az,gx,gy,gz）
+// LABEL,时间,动作 为人工标注的动作起始时间 一个动作可能有多个预期事件（如前后倾的短按与长按）
+// 样本由脚本合成: 静止时az约为1g 倾斜时对应轴在100ms内升到约0.43g 并带有随机噪声
+
+static const char trace_tilts[] = R"TRACE(
+IMU,10,62,129,16454,-6,157,-61
+IMU,20,-94,-98,16354,102,-28,27
+IMU,30,95,54,16372,-61,133,82
+IMU,40,-54,114,16430,-71,-24,123
+IMU,50,-44,42,16502,-128,72,-32
+IMU,60,55,118,16287,-4,-73,-175
+IMU,70,-145,-20,16411,-195,-41,172
+IMU,80,-143,150,16520,40,-65,163
+IMU,90,-137,85,16446,54,2,121
+IMU,100,8,39,16400,171,-173,-121
+IMU,110,-138,117,16524,-73,90,60
+IMU,120,40,144,16241,21,-132,-88
+IMU,130,-139,98,16530,172,-52,-131
+IMU,140,101,-54,16531,-174,-5,-98
+IMU,150,95,-133,16491,168,154,-136
+IMU,160,-24,-46,16320,-189,198,-102
+IMU,170,91,-142,16324,145,-27,-10
+IMU,180,67,6,16350,-85,108,93
+IMU,190,123,69,16239,109,-99,-156
+IMU,200,28,7,16467,-19,-155,-5
+IMU,210,-137,-141,16330,-112,-157,164
+IMU,220,34,-40,16468,43,-71,-115
+IMU,230,-65,20,16292,-150,90,164
+IMU,240,-125,11,16346,68,-136,-192
+IMU,250,-50,99,16409,74,-190,-8
+IMU,260,-44,-131,16306,-194,-19,151
+IMU,270,-57,-74,16430,186,-184,140
+IMU,280,139,31,16525,76,-13,-143
+IMU,290,50,-136,16442,-62,98,-64
+IMU,300,69,-138,16274,-94,-63,-99
+IMU,310,-87,44,16500,190,49,181
+IMU,320,-131,118,16502,-105,-8,-52
+IMU,330,43,146,16378,144,-36,-78
+IMU,340,81,-2,16506,92,-132,-172
+IMU,350,89,81,16349,5,-178,152
+IMU,360,-109,-111,16368,136,173,-17
+IMU,370,-28,125,16307,-3,127,-166
+IMU,380,96,120,16487,-135,155,53
+IMU,390,82,-145,16440,-14,-57,-6
+IMU,400,107,27,16500,156,75,-183
+IMU,410,110,101,16415,-173,180,40
+IMU,420,17,-116,16465,91,103,-93
+IMU,430,-140,-88,16493,-54,-170,-99
+IMU,440,-59,120,16529,-168,122,-51
+IMU,450,47,148,16270,-22,-84,127
+IMU,460,-123,30,16439,89,68,-177
+IMU,470,3,-8,16472,39,11,-127
+IMU,480,19,119,16251,-91,-132,-161
+IMU,490,26,96,16296,157,194,-145
+IMU,500,-142,114,16376,109,98,197
+LABEL,510,TURN_LEFT
+IMU,510,-58,-90,15902,2997,-175,-116
+IMU,520,119,646,16026,3011,127,-134
+IMU,530,44,1456,15934,2836,64,107
+IMU,540,-63,2143,15880,3088,46,-119
+IMU,550,-109,2938,16003,3186,-124,46
+IMU,560,-89,3563,16030,3110,-134,-109
+IMU,570,-7,4310,16059,2852,-80,152
+IMU,580,11,4828,15913,2859,61,-7
+IMU,590,-7,5744,16050,3032,-129,-180
+IMU,600,-23,6292,16100,3131,-180,39
+IMU,610,132,7003,16041,138,38,-29
+IMU,620,-91,7128,15900,121,-37,-79
+IMU,630,11,6988,16016,125,190,139
+IMU,640,-93,6893,15898,-9,-186,-200
+IMU,650,84,7041,15972,112,-108,-156
+IMU,660,133,6903,16015,2869,162,31
+IMU,670,-109,6378,15973,3089,79,168
+IMU,680,-65,5453,15894,3033,-74,-141
+IMU,690,72,4947,15860,2825,73,42
+IMU,700,-24,4090,15970,3125,40,-187
+IMU,710,-135,3571,16106,2948,50,183
+IMU,720,95,2773,16049,3181,-49,58
+IMU,730,134,2021,16084,3049,-117,150
+IMU,740,-70,1359,16024,2828,173,178
+IMU,750,28,593,16109,2846,174,-74
+IMU,760,70,-84,16529,110,-138,50
+IMU,770,-137,64,16258,-156,10,-120
+IMU,780,17,147,16355,139,-98,-118
+IMU,790,-106,62,16449,-164,-117,-56
+IMU,800,-36,115,16468,68,67,59
+IMU,810,90,141,16429,-119,113,25
+IMU,820,104,84,16297,-152,129,74
+IMU,830,150,-94,16286,-117,119,-29
+IMU,840,-39,-124,16264,163,111,-152
+IMU,850,-117,70,16314,109,-116,-18
+IMU,860,100,-64,16391,-38,4,-18
+IMU,870,-85,58,16523,-101,28,3
+IMU,880,-42,-150,16458,118,54,-56
+IMU,890,-52,8,16308,7,-59,-63
+IMU,900,137,-2,16284,-169,4,-43
+IMU,910,-43,86,16332,-154,-62,-17
+IMU,920,-63,104,16359,-175,39,-169
+IMU,930,35,140,16473,70,147,55
+IMU,940,-76,44,16379,-22,-41,-116
+IMU,950,119,43,16354,163,-24,-44
+IMU,960,-138,97,16437,-107,166,-105
+IMU,970,52,-122,16382,-100,93,-151
+IMU,980,-7,31,16524,111,190,-189
+IMU,990,91,-129,16321,37,48,-37
+IMU,1000,14,-82,16420,-31,-95,-27
+IMU,1010,-112,-127,16350,12,-77,-196
+IMU,1020,67,-32,16394,12,73,64
+IMU,1030,59,57,16279,118,-168,114
+IMU,1040,-1,128,16446,-67,112,12
+IMU,1050,-66,-134,16481,-48,-67,80
+IMU,1060,-139,-19,16398,19,-103,-174
+IMU,1070,83,-5,16433,161,-12,182
+IMU,1080,-107,2,16281,-40,-119,68
+IMU,1090,124,117,16311,130,184,-24
+IMU,1100,-77,140,16315,-27,111,195
+IMU,1110,-46,64,16471,-128,101,-115
+IMU,1120,-129,-110,16276,-117,191,117
+IMU,1130,11,-133,16379,-34,19,-58
+IMU,1140,-56,140,16516,-53,111,20
+IMU,1150,-6,-103,16479,-68,-82,184
+IMU,1160,106,-78,16502,157,166,81
+IMU,1170,128,31,16267,-68,182,195
+IMU,1180,-45,40,16415,-51,-116,117
+IMU,1190,-27,-27,16478,-192,-57,-16
+IMU,1200,-42,26,16364,-26,93,141
+IMU,1210,-126,-127,16394,-92,139,-49
+IMU,1220,-94,-93,16251,95,-84,43
+IMU,1230,-36,99,16246,153,-69,84
+IMU,1240,50,-52,16255,113,152,-12
+IMU,1250,37,9,16315,48,-104,-67
+IMU,1260,-72,69,16507,48,129,-103
+IMU,1270,-68,108,16425,61,-198,-59
+IMU,1280,-44,-114,16383,-84,180,111
+IMU,1290,-61,96,16376,-180,-28,-156
+IMU,1300,18,-135,16293,20,181,111
+IMU,1310,-101,64,16495,-68,167,190
+IMU,1320,143,121,16327,-17,142,164
+IMU,1330,-22,-105,16532,175,73,173
+IMU,1340,-37,-134,16437,129,-75,-3
+IMU,1350,-9,-82,16502,-43,-84,55
+LABEL,1360,TURN_RIGHT
+IMU,1360,-77,-95,15953,-3132,32,-156
+IMU,1370,134,-670,16020,-2865,186,-122
+IMU,1380,146,-1409,15998,-2847,101,154
+IMU,1390,-31,-1975,15861,-2942,-21,151
+IMU,1400,-142,-2781,15969,-2818,6,-126
+IMU,1410,117,-3445,15885,-3062,82,-177
+IMU,1420,-77,-4070,16045,-2847,88,-161
+IMU,1430,91,-4841,16078,-3105,30,-150
+IMU,1440,-24,-5685,15874,-2976,-163,64
+IMU,1450,-6,-6272,16094,-3160,146,-95
+IMU,1460,-103,-6920,16024,-37,-137,167
+IMU,1470,101,-6902,15994,-74,-21,-36
+IMU,1480,27,-6916,15935,23,-86,-79
+IMU,1490,147,-6857,16066,116,-4,40
+IMU,1500,-140,-6869,15893,169,-69,197
+IMU,1510,105,-7049,15975,-3052,166,-7
+IMU,1520,-73,-6384,15912,-2948,104,-91
+IMU,1530,-91,-5736,15878,-3147,-186,-22
+IMU,1540,20,-4940,15872,-3161,140,196
+IMU,1550,-28,-4147,16039,-2962,74,106
+IMU,1560,-28,-3520,15916,-2818,159,44
+IMU,1570,138,-2729,15972,-2887,50,-194
+IMU,1580,-89,-2165,16107,-2918,185,158
+IMU,1590,25,-1295,16014,-2968,8,-162
+IMU,1600,87,-654,15930,-3154,27,16
+IMU,1610,-87,106,16332,-53,82,155
+IMU,1620,37,-33,16447,-200,200,33
+IMU,1630,104,131,16355,-125,54,-120
+IMU,1640,8,22,16259,-50,31,-148
+IMU,1650,25,-72,16276,168,-47,-40
+IMU,1660,87,-126,16336,40,87,97
+IMU,1670,-137,-65,16525,-181,182,110
+IMU,1680,-103,148,16483,-50,187,-44
+IMU,1690,-119,81,16414,-170,-140,48
+IMU,1700,-106,-44,16529,65,98,-105
+IMU,1710,56,65,16440,-111,-185,-47
+IMU,1720,84,-114,16484,-119,9,-96
+IMU,1730,-144,-50,16500,-190,59,123
+IMU,1740,118,62,16534,-199,119,133
+IMU,1750,139,-17,16420,-110,1,-25
+IMU,1760,38,87,16520,13,151,-140
+IMU,1770,-131,-104,16433,-176,-92,158
+IMU,1780,-143,26,16376,-18,97,-137
+IMU,1790,19,-105,16274,176,166,192
+IMU,1800,128,-115,16387,28,-130,-91
+IMU,1810,86,-117,16409,-41,132,-150
+IMU,1820,-49,59,16497,104,-175,-104
+IMU,1830,-75,134,16296,-65,167,-167
+IMU,1840,108,-25,16492,15,-175,78
+IMU,1850,-138,61,16251,195,180,-107
+IMU,1860,102,-15,16482,165,-93,197
+IMU,1870,-89,-6,16281,-120,-120,160
+IMU,1880,86,82,16497,185,-31,-48
+IMU,1890,14,111,16524,-77,7,-180
+IMU,1900,-12,50,16330,-151,185,-174
+IMU,1910,144,-16,16285,-94,-32,29
+IMU,1920,-74,85,16401,-148,-31,-184
+IMU,1930,-34,46,16369,46,-172,-40
+IMU,1940,55,121,16398,-144,-180,-63
+IMU,1950,-33,-125,16354,95,147,87
+IMU,1960,-126,61,16300,128,5,-103
+IMU,1970,36,65,16443,9,141,-183
+IMU,1980,33,106,16523,-53,84,-44
+IMU,1990,-95,-88,16390,-33,127,-109
+IMU,2000,25,-82,16381,161,51,-107
+IMU,2010,100,62,16512,37,-59,-18
+IMU,2020,-105,-32,16434,119,58,-49
+IMU,2030,-64,125,16450,-195,-198,-55
+IMU,2040,14,-103,16390,-70,-137,102
+IMU,2050,133,-1,16293,124,87,-44
+IMU,2060,86,-45,16439,-120,-148,-174
+IMU,2070,108,-52,16371,6,181,86
+IMU,2080,-8,127,16492,-63,-145,-43
+IMU,2090,91,-76,16326,75,86,125
+IMU,2100,42,128,16346,35,158,42
+IMU,2110,125,-94,16333,136,33,-92
+IMU,2120,132,-124,16253,129,-162,-125
+IMU,2130,-85,6,16468,126,102,195
+IMU,2140,-16,-99,16414,-126,66,-146
+IMU,2150,-124,39,16294,132,17,-91
+IMU,2160,-136,-120,16463,-18,33,75
+IMU,2170,121,-81,16325,-80,63,-192
+IMU,2180,150,88,16334,6,-39,-191
+IMU,2190,-62,93,16419,113,-26,-26
+IMU,2200,99,57,16372,38,56,-25
+LABEL,2210,UP
+IMU,2210,68,-63,15937,102,3131,176
+IMU,2220,798,146,16014,-98,2841,-99
+IMU,2230,1509,19,15890,151,2913,-70
+IMU,2240,2022,-114,16051,-134,2849,-119
+IMU,2250,2714,-71,15898,192,3164,-14
+IMU,2260,3503,139,15952,-191,3163,55
+IMU,2270,4227,25,15885,-109,2918,-158
+IMU,2280,4929,48,16076,-9,3187,-99
+IMU,2290,5544,19,16033,-120,2812,-169
+IMU,2300,6274,-102,15916,-112,3079,132
+IMU,2310,7069,-120,16033,-47,105,-170
+IMU,2320,6934,8,16024,64,173,-198
+IMU,2330,6887,44,16088,-85,48,184
+IMU,2340,7059,-57,15933,150,23,-143
+IMU,2350,7030,36,15999,-170,-137,101
+IMU,2360,7068,-80,15977,163,142,-153
+IMU,2370,7059,24,16132,-109,-135,24
+IMU,2380,6979,4,16097,-160,47,164
+IMU,2390,7031,-110,15929,-173,99,-9
+IMU,2400,6898,80,15896,-99,95,-159
+IMU,2410,6888,-65,15980,112,167,196
+IMU,2420,6892,-43,15985,-11,175,198
+IMU,2430,6916,119,16059,-29,173,-80
+IMU,2440,7091,-119,16006,192,5,-114
+IMU,2450,7030,40,15988,61,-90,132
+IMU,2460,7044,-141,16062,164,3006,146
+IMU,2470,6423,109,15951,155,2988,170
+IMU,2480,5589,-16,16012,17,3065,1
+IMU,2490,4844,-28,16138,37,2875,-1
+IMU,2500,4339,46,16014,-156,3080,-57
+IMU,2510,3483,44,15922,-14,2869,60
+IMU,2520,2893,88,15896,-33,2855,-7
+IMU,2530,2025,-115,15995,-93,2966,-37
+IMU,2540,1506,29,15958,-63,3013,16
+IMU,2550,718,58,15942,123,2946,-77
+IMU,2560,98,-140,16235,57,-71,16
+IMU,2570,50,-107,16491,-105,94,-188
+IMU,2580,-114,4,16275,173,-73,200
+IMU,2590,45,-121,16252,148,-49,-129
+IMU,2600,136,71,16272,-94,-193,-5
+IMU,2610,108,82,16258,-55,-128,107
+IMU,2620,55,-85,16298,-8,-2,144
+IMU,2630,-17,-56,16347,113,-59,-60
+IMU,2640,29,132,16413,115,-192,103
+IMU,2650,-32,70,16244,136,37,-100
+IMU,2660,23,-27,16375,-98,163,187
+IMU,2670,129,108,16273,188,-24,-24
+IMU,2680,-10,-52,16363,-151,-56,-188
+IMU,2690,23,-28,16259,-37,94,136
+IMU,2700,125,80,16270,-12,-122,-177
+IMU,2710,-31,-130,16471,-97,-151,172
+IMU,2720,43,70,16467,65,-79,37
+IMU,2730,67,81,16379,165,-16,50
+IMU,2740,79,-138,16371,94,149,62
+IMU,2750,70,-52,16469,83,-115,70
+IMU,2760,80,150,16243,174,-80,-155
+IMU,2770,100,87,16246,28,-130,-170
+IMU,2780,-62,-41,16386,-109,-37,136
+IMU,2790,-146,111,16322,185,-104,0
+IMU,2800,-1,-87,16404,-162,-31,12
+IMU,2810,-31,-24,16454,-67,119,-78
+IMU,2820,118,-35,16380,-39,-195,-112
+IMU,2830,4,120,16439,115,117,73
+IMU,2840,-77,80,16349,-112,168,14
+IMU,2850,39,115,16450,108,131,-35
+IMU,2860,-49,33,16286,179,12,41
+IMU,2870,43,-125,16527,35,79,153
+IMU,2880,51,140,16296,-117,-94,190
+IMU,2890,-9,-49,16439,32,171,-90
+IMU,2900,-115,79,16354,168,125,-52
+IMU,2910,9,-33,16381,-90,192,-139
+IMU,2920,-68,-9,16297,-33,-64,-146
+IMU,2930,109,-130,16503,-88,-176,-70
+IMU,2940,46,-104,16472,-104,4,149
+IMU,2950,-100,33,16500,-74,-157,-149
+IMU,2960,39,-70,16472,-123,198,68
+IMU,2970,-10,109,16357,187,1,35
+IMU,2980,-2,76,16277,-97,-136,75
+IMU,2990,103,-127,16279,-45,-191,91
+IMU,3000,-50,150,16436,25,-84,105
+IMU,3010,141,17,16390,7,-1,-63
+IMU,3020,125,77,16444,-153,178,195
+IMU,3030,-45,125,16343,-109,163,36
+IMU,3040,135,91,16307,-195,151,31
+IMU,3050,106,-65,16277,154,154,77
+IMU,3060,-8,16,16505,-184,136,185
+IMU,3070,-115,-68,16350,90,163,36
+IMU,3080,100,-44,16285,-132,-48,147
+IMU,3090,21,27,16238,200,-87,96
+IMU,3100,1,0,16300,141,200,-28
+IMU,3110,-11,-63,16237,-53,195,-105
+IMU,3120,-16,122,16526,-17,-43,-192
+IMU,3130,56,62,16460,-185,-69,108
+IMU,3140,11,-77,16463,110,-29,-174
+IMU,3150,-120,15,16389,-105,-24,124
+LABEL,3160,DOWN
+LABEL,3160,RETURN
+IMU,3160,74,114,16147,-46,-2825,-82
+IMU,3170,-767,60,16129,-111,-2830,146
+IMU,3180,-1300,15,16146,-77,-2958,-136
+IMU,3190,-2170,-131,15954,45,-3168,127
+IMU,3200,-2848,-67,16053,-13,-2812,-120
+IMU,3210,-3572,-60,15912,-106,-2872,41
+IMU,3220,-4195,-102,15953,126,-2962,-86
+IMU,3230,-4919,-61,15873,62,-3124,-118
+IMU,3240,-5668,146,15934,140,-2868,192
+IMU,3250,-6295,-75,15925,200,-2936,25
+IMU,3260,-7005,-45,15916,-198,23,140
+IMU,3270,-7052,2,15932,56,-72,-23
+IMU,3280,-7034,-32,15999,61,124,44
+IMU,3290,-6974,56,16076,11,51,54
+IMU,3300,-7078,-59,15984,152,-121,22
+IMU,3310,-6854,141,16000,-98,-4,-145
+IMU,3320,-7007,-83,15912,33,-115,-132
+IMU,3330,-7050,-47,16115,0,26,-35
+IMU,3340,-6994,14,15877,-167,121,-44
+IMU,3350,-7001,-136,16020,195,78,-117
+IMU,3360,-6891,-34,15948,-63,-165,-199
+IMU,3370,-7091,-101,15858,-165,-146,29
+IMU,3380,-7049,-84,16063,134,-191,-30
+IMU,3390,-7114,87,15919,-7,160,134
+IMU,3400,-7024,100,15878,179,124,-34
+IMU,3410,-6987,13,15885,39,25,151
+IMU,3420,-6909,-140,16148,-169,-95,-107
+IMU,3430,-7136,-44,16002,169,-28,41
+IMU,3440,-6938,-64,16037,-49,-142,19
+IMU,3450,-7009,37,16018,-128,142,-60
+IMU,3460,-7133,-25,16071,26,119,176
+IMU,3470,-6931,150,15917,-58,-148,-59
+IMU,3480,-7150,95,16121,154,-197,-32
+IMU,3490,-6939,-69,16038,-53,46,-168
+IMU,3500,-7110,-94,16110,50,-3,157
+IMU,3510,-7149,115,16114,-108,19,136
+IMU,3520,-6898,76,16065,-173,71,185
+IMU,3530,-6920,-127,15973,103,190,-52
+IMU,3540,-7124,23,15928,-4,-196,75
+IMU,3550,-7051,-27,16125,-24,152,22
+IMU,3560,-7127,-103,15910,45,-138,101
+IMU,3570,-7021,113,16130,-66,-197,-141
+IMU,3580,-7129,-21,15904,76,145,-127
+IMU,3590,-7069,132,16032,128,-143,-52
+IMU,3600,-7109,85,16139,-98,-120,105
+IMU,3610,-6925,79,15943,-30,-121,-159
+IMU,3620,-7045,137,16035,-26,68,-36
+IMU,3630,-7025,143,16113,-166,132,-65
+IMU,3640,-7063,20,15900,35,170,11
+IMU,3650,-6985,5,15968,-172,129,193
+IMU,3660,-6978,-113,16026,16,139,24
+IMU,3670,-7116,-74,16018,144,-148,31
+IMU,3680,-6924,-10,16116,-90,-136,-146
+IMU,3690,-6893,-51,15995,-70,29,-105
+IMU,3700,-6951,36,16063,40,99,41
+IMU,3710,-6925,-150,16133,-116,141,-104
+IMU,3720,-6939,-94,16013,-48,149,98
+IMU,3730,-7079,124,16103,119,-191,0
+IMU,3740,-7059,-111,15912,-26,-112,-99
+IMU,3750,-6851,111,15913,-153,-173,59
+IMU,3760,-6927,60,16096,25,30,-56
+IMU,3770,-7116,32,16036,-17,34,168
+IMU,3780,-7038,0,15854,-64,-46,63
+IMU,3790,-7050,20,15913,52,-195,-37
+IMU,3800,-7014,-146,16089,-161,164,190
+IMU,3810,-6952,13,15971,86,-114,-29
+IMU,3820,-6962,-34,16094,74,81,79
+IMU,3830,-7096,109,15982,-193,87,88
+IMU,3840,-6930,-25,16119,-100,-110,108
+IMU,3850,-6862,-61,15857,23,90,-134
+IMU,3860,-6895,-63,16011,-36,199,171
+IMU,3870,-6974,71,16104,136,0,132
+IMU,3880,-6980,133,16027,122,-186,-106
+IMU,3890,-6911,22,15942,-139,-162,-171
+IMU,3900,-6977,133,16132,191,41,70
+IMU,3910,-7125,-23,15856,4,2,105
+IMU,3920,-7133,148,16107,184,-76,15
+IMU,3930,-7040,22,15927,-139,70,64
+IMU,3940,-6965,-96,16090,-158,54,1
+IMU,3950,-7114,87,15916,121,195,68
+IMU,3960,-6872,-150,15880,102,-2876,4
+IMU,3970,-6325,69,16058,124,-3048,29
+IMU,3980,-5451,16,16015,83,-3193,-196
+IMU,3990,-4928,71,15928,142,-3020,51
+IMU,4000,-4280,-14,15954,139,-2983,95
+IMU,4010,-3396,84,15937,195,-3071,-172
+IMU,4020,-2898,-127,15899,185,-3196,56
+IMU,4030,-2026,38,16121,-163,-2866,-34
+IMU,4040,-1322,124,16001,165,-3169,-28
+IMU,4050,-684,-89,15980,-25,-3093,-188
+IMU,4060,-40,-86,16237,-39,-80,-93
+IMU,4070,-70,67,16327,-109,-96,135
+IMU,4080,33,-130,16413,178,-26,67
+IMU,4090,123,53,16427,191,-36,29
+IMU,4100,-58,2,16421,-24,-181,-167
+IMU,4110,32,97,16323,-34,59,-9
+IMU,4120,87,148,16313,-200,128,-28
+IMU,4130,-4,-136,16518,-18,200,-38
+IMU,4140,-17,75,16305,1,6,-99
+IMU,4150,-91,-125,16431,-143,48,128
+IMU,4160,106,-84,16492,-117,144,19
+IMU,4170,-82,100,16493,-198,126,194
+IMU,4180,-30,3,16322,198,-61,179
+IMU,4190,98,8,16471,-86,-51,118
+IMU,4200,8,-137,16276,-82,-144,121
+IMU,4210,-33,-130,16481,-165,0,-51
+IMU,4220,119,105,16286,39,-199,86
+IMU,4230,-115,17,16409,38,-85,-177
+IMU,4240,-127,-106,16511,142,149,30
+IMU,4250,-121,-146,16237,46,-85,-49
+IMU,4260,123,61,16304,138,98,69
+IMU,4270,96,107,16253,167,108,46
+IMU,4280,134,127,16429,141,139,101
+IMU,4290,94,-33,16484,45,-150,-153
+IMU,4300,90,-6,16264,31,-115,-114
+IMU,4310,-5,-15,16484,-81,137,6
+IMU,4320,53,50,16406,146,-91,83
+IMU,4330,-122,30,16525,-179,98,-183
+IMU,4340,-45,-99,16256,-38,-145,-90
+IMU,4350,84,139,16308,-129,-143,95
+IMU,4360,79,27,16449,-191,159,129
+IMU,4370,143,106,16349,108,-78,-153
+IMU,4380,-68,137,16421,76,155,-87
+IMU,4390,76,17,16356,-156,1,-37
+IMU,4400,-65,71,16458,146,-171,161
+IMU,4410,17,134,16410,120,16,-128
+IMU,4420,134,-140,16335,-28,-107,142
+IMU,4430,-56,126,16399,-119,54,-10
+IMU,4440,-66,-44,16380,117,-68,69
+IMU,4450,132,121,16487,-87,-88,97
+IMU,4460,39,141,16525,147,-170,-88
+IMU,4470,-36,-86,16302,-55,151,-164
+IMU,4480,-119,-93,16434,200,-35,197
+IMU,4490,14,-57,16431,-66,-42,37
+IMU,4500,78,5,16510,-64,128,-88
+IMU,4510,-23,138,16360,-133,-73,-169
+IMU,4520,-97,78,16325,-127,93,-35
+IMU,4530,-28,-102,16238,-126,138,-77
+IMU,4540,-145,-93,16280,-105,153,-86
+IMU,4550,140,-143,16363,92,-178,-156
+IMU,4560,-38,-9,16284,86,-190,-86
+IMU,4570,7,21,16305,-6,-1,97
+IMU,4580,55,47,16305,-123,151,-60
+IMU,4590,49,-89,16339,-59,-78,80
+IMU,4600,-51,94,16342,150,-31,27
+IMU,4610,-91,-104,16369,151,-132,-143
+IMU,4620,71,-7,16268,21,21,149
+IMU,4630,-88,30,16490,-48,-57,196
+IMU,4640,58,102,16384,-128,194,-131
+IMU,4650,37,36,16522,168,114,-58
+LABEL,4660,UP
+LABEL,4660,GO_FORWORD
+IMU,4660,-125,-133,15908,22,2852,136
+IMU,4670,580,16,15907,-13,2885,52
+IMU,4680,1289,-84,15951,-29,2880,-2
+IMU,4690,2020,-41,15979,53,2840,-200
+IMU,4700,2714,-120,15905,-35,2963,-170
+IMU,4710,3525,131,16056,-186,3007,130
+IMU,4720,4194,-63,16094,-25,3044,-19
+IMU,4730,4752,-122,15898,141,2818,-191
+IMU,4740,5585,-121,15955,-86,3045,-122
+IMU,4750,6393,-74,15888,85,3014,162
+IMU,4760,7086,86,16066,50,50,88
+IMU,4770,7007,41,16084,-44,188,-43
+IMU,4780,6946,-104,15975,-29,67,55
+IMU,4790,6991,-102,16135,138,80,-96
+IMU,4800,7094,-118,15889,54,-2,137
+IMU,4810,7043,-19,16017,-162,-189,-60
+IMU,4820,7008,-97,16112,148,102,149
+IMU,4830,7003,-14,15900,169,62,-94
+IMU,4840,6942,-14,16133,8,174,-24
+IMU,4850,6935,23,16000,-168,10,-89
+IMU,4860,6904,-120,16069,125,57,39
+IMU,4870,6939,79,15987,119,-69,199
+IMU,4880,6914,79,15951,-20,76,-4
+IMU,4890,6940,-110,16109,-6,-59,131
+IMU,4900,7144,-120,16012,-158,0,-122
+IMU,4910,7064,133,16134,50,-39,-38
+IMU,4920,7095,68,16011,109,-67,36
+IMU,4930,7087,-21,16081,0,-40,-41
+IMU,4940,7096,-93,15961,-96,100,-93
+IMU,4950,6909,91,16097,-175,-198,-118
+IMU,4960,7046,90,15943,-31,86,-186
+IMU,4970,7059,129,16135,-47,120,192
+IMU,4980,7056,-56,15910,-169,-76,82
+IMU,4990,6862,111,16060,-124,-137,-84
+IMU,5000,7060,-135,16132,189,165,47
+IMU,5010,6896,-99,15971,-90,-80,150
+IMU,5020,6991,49,15875,-15,-174,61
+IMU,5030,7095,-102,16024,-182,-98,-144
+IMU,5040,6902,-77,16026,-198,-44,175
+IMU,5050,7090,120,16049,-122,110,116
+IMU,5060,6970,-62,15931,-153,-93,-48
+IMU,5070,6909,145,15879,-173,-74,71
+IMU,5080,7074,-34,15892,80,-83,-164
+IMU,5090,7047,11,15954,-12,171,-93
+IMU,5100,7120,-2,15973,-65,-27,-183
+IMU,5110,6935,27,15955,193,11,167
+IMU,5120,6916,-100,15995,-131,31,118
+IMU,5130,6895,-97,16138,81,147,65
+IMU,5140,6867,-116,15910,-183,90,-172
+IMU,5150,7136,-145,15960,101,-192,194
+IMU,5160,7038,-24,16001,-39,-197,139
+IMU,5170,6965,83,15993,128,12,164
+IMU,5180,6911,138,16098,129,-160,53
+IMU,5190,7063,-115,16142,-19,-115,26
+IMU,5200,7032,71,15879,-48,-199,113
+IMU,5210,7103,106,15964,-11,-75,174
+IMU,5220,6925,-47,16038,105,-185,56
+IMU,5230,7034,-121,15986,135,130,-24
+IMU,5240,7015,144,16119,-57,186,-74
+IMU,5250,6915,-87,15927,-30,171,35
+IMU,5260,7141,56,16073,-159,-84,-86
+IMU,5270,6894,30,15895,15,136,93
+IMU,5280,6901,-117,15934,123,-162,-31
+IMU,5290,7047,58,16015,-193,168,-9
+IMU,5300,7114,-19,16003,-106,145,26
+IMU,5310,7106,37,15896,-60,-108,-70
+IMU,5320,6866,-126,16053,-54,-166,179
+IMU,5330,6939,34,15862,89,-180,118
+IMU,5340,7021,-34,15990,183,-11,116
+IMU,5350,6974,-12,15983,-182,49,-199
+IMU,5360,6925,7,15881,74,14,-122
+IMU,5370,6915,14,16091,176,-136,176
+IMU,5380,6888,41,15988,89,-32,54
+IMU,5390,6850,-148,15883,-131,-132,-8
+IMU,5400,7105,-147,15954,196,7,123
+IMU,5410,7104,89,15868,159,152,2
+IMU,5420,6949,-71,15907,-28,62,-130
+IMU,5430,7070,-27,15969,-78,-44,41
+IMU,5440,7046,-105,15909,51,-93,36
+IMU,5450,7090,-79,16103,-64,134,82
+IMU,5460,7035,-143,16011,95,3157,-199
+IMU,5470,6414,-128,15984,-163,3168,54
+IMU,5480,5630,-91,16106,81,2905,-199
+IMU,5490,4895,46,16120,-186,2902,149
+IMU,5500,4147,17,16040,-55,3066,113
+IMU,5510,3464,107,15861,105,2892,-24
+IMU,5520,2896,-92,16010,-180,3081,120
+IMU,5530,1993,87,15964,-60,3044,1
+IMU,5540,1361,131,16071,-82,3112,9
+IMU,5550,779,84,16073,-145,3097,96
+IMU,5560,78,139,16456,-40,-10,-49
+IMU,5570,-42,-31,16275,129,54,58
+IMU,5580,108,84,16339,-98,83,140
+IMU,5590,2,33,16285,-149,-109,90
+IMU,5600,86,31,16412,184,-133,-107
+IMU,5610,-118,49,16267,-22,-73,-16
+IMU,5620,142,-150,16423,-177,170,45
+IMU,5630,-141,83,16391,-57,164,173
+IMU,5640,-141,68,16321,-17,-197,-13
+IMU,5650,-106,-63,16235,-185,200,110
+IMU,5660,-13,-65,16501,114,59,-3
+IMU,5670,-71,43,16396,159,173,-86
+IMU,5680,-46,-60,16434,126,-44,139
+IMU,5690,90,43,16446,112,148,-136
+IMU,5700,-87,67,16341,-190,188,-35
+IMU,5710,147,-106,16457,189,-100,-110
+IMU,5720,11,129,16287,-178,156,27
+IMU,5730,-146,111,16439,200,-70,133
+IMU,5740,99,97,16461,-76,137,-153
+IMU,5750,91,-64,16471,-116,-164,-165
+IMU,5760,-95,-74,16487,-33,-112,170
+IMU,5770,18,-128,16267,43,-167,-175
+IMU,5780,-34,9,16461,111,-197,136
+IMU,5790,50,39,16457,-139,195,-189
+IMU,5800,81,-76,16365,79,184,-178
+IMU,5810,-19,-148,16473,38,3,-65
+IMU,5820,-42,-119,16507,103,-141,-189
+IMU,5830,122,49,16473,-121,-150,171
+IMU,5840,57,-43,16327,113,98,109
+IMU,5850,36,-73,16494,45,154,61
+IMU,5860,88,6,16488,-173,113,-163
+IMU,5870,41,-95,16410,127,95,23
+IMU,5880,28,46,16521,-97,156,-18
+IMU,5890,54,-54,16498,53,128,165
+IMU,5900,75,61,16402,102,-152,-192
+IMU,5910,-109,-38,16474,-190,-183,-155
+IMU,5920,133,-97,16289,20,25,-35
+IMU,5930,70,-149,16358,-179,-150,69
+IMU,5940,-91,150,16328,-23,0,-57
+IMU,5950,49,-36,16341,68,-95,13
+IMU,5960,-136,44,16465,-144,-124,-152
+IMU,5970,83,64,16243,-28,-157,-179
+IMU,5980,48,-69,16530,-175,-47,-57
+IMU,5990,51,29,16250,-181,17,126
+IMU,6000,56,52,16275,-142,158,-89
+IMU,6010,49,-37,16259,-198,-66,21
+IMU,6020,-105,20,16331,-125,181,177
+IMU,6030,54,141,16427,-55,100,-33
+IMU,6040,-52,-102,16302,4,109,139
+IMU,6050,-50,-115,16452,-67,-58,27
+)TRACE";
+
+static const char trace_shake[] = R"TRACE(
+IMU,10,9,-67,16389,-130,92,-127
+IMU,20,-80,-60,16279,-182,-9,-87
+IMU,30,-58,126,16451,-50,72,88
+IMU,40,46,-129,16407,76,-130,-161
+IMU,50,-108,-1,16381,-186,-178,154
+IMU,60,131,-68,16439,19,17,173
+IMU,70,-72,132,16270,158,34,-196
+IMU,80,-93,-82,16270,-75,73,192
+IMU,90,15,122,16487,-161,184,-40
+IMU,100,137,-110,16275,131,40,132
+IMU,110,47,6,16388,-153,-182,154
+IMU,120,77,-53,16259,-136,-199,56
+IMU,130,68,-6,16292,-114,6,-50
+IMU,140,-11,-75,16439,-46,193,59
+IMU,150,86,34,16386,-139,-54,127
+IMU,160,18,-135,16246,29,-200,1
+IMU,170,-56,-17,16432,110,44,-164
+IMU,180,48,-48,16242,-123,-83,150
+IMU,190,-97,-104,16509,101,-73,145
+IMU,200,38,42,16527,-197,80,89
+IMU,210,-43,-99,16505,41,165,-57
+IMU,220,-26,-31,16268,-176,109,-70
+IMU,230,-118,29,16490,160,-161,84
+IMU,240,-52,142,16270,113,-44,-15
+IMU,250,-63,105,16379,1,7,102
+IMU,260,-46,-60,16462,-55,-147,-88
+IMU,270,122,43,16480,27,30,170
+IMU,280,-47,-95,16253,0,-111,-134
+IMU,290,-43,29,16525,110,53,143
+IMU,300,-96,88,16248,63,127,-140
+IMU,310,100,42,16386,166,-43,-171
+IMU,320,-34,48,16270,-109,-13,-97
+IMU,330,44,95,16273,126,-197,-18
+IMU,340,-146,83,16289,-45,14,37
+IMU,350,-121,105,16356,96,138,-4
+IMU,360,18,-97,16475,-127,-95,-42
+IMU,370,68,-37,16470,-136,188,-150
+IMU,380,-132,53,16517,-80,-110,43
+IMU,390,86,19,16289,175,-185,-195
+IMU,400,81,-66,16256,-106,107,-32
+IMU,410,64,99,16342,157,-163,-103
+IMU,420,-62,138,16346,-79,-41,-19
+IMU,430,68,-129,16375,25,100,-127
+IMU,440,-59,-111,16297,69,44,107
+IMU,450,-13,-12,16263,167,-112,-99
+IMU,460,-133,-46,16527,34,-105,-168
+IMU,470,-55,147,16420,51,-157,-144
+IMU,480,-62,-77,16461,-39,-10,104
+IMU,490,43,119,16289,-59,-155,30
+IMU,500,29,-135,16416,-200,-43,29
+LABEL,510,SHAKE
+IMU,510,132,-19,16298,-106,154,83
+IMU,520,791,1370,16254,12434,7694,3868
+IMU,530,1354,2270,16528,21696,13000,7105
+IMU,540,1409,2563,16440,24868,15075,7839
+IMU,550,1338,2086,16443,21773,12960,6797
+IMU,560,611,1374,16487,12345,7477,3968
+IMU,570,114,-17,16341,33,138,-162
+IMU,580,-719,-1155,16435,-12328,-7601,-3921
+IMU,590,-1432,-2274,16407,-21518,-13115,-6804
+IMU,600,-1611,-2523,16392,-25053,-14812,-8161
+IMU,610,-1350,-2266,16328,-21473,-12916,-7120
+IMU,620,-697,-1395,16468,-12544,-7441,-3974
+IMU,630,72,-85,16366,-177,-81,-57
+IMU,640,856,1107,16247,12469,7601,3962
+IMU,650,1243,2281,16288,21801,12956,6899
+IMU,660,1366,2588,16388,24961,15172,8097
+IMU,670,1163,2110,16396,21586,13028,7119
+IMU,680,698,1383,16516,12409,7334,4179
+IMU,690,124,-139,16265,-191,18,-179
+IMU,700,-898,-1220,16366,-12615,-7411,-4198
+IMU,710,-1308,-2168,16432,-21645,-12866,-6954
+IMU,720,-1365,-2433,16315,-24946,-14809,-7848
+IMU,730,-1373,-2313,16277,-21831,-12952,-6821
+IMU,740,-620,-1380,16404,-12569,-7612,-3959
+IMU,750,99,-58,16415,-9,-38,142
+IMU,760,877,1324,16433,12319,7601,3989
+IMU,770,1406,2069,16371,21499,12937,6773
+IMU,780,1545,2473,16282,25172,15072,8191
+IMU,790,1375,2117,16260,21483,12901,7080
+IMU,800,879,1243,16358,12636,7350,4046
+IMU,810,-78,113,16310,-7,11,105
+IMU,820,-678,-1311,16494,-12534,-7632,-3907
+IMU,830,-1271,-2110,16517,-21526,-12924,-6788
+IMU,840,-1389,-2589,16450,-25118,-14990,-7873
+IMU,850,-1304,-2082,16300,-21718,-13144,-6862
+IMU,860,-644,-1266,16444,-12536,-7651,-3926
+IMU,870,35,146,16496,12,-18,72
+IMU,880,669,1341,16491,12645,7485,4032
+IMU,890,1259,2131,16283,21782,13016,7029
+IMU,900,1444,2582,16299,25040,14804,8026
+IMU,910,1384,2216,16396,21632,12968,6948
+IMU,920,717,1310,16362,12569,7467,3888
+IMU,930,-6,60,16326,48,95,-172
+IMU,940,-767,-1159,16255,-12350,-7616,-4152
+IMU,950,-1302,-2215,16296,-21720,-12831,-7077
+IMU,960,-1505,-2551,16413,-25175,-14990,-8051
+IMU,970,-1276,-2113,16331,-21644,-12861,-7054
+IMU,980,-798,-1345,16287,-12433,-7442,-3999
+IMU,990,-131,108,16237,-33,-148,150
+IMU,1000,631,1298,16348,12524,7694,4010
+IMU,1010,1364,2045,16433,21631,13151,6990
+IMU,1020,1642,2362,16240,24848,14992,8100
+IMU,1030,1207,2120,16482,21738,13181,6823
+IMU,1040,877,1206,16257,12668,7346,4193
+IMU,1050,47,97,16474,-171,-16,109
+IMU,1060,-812,-1207,16440,-12331,-7374,-3894
+IMU,1070,-1305,-2181,16306,-21704,-12909,-6750
+IMU,1080,-1644,-2557,16316,-24886,-14844,-7849
+IMU,1090,-1234,-2030,16461,-21698,-13184,-6791
+IMU,1100,-686,-1310,16289,-12491,-7345,-4184
+IMU,1110,-78,-58,16275,153,159,84
+IMU,1120,-122,22,16379,-16,-101,110
+IMU,1130,11,86,16406,99,190,86
+IMU,1140,31,-120,16349,120,142,165
+IMU,1150,-122,89,16494,-70,171,-34
+IMU,1160,-50,-135,16294,-199,-168,-187
+IMU,1170,-5,82,16247,-124,-107,70
+IMU,1180,-114,-2,16446,40,6,149
+IMU,1190,-55,-148,16446,112,153,122
+IMU,1200,92,-105,16254,74,-180,18
+IMU,1210,-14,131,16447,17,-157,182
+IMU,1220,-14,-79,16462,61,-139,161
+IMU,1230,-60,98,16509,-49,-160,-59
+IMU,1240,-27,-141,16428,-138,130,125
+IMU,1250,-58,-86,16475,114,-161,-107
+IMU,1260,47,112,16458,-200,151,181
+IMU,1270,82,1,16355,148,21,71
+IMU,1280,-66,-118,16520,156,151,-8
+IMU,1290,72,-115,16526,25,113,-111
+IMU,1300,-17,7,16424,12,-61,-33
+IMU,1310,42,125,16527,-134,79,-158
+IMU,1320,-66,-89,16368,-108,-66,-77
+IMU,1330,72,-122,16511,-72,-193,-106
+IMU,1340,76,-71,16518,59,131,-175
+IMU,1350,125,-47,16449,-29,-189,191
+IMU,1360,-112,69,16267,90,106,105
+IMU,1370,-2,-131,16434,-176,-162,60
+IMU,1380,18,86,16473,41,152,-121
+IMU,1390,-18,-113,16425,109,131,-18
+IMU,1400,-21,-132,16373,186,-26,-106
+IMU,1410,72,46,16452,56,54,-16
+IMU,1420,44,40,16355,152,140,103
+IMU,1430,-97,138,16403,43,-151,161
+IMU,1440,51,31,16341,120,18,123
+IMU,1450,-89,-17,16312,110,-61,-57
+IMU,1460,95,30,16331,177,-17,-163
+IMU,1470,-59,-71,16386,37,-171,177
+IMU,1480,139,-41,16345,-60,-123,192
+IMU,1490,-102,76,16522,146,61,157
+IMU,1500,103,144,16385,-67,-137,143
+IMU,1510,122,-86,16414,-112,-132,13
+IMU,1520,-78,-86,16276,-197,-115,184
+IMU,1530,124,78,16399,-28,71,-99
+IMU,1540,-128,-94,16452,105,195,31
+IMU,1550,-126,-64,16433,176,147,134
+IMU,1560,119,-92,16276,-175,141,-49
+IMU,1570,-33,-109,16458,-127,-41,112
+IMU,1580,-72,-84,16245,90,48,-137
+IMU,1590,108,-50,16444,156,-3,-173
+IMU,1600,-100,43,16246,146,-78,-18
+IMU,1610,-146,125,16270,50,-133,-23
+IMU,1620,57,94,16510,27,-191,-24
+IMU,1630,105,106,16279,-16,179,-53
+IMU,1640,148,-91,16445,78,61,151
+IMU,1650,150,93,16513,-91,-13,187
+IMU,1660,118,-18,16398,-129,-41,176
+IMU,1670,55,130,16468,167,-109,-101
+IMU,1680,-121,45,16507,93,91,66
+IMU,1690,-76,-116,16288,6,0,-47
+IMU,1700,146,104,16346,-44,-136,175
+IMU,1710,-134,-33,16320,-194,-86,47
+IMU,1720,69,-108,16355,-168,-6,141
+IMU,1730,-36,-72,16291,-168,-14,-186
+IMU,1740,-71,-70,16264,96,5,-13
+IMU,1750,13,79,16360,-98,-62,-74
+IMU,1760,37,69,16385,120,-149,40
+IMU,1770,-101,73,16490,187,36,29
+IMU,1780,-130,97,16466,30,-115,-118
+IMU,1790,-47,148,16424,58,-51,-160
+IMU,1800,31,141,16333,128,124,141
+IMU,1810,-129,-137,16449,44,169,-88
+IMU,1820,-121,35,16376,-174,-151,-175
+IMU,1830,39,133,16447,172,134,195
+IMU,1840,-69,52,16529,-2,94,-102
+IMU,1850,-18,83,16432,117,80,-175
+IMU,1860,-108,-48,16325,25,-107,-105
+IMU,1870,-46,-8,16531,-99,-1,-193
+IMU,1880,89,-139,16472,1,-153,98
+IMU,1890,-132,97,16333,117,-4,-153
+IMU,1900,134,-26,16516,177,199,-30
+IMU,1910,32,752,16242,1943,905,111
+IMU,1920,46,688,16348,2164,1088,-26
+IMU,1930,-39,651,16289,2160,1087,8
+IMU,1940,-6,888,16279,1851,1008,173
+IMU,1950,-95,785,16442,1998,922,-113
+IMU,1960,90,856,16522,1929,999,-36
+IMU,1970,-71,683,16277,1946,1037,116
+IMU,1980,-147,897,16259,1859,823,111
+IMU,1990,-65,846,16396,1822,1080,43
+IMU,2000,-69,851,16509,2104,960,163
+IMU,2010,49,931,16241,1866,1086,-128
+IMU,2020,75,877,16527,2195,871,-105
+IMU,2030,-23,863,16317,2131,1052,-27
+IMU,2040,-28,784,16286,1815,981,193
+IMU,2050,105,650,16448,1808,1118,110
+IMU,2060,-13,692,16425,2120,1147,135
+IMU,2070,-78,887,16237,2038,943,-112
+IMU,2080,-2,656,16527,1870,1081,89
+IMU,2090,-123,851,16323,1853,1111,-14
+IMU,2100,144,868,16400,1992,1179,-38
+IMU,2110,-77,739,16515,2171,818,-101
+IMU,2120,7,937,16266,1957,987,-23
+IMU,2130,109,666,16380,1911,1200,105
+IMU,2140,-85,862,16460,1957,828,149
+IMU,2150,-2,781,16467,1955,1008,188
+IMU,2160,15,887,16258,2030,1050,-179
+IMU,2170,-105,898,16413,1934,1024,29
+IMU,2180,63,904,16512,2020,810,176
+IMU,2190,71,669,16439,2065,936,9
+IMU,2200,44,853,16452,2196,915,-179
+IMU,2210,69,59,16533,89,-17,9
+IMU,2220,-7,31,16388,112,44,-7
+IMU,2230,-13,88,16252,63,-91,-108
+IMU,2240,-54,105,16453,-132,120,5
+IMU,2250,-94,124,16429,197,-153,-130
+IMU,2260,-57,-112,16447,-30,56,138
+IMU,2270,16,71,16432,4,44,-59
+IMU,2280,-49,-61,16519,158,-118,71
+IMU,2290,16,-14,16521,-176,186,-32
+IMU,2300,-4,26,16355,33,88,28
+IMU,2310,30,39,16470,178,82,-194
+IMU,2320,102,78,16435,141,36,-155
+IMU,2330,-135,71,16424,153,95,-117
+IMU,2340,-16,110,16308,-109,-111,109
+IMU,2350,67,-9,16265,-64,-200,-148
+IMU,2360,-137,-12,16519,5,119,-157
+IMU,2370,-72,-147,16467,-17,146,170
+IMU,2380,-88,37,16270,193,70,-117
+IMU,2390,-75,53,16500,121,19,64
+IMU,2400,-75,-8,16357,76,170,152
+IMU,2410,-26,-13,16375,144,-188,-161
+IMU,2420,-27,4,16409,-189,-171,-170
+IMU,2430,87,-23,16339,135,17,77
+IMU,2440,22,-3,16476,-88,174,-1
+IMU,2450,-73,133,16343,-76,-100,-7
+IMU,2460,-14,88,16349,-147,156,9
+IMU,2470,-125,9,16271,69,23,-105
+IMU,2480,93,-78,16389,-165,67,195
+IMU,2490,-29,149,16334,-56,75,-50
+IMU,2500,-126,-24,16467,198,-165,185
+IMU,2510,-9,96,16321,-88,6,21
+IMU,2520,71,87,16430,-130,46,-148
+IMU,2530,-131,82,16514,107,-138,-40
+IMU,2540,14,8,16409,-145,-120,134
+IMU,2550,-121,64,16352,104,155,16
+IMU,2560,3,2,16364,-45,-19,-16
+IMU,2570,-71,23,16314,-161,-157,-93
+IMU,2580,-26,120,16498,-132,-108,16
+IMU,2590,35,-3,16392,-66,-159,151
+IMU,2600,1,71,16430,-181,-138,-4
+IMU,2610,-10,61,16379,39,98,-25
+IMU,2620,-67,-53,16412,-162,44,-58
+IMU,2630,77,-30,16297,-20,93,-189
+IMU,2640,-27,-8,16419,58,77,-72
+IMU,2650,147,-6,16338,30,-138,70
+IMU,2660,-124,-67,16458,127,-93,192
+IMU,2670,115,141,16240,-159,-74,86
+IMU,2680,-9,123,16277,35,27,-150
+IMU,2690,149,-147,16369,83,-143,185
+IMU,2700,23,45,16259,47,-157,-175
+)TRACE";
+
+#endif
@@ -0,0 +1,233 @@
+/*
+ * 动作识别的回放测试（在电脑上运行: pio test -e native -f test_gesture）
+ * 将imu_trace记录的样本逐个输入GestureEngine 与人工标注的动作比较 输出准确率与识别延迟
+ * 设置环境变量GESTURE_TRACE为记录文件的路径时 额外回放该文件（只输出结果 不做断言）
+ * 记录文件即开启imu_trace后的串口输出 需手工加入标注行: LABEL,动作开始的时间,动作名
+ */
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// 直接编译被测源文件 不依赖固件的其他部分
+#include "../../src/driver/gesture.cpp"
+#include "gesture_traces.h"
+
+#define SAMPLE_PERIOD 10   // 与IMU_SAMPLE_PERIOD一致 ms
+#define MATCH_WINDOW 1500  // 标注之后多久之内的同名事件算作识别成功 ms
+
+static const char *const action_name[] = {"TURN_RIGHT", "RETURN", "TURN_LEFT", "UP",
+                                          "DOWN", "GO_FORWORD", "SHAKE", "UNKNOWN"};
+
+struct TraceEvent
+{
+    unsigned long time;
+    ACTIVE_TYPE active;
+    bool used; // 已与标注匹配
+};
+
+struct ReplayResult
+{
+    int labels;
+    int detected;
+    int false_events; // 没有对应标注的事件
+    unsigned long latency_sum;
+    unsigned long latency_max;
+};
+
+static ACTIVE_TYPE parse_action(const char *name)
+{
+    for (int pos = 0; pos < UNKNOWN; ++pos)
+    {
+        size_t len = strlen(action_name[pos]);
+        if (!strncmp(name, action_name[pos], len) && (name[len] < 'A' || name[len] > 'Z'))
+        {
+            return (ACTIVE_TYPE)pos;
+        }
+    }
+    return UNKNOWN;
+}
+
+static void on_gesture(ACTIVE_TYPE active, bool long_time, void *user_data)
+{
+    std::vector<TraceEvent> *events = (std::vector<TraceEvent> *)user_data;
+    (void)long_time;
+    // 时间在update返回后填写
+    TraceEvent event = {0, active, false};
+    events->push_back(event);
+}
+
+// 回放一段记录 返回统计结果 cfg为NULL时使用默认阈值 verbose时逐条输出标注的识别情况
+static ReplayResult replay(const char *name, const char *text, const GestureConfig *cfg, bool verbose)
+{
+    GestureEngine engine;
+    if (NULL != cfg)
+    {
+        engine.setConfig(cfg);
+    }
+    std::vector<TraceEvent> events;
+    std::vector<TraceEvent> labels;
+    engine.setCallback(on_gesture, &events);
+
+    unsigned long prev_time = 0;
+    bool first = true;
+    const char *line = text;
+    while (NULL != line && '\0' != *line)
+    {
+        const char *next = strchr(line, '\n');
+        long t;
+        int ax, ay, az, gx, gy, gz;
+        if (7 == sscanf(line, "IMU,%ld,%d,%d,%d,%d,%d,%d", &t, &ax, &ay, &az, &gx, &gy, &gz))
+        {
+            ImuAction sample;
+            memset(&sample, 0, sizeof(sample));
+            sample.v_ax = ax;
+            sample.v_ay = ay;
+            sample.v_az = az;
+            sample.v_gx = gx;
+            sample.v_gy = gy;
+            sample.v_gz = gz;
+            unsigned long dt = first ? SAMPLE_PERIOD : (unsigned long)t - prev_time;
+            first = false;
+            prev_time = t;
+            size_t old_num = events.size();
+            engine.update(&sample, dt);
+            for (size_t pos = old_num; pos < events.size(); ++pos)
+            {
+                events[pos].time = engine.getTime();
+            }
+        }
+        else if (!strncmp(line, "LABEL,", 6))
+        {
+            TraceEvent label = {strtoul(line + 6, NULL, 10), UNKNOWN, false};
+            const char *action = strchr(line + 6, ',');
+            if (NULL != action)
+            {
+                label.active = parse_action(action + 1);
+                labels.push_back(label);
+            }
+        }
+        // 其他行（如记录时设备上识别出的IMU_EVT）忽略
+        line = NULL != next ? next + 1 : NULL;
+    }
+
+    ReplayResult result;
+    memset(&result, 0, sizeof(result));
+    result.labels = labels.size();
+    for (size_t pos = 0; pos < labels.size(); ++pos)
+    {
+        const TraceEvent *label = &labels[pos];
+        TraceEvent *match = NULL;
+        for (size_t num = 0; num < events.size() && NULL == match; ++num)
+        {
+            TraceEvent *event = &events[num];
+            if (!event->used && event->active == label->active &&
+                event->time >= label->time && event->time - label->time <= MATCH_WINDOW)
+            {
+                match = event;
+            }
+        }
+        if (NULL != match)
+        {
+            unsigned long latency = match->time - label->time;
+            match->used = true;
+            ++result.detected;
+            result.latency_sum += latency;
+            if (latency > result.latency_max)
+            {
+                result.latency_max = latency;
+            }
+        }
+        if (verbose)
+        {
+            if (NULL != match)
+            {
+                printf("  %-10s at %6lu ms  detected +%lu ms\n", action_name[label->active],
+                       label->time, match->time - label->time);
+            }
+            else
+            {
+                printf("  %-10s at %6lu ms  MISSED\n", action_name[label->active], label->time);
+            }
+        }
+    }
+    for (size_t num = 0; num < events.size(); ++num)
+    {
+        if (!events[num].used)
+        {
+            ++result.false_events;
+            if (verbose)
+            {
+                printf("  %-10s at %6lu ms  FALSE\n", action_name[events[num].active], events[num].time);
+            }
+        }
+    }
+
+    printf("%s: accuracy %d/%d (%.1f%%), false %d, latency avg %.1f ms max %lu ms\n", name,
+           result.detected, result.labels,
+           result.labels > 0 ? 100.0 * result.detected / result.labels : 100.0,
+           result.false_events,
+           result.detected > 0 ? (double)result.latency_sum / result.detected : 0.0,
+           result.latency_max);
+    return result;
+}
+
+static void test_tilts(void)
+{
+    ReplayResult result = replay("tilts", trace_tilts, NULL, true);
+    TEST_ASSERT_EQUAL(result.labels, result.detected);
+    TEST_ASSERT_EQUAL(0, result.false_events);
+    // 长按在hold_time（默认400ms）之后识别 其余应更快
+    TEST_ASSERT_LESS_OR_EQUAL(600, result.latency_max);
+}
+
+static void test_shake(void)
+{
+    ReplayResult result = replay("shake", trace_shake, NULL, true);
+    TEST_ASSERT_EQUAL(result.labels, result.detected);
+    TEST_ASSERT_EQUAL(0, result.false_events);
+}
+
+static void test_exit_threshold_clamped(void)
+{
+    // 超出范围的阈值应被限制: 退出阈值不高于进入阈值 滤波系数不小于0
+    GestureConfig cfg;
+    gesture_default_config(&cfg);
+    cfg.tilt_exit = cfg.tilt_enter + 1000;
+    cfg.filter_shift = -1;
+    ReplayResult result = replay("tilts (clamped config)", trace_tilts, &cfg, false);
+    TEST_ASSERT_EQUAL(result.labels, result.detected);
+}
+
+static void test_recorded_file(void)
+{
+    const char *path = getenv("GESTURE_TRACE");
+    if (NULL == path)
+    {
+        TEST_IGNORE_MESSAGE("set GESTURE_TRACE to replay a recorded trace");
+        return;
+    }
+    FILE *file = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL_MESSAGE(file, path);
+    std::vector<char> text;
+    char buf[512];
+    size_t len;
+    while ((len = fread(buf, 1, sizeof(buf), file)) > 0)
+    {
+        text.insert(text.end(), buf, buf + len);
+    }
+    fclose(file);
+    text.push_back('\0');
+    replay(path, &text[0], NULL, true);
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_tilts);
+    RUN_TEST(test_shake);
+    RUN_TEST(test_exit_threshold_clamped);
+    RUN_TEST(test_recorded_file);
+    return UNITY_END();
+}
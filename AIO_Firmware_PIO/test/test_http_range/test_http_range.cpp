@@ -0,0 +1,294 @@
+/*
+ * Range请求头解析与文件下载响应的测试（在电脑上运行: pio test -e native -f test_http_range）
+ * 下载处理（sd_file_download）中不依赖Arduino的部分都在http_range中 这里用内存中的文件与客户端代替
+ */
+#include <unity.h>
+#include <string.h>
+
+// 直接编译被测源文件 不依赖固件的其他部分
+#include "../../src/app/server/http_range.cpp"
+
+#define FILE_SIZE 1000
+#define DOWNLOAD_BUF_SIZE 28800       // 与下载时租借的BUF_STRIP大小相同
+#define LAST_WRITE ((time_t)784111777) // Sun, 06 Nov 1994 08:49:37 GMT
+
+static HTTP_RANGE_RESULT parse(const char *header, uint32_t *start, uint32_t *end)
+{
+    *start = 0xFFFFFFFF;
+    *end = 0xFFFFFFFF;
+    return http_parse_range(header, FILE_SIZE, start, end);
+}
+
+static void test_closed_range(void)
+{
+    uint32_t start, end;
+    TEST_ASSERT_EQUAL(HTTP_RANGE_OK, parse("bytes=0-499", &start, &end));
+    TEST_ASSERT_EQUAL_UINT32(0, start);
+    TEST_ASSERT_EQUAL_UINT32(499, end);
+
+    // 结束位置超出文件时截到最后一个字节
+    TEST_ASSERT_EQUAL(HTTP_RANGE_OK, parse("bytes=900-5000", &start, &end));
+    TEST_ASSERT_EQUAL_UINT32(900, start);
+    TEST_ASSERT_EQUAL_UINT32(999, end);
+}
+
+static void test_open_ended_range(void)
+{
+    uint32_t start, end;
+    TEST_ASSERT_EQUAL(HTTP_RANGE_OK, parse("bytes=500-", &start, &end));
+    TEST_ASSERT_EQUAL_UINT32(500, start);
+    TEST_ASSERT_EQUAL_UINT32(999, end);
+
+    TEST_ASSERT_EQUAL(HTTP_RANGE_OK, parse("bytes=0-", &start, &end));
+    TEST_ASSERT_EQUAL_UINT32(0, start);
+    TEST_ASSERT_EQUAL_UINT32(999, end);
+}
+
+static void test_suffix_range(void)
+{
+    uint32_t start, end;
+    TEST_ASSERT_EQUAL(HTTP_RANGE_OK, parse("bytes=-100", &start, &end));
+    TEST_ASSERT_EQUAL_UINT32(900, start);
+    TEST_ASSERT_EQUAL_UINT32(999, end);
+
+    // 后缀长度大于文件时返回整个文件
+    TEST_ASSERT_EQUAL(HTTP_RANGE_OK, parse("bytes=-5000", &start, &end));
+    TEST_ASSERT_EQUAL_UINT32(0, start);
+    TEST_ASSERT_EQUAL_UINT32(999, end);
+
+    TEST_ASSERT_EQUAL(HTTP_RANGE_INVALID, parse("bytes=-0", &start, &end));
+}
+
+static void test_start_past_eof(void)
+{
+    uint32_t start, end;
+    TEST_ASSERT_EQUAL(HTTP_RANGE_INVALID, parse("bytes=1000-", &start, &end));
+    TEST_ASSERT_EQUAL(HTTP_RANGE_INVALID, parse("bytes=1000-1200", &start, &end));
+    TEST_ASSERT_EQUAL(HTTP_RANGE_INVALID, parse("bytes=99999999999-", &start, &end));
+    TEST_ASSERT_EQUAL(HTTP_RANGE_INVALID, http_parse_range("bytes=0-", 0, &start, &end));
+}
+
+static void test_malformed(void)
+{
+    uint32_t start, end;
+    TEST_ASSERT_EQUAL(HTTP_RANGE_NONE, http_parse_range(NULL, FILE_SIZE, &start, &end));
+    TEST_ASSERT_EQUAL(HTTP_RANGE_NONE, parse("", &start, &end));
+    TEST_ASSERT_EQUAL(HTTP_RANGE_NONE, parse("items=0-10", &start, &end));
+    TEST_ASSERT_EQUAL(HTTP_RANGE_NONE, parse("bytes=", &start, &end));
+    TEST_ASSERT_EQUAL(HTTP_RANGE_NONE, parse("bytes=-", &start, &end));
+    TEST_ASSERT_EQUAL(HTTP_RANGE_NONE, parse("bytes=abc-10", &start, &end));
+    TEST_ASSERT_EQUAL(HTTP_RANGE_NONE, parse("bytes=10", &start, &end));
+    TEST_ASSERT_EQUAL(HTTP_RANGE_NONE, parse("bytes=10-5", &start, &end));
+    TEST_ASSERT_EQUAL(HTTP_RANGE_NONE, parse("bytes=0-10x", &start, &end));
+    // 多段请求按完整内容返回
+    TEST_ASSERT_EQUAL(HTTP_RANGE_NONE, parse("bytes=0-10,20-30", &start, &end));
+    // 不支持的形式不修改输出
+    TEST_ASSERT_EQUAL_UINT32(0xFFFFFFFF, start);
+    TEST_ASSERT_EQUAL_UINT32(0xFFFFFFFF, end);
+}
+
+static void test_date(void)
+{
+    char date[32];
+    http_format_date(LAST_WRITE, date, sizeof(date));
+    TEST_ASSERT_EQUAL_STRING("Sun, 06 Nov 1994 08:49:37 GMT", date);
+
+    time_t time = 0;
+    TEST_ASSERT_TRUE(http_parse_date(date, &time));
+    TEST_ASSERT_EQUAL_INT32(LAST_WRITE, time);
+    TEST_ASSERT_TRUE(http_parse_date("Thu, 29 Feb 2024 23:59:59 GMT", &time));
+    TEST_ASSERT_EQUAL_INT32(1709251199, time);
+
+    TEST_ASSERT_FALSE(http_parse_date(NULL, &time));
+    TEST_ASSERT_FALSE(http_parse_date("", &time));
+    TEST_ASSERT_FALSE(http_parse_date("Sunday, 06-Nov-94 08:49:37 GMT", &time));
+    TEST_ASSERT_FALSE(http_parse_date("Sun, 06 Foo 1994 08:49:37 GMT", &time));
+    TEST_ASSERT_FALSE(http_parse_date("Sun, 06 Nov 1994 08:49:37 CST", &time));
+}
+
+static void test_plan_full(void)
+{
+    HttpDownloadPlan plan;
+    http_download_plan("", "", FILE_SIZE, LAST_WRITE, &plan);
+    TEST_ASSERT_EQUAL_INT(200, plan.code);
+    TEST_ASSERT_EQUAL_UINT32(0, plan.start);
+    TEST_ASSERT_EQUAL_UINT32(FILE_SIZE, plan.len);
+    TEST_ASSERT_EQUAL_STRING("", plan.content_range);
+    TEST_ASSERT_EQUAL_STRING("Sun, 06 Nov 1994 08:49:37 GMT", plan.last_modified);
+
+    // 修改时间未知时不发送Last-Modified
+    http_download_plan(NULL, NULL, FILE_SIZE, 0, &plan);
+    TEST_ASSERT_EQUAL_INT(200, plan.code);
+    TEST_ASSERT_EQUAL_STRING("", plan.last_modified);
+}
+
+static void test_plan_partial(void)
+{
+    HttpDownloadPlan plan;
+    http_download_plan("bytes=100-199", NULL, FILE_SIZE, LAST_WRITE, &plan);
+    TEST_ASSERT_EQUAL_INT(206, plan.code);
+    TEST_ASSERT_EQUAL_UINT32(100, plan.start);
+    TEST_ASSERT_EQUAL_UINT32(100, plan.len);
+    TEST_ASSERT_EQUAL_STRING("bytes 100-199/1000", plan.content_range);
+
+    http_download_plan("bytes=-1", NULL, FILE_SIZE, LAST_WRITE, &plan);
+    TEST_ASSERT_EQUAL_INT(206, plan.code);
+    TEST_ASSERT_EQUAL_UINT32(999, plan.start);
+    TEST_ASSERT_EQUAL_UINT32(1, plan.len);
+    TEST_ASSERT_EQUAL_STRING("bytes 999-999/1000", plan.content_range);
+}
+
+static void test_plan_unsatisfiable(void)
+{
+    HttpDownloadPlan plan;
+    http_download_plan("bytes=1000-", NULL, FILE_SIZE, LAST_WRITE, &plan);
+    TEST_ASSERT_EQUAL_INT(416, plan.code);
+    TEST_ASSERT_EQUAL_UINT32(0, plan.len);
+    TEST_ASSERT_EQUAL_STRING("bytes */1000", plan.content_range);
+    TEST_ASSERT_EQUAL_STRING("Sun, 06 Nov 1994 08:49:37 GMT", plan.last_modified);
+}
+
+static void test_plan_not_modified(void)
+{
+    HttpDownloadPlan plan;
+    // 先判断If-Modified-Since 未修改时忽略Range
+    http_download_plan("bytes=1000-", "Sun, 06 Nov 1994 08:49:37 GMT", FILE_SIZE, LAST_WRITE, &plan);
+    TEST_ASSERT_EQUAL_INT(304, plan.code);
+    TEST_ASSERT_EQUAL_UINT32(0, plan.len);
+    TEST_ASSERT_EQUAL_STRING("", plan.content_range);
+    TEST_ASSERT_EQUAL_STRING("Sun, 06 Nov 1994 08:49:37 GMT", plan.last_modified);
+
+    http_download_plan(NULL, "Mon, 07 Nov 1994 00:00:00 GMT", FILE_SIZE, LAST_WRITE, &plan);
+    TEST_ASSERT_EQUAL_INT(304, plan.code);
+
+    // 文件在此之后修改过
+    http_download_plan(NULL, "Sun, 06 Nov 1994 08:49:36 GMT", FILE_SIZE, LAST_WRITE, &plan);
+    TEST_ASSERT_EQUAL_INT(200, plan.code);
+    // 无法解析的日期与未知的修改时间都按没有该请求头处理
+    http_download_plan(NULL, "yesterday", FILE_SIZE, LAST_WRITE, &plan);
+    TEST_ASSERT_EQUAL_INT(200, plan.code);
+    http_download_plan(NULL, "Sun, 06 Nov 1994 08:49:37 GMT", FILE_SIZE, 0, &plan);
+    TEST_ASSERT_EQUAL_INT(200, plan.code);
+}
+
+// 内存中的文件与客户端
+struct TestFile
+{
+    const uint8_t *data;
+    uint32_t size;
+    uint32_t pos;
+    int reads;
+};
+
+struct TestClient
+{
+    uint8_t *data;
+    uint32_t size;
+    uint32_t limit; // 超过后写入不完整（模拟断开）
+    int writes;
+};
+
+static size_t test_read(void *ctx, uint8_t *buf, size_t len)
+{
+    TestFile *file = (TestFile *)ctx;
+    uint32_t num = file->size - file->pos < len ? file->size - file->pos : (uint32_t)len;
+    memcpy(buf, file->data + file->pos, num);
+    file->pos += num;
+    ++file->reads;
+    return num;
+}
+
+static size_t test_write(void *ctx, const uint8_t *buf, size_t len)
+{
+    TestClient *client = (TestClient *)ctx;
+    uint32_t num = client->limit - client->size < len ? client->limit - client->size : (uint32_t)len;
+    memcpy(client->data + client->size, buf, num);
+    client->size += num;
+    ++client->writes;
+    return num;
+}
+
+#define BIG_FILE_SIZE (DOWNLOAD_BUF_SIZE * 2 + 100)
+static uint8_t file_data[BIG_FILE_SIZE];
+static uint8_t client_data[BIG_FILE_SIZE];
+static uint8_t download_buf[DOWNLOAD_BUF_SIZE];
+
+// 按计划发送 与sd_file_download中一致
+static uint32_t download(const char *range, TestClient *client, HttpDownloadPlan *plan)
+{
+    http_download_plan(range, NULL, BIG_FILE_SIZE, LAST_WRITE, plan);
+    TestFile file = {file_data, BIG_FILE_SIZE, plan->start, 0};
+    memset(client, 0, sizeof(TestClient));
+    client->data = client_data;
+    client->limit = BIG_FILE_SIZE;
+    return http_copy_body(test_read, &file, test_write, client,
+                          download_buf, sizeof(download_buf), plan->len);
+}
+
+static void test_copy_full(void)
+{
+    for (uint32_t pos = 0; pos < BIG_FILE_SIZE; ++pos)
+    {
+        file_data[pos] = (uint8_t)(pos * 7);
+    }
+    TestClient client;
+    HttpDownloadPlan plan;
+    TEST_ASSERT_EQUAL_UINT32(BIG_FILE_SIZE, download(NULL, &client, &plan));
+    TEST_ASSERT_EQUAL_UINT32(BIG_FILE_SIZE, client.size);
+    TEST_ASSERT_EQUAL_MEMORY(file_data, client_data, BIG_FILE_SIZE);
+    // 每次最多一个缓冲区
+    TEST_ASSERT_EQUAL_INT(3, client.writes);
+}
+
+static void test_copy_partial(void)
+{
+    TestClient client;
+    HttpDownloadPlan plan;
+    // 跨越缓冲区边界的一段
+    TEST_ASSERT_EQUAL_UINT32(DOWNLOAD_BUF_SIZE + 2,
+                             download("bytes=28799-57600", &client, &plan));
+    TEST_ASSERT_EQUAL_INT(206, plan.code);
+    TEST_ASSERT_EQUAL_MEMORY(file_data + 28799, client_data, DOWNLOAD_BUF_SIZE + 2);
+    TEST_ASSERT_EQUAL_INT(2, client.writes);
+
+    TEST_ASSERT_EQUAL_UINT32(50, download("bytes=-50", &client, &plan));
+    TEST_ASSERT_EQUAL_MEMORY(file_data + BIG_FILE_SIZE - 50, client_data, 50);
+}
+
+static void test_copy_stops(void)
+{
+    HttpDownloadPlan plan;
+    http_download_plan(NULL, NULL, BIG_FILE_SIZE, LAST_WRITE, &plan);
+
+    // 客户端断开（写入不完整）
+    TestFile file = {file_data, BIG_FILE_SIZE, 0, 0};
+    TestClient client = {client_data, 0, 1000, 0};
+    TEST_ASSERT_EQUAL_UINT32(0, http_copy_body(test_read, &file, test_write, &client,
+                                               download_buf, sizeof(download_buf), plan.len));
+    TEST_ASSERT_EQUAL_INT(1, file.reads);
+
+    // 文件比预期的短（发送期间被改写）
+    TestFile short_file = {file_data, 100, 0, 0};
+    TestClient full_client = {client_data, 0, BIG_FILE_SIZE, 0};
+    TEST_ASSERT_EQUAL_UINT32(100, http_copy_body(test_read, &short_file, test_write, &full_client,
+                                                 download_buf, sizeof(download_buf), plan.len));
+}
+
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_closed_range);
+    RUN_TEST(test_open_ended_range);
+    RUN_TEST(test_suffix_range);
+    RUN_TEST(test_start_past_eof);
+    RUN_TEST(test_malformed);
+    RUN_TEST(test_date);
+    RUN_TEST(test_plan_full);
+    RUN_TEST(test_plan_partial);
+    RUN_TEST(test_plan_unsatisfiable);
+    RUN_TEST(test_plan_not_modified);
+    RUN_TEST(test_copy_full);
+    RUN_TEST(test_copy_partial);
+    RUN_TEST(test_copy_stops);
+    return UNITY_END();
+}
@@ -0,0 +1,59 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+
+# 将web配置页面用到的静态资源（css、js）压缩为gzip 生成C数组
+# 修改 AIO_Firmware_PIO/src/app/server/web/ 下的文件后运行本脚本
+# 用法: python gen_web_assets.py
+
+import gzip
+import hashlib
+import os
+
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                    '..', 'AIO_Firmware_PIO', 'src', 'app', 'server')
+WEB_DIR = os.path.join(ROOT, 'web')
+OUT_FILE = os.path.join(ROOT, 'web_assets_gz.c')
+
+# 文件名, 访问路径, Content-Type
+ASSETS = [
+    ('style.css', '/style.css', 'text/css'),
+    ('app.js', '/app.js', 'application/javascript'),
+]
+
+
+def to_c_array(name, data):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append('    ' + ', '.join('0x%02x' % b for b in data[i:i + 16]) + ',')
+    return 'static const uint8_t %s[%d] = {\n%s\n};\n' % (name, len(data), '\n'.join(lines))
+
+
+def main():
+    arrays = []
+    table = []
+    version = hashlib.sha1()
+    for file_name, path, content_type in ASSETS:
+        with open(os.path.join(WEB_DIR, file_name), 'rb') as f:
+            raw = f.read()
+        # mtime固定为0 保证内容不变时生成的数据（以及ETag）不变
+        data = gzip.compress(raw, compresslevel=9, mtime=0)
+        etag = hashlib.sha1(raw).hexdigest()[:16]
+        version.update(raw)
+
+        name = file_name.replace('.', '_') + '_gz'
+        arrays.append(to_c_array(name, data))
+        table.append('    {"%s", "%s", %s, sizeof(%s), "\\"%s\\""},'
+                     % (path, content_type, name, name, etag))
+        print('%s: %d -> %d bytes' % (file_name, len(raw), len(data)))
+
+    with open(OUT_FILE, 'w', encoding='utf-8', newline='\n') as f:
+        f.write('// 由 Script/gen_web_assets.py 生成 请勿手动修改\n\n')
+        f.write('#include "web_assets.h"\n\n')
+        f.write('\n'.join(arrays))
+        f.write('\nconst struct WebAsset web_assets[] = {\n%s\n};\n\n' % '\n'.join(table))
+        f.write('const int web_assets_num = sizeof(web_assets) / sizeof(web_assets[0]);\n\n')
+        f.write('const char web_assets_version[] = "%s";\n' % version.hexdigest()[:8])
+
+
+if __name__ == '__main__':
+    main()